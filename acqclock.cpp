@@ -0,0 +1,20 @@
+#include "acqclock.h"
+#include <QDateTime>
+#include <chrono>
+
+namespace AcqClock {
+
+qint64 nowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+qint64 toEpochMs(qint64 timestampUs)
+{
+    // 首次调用时记录单调时钟与墙上时钟的偏移，之后只做加法
+    static const qint64 offsetUs = QDateTime::currentMSecsSinceEpoch() * 1000 - nowUs();
+    return (timestampUs + offsetUs) / 1000;
+}
+
+} // namespace AcqClock
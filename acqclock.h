@@ -0,0 +1,16 @@
+#ifndef ACQCLOCK_H
+#define ACQCLOCK_H
+
+#include <QtGlobal>
+
+// 采集时钟：统一使用系统单调时钟（微秒），不受系统时间调整影响。
+// steady_clock 在 Linux 上即 CLOCK_MONOTONIC、在 Windows 上即 QPC，进程间可比较。
+namespace AcqClock {
+    // 当前单调时间（微秒）
+    qint64 nowUs();
+
+    // 单调时间 -> 墙上时间（毫秒，用于 QDateTimeAxis 显示）
+    qint64 toEpochMs(qint64 timestampUs);
+}
+
+#endif // ACQCLOCK_H
@@ -0,0 +1,67 @@
+#ifndef ARCHIVEFORMAT_H
+#define ARCHIVEFORMAT_H
+
+#include <QtGlobal>
+
+// 臂数据列式归档格式（小端）：长时间采集的关节角按时间分块、每个关节一列存放。
+// 文件 = FileHeader + 若干块 + 块索引（IndexEntry 数组）+ Footer。
+// 每块只含一个臂数据流（armId 同 SessionFormat::ArmId，可带设备序号）的连续 sampleCount 个样本：
+//   ChunkHeader，之后 payload 依次为时间戳列和各通道列，列的结束位置记录在 columnEnd 中，
+//   可以只解码需要的列。
+//   时间戳列：第一个样本的时间戳在块头中，之后为二阶差分（差分的差分）的 zigzag varint。
+//   通道列：数值按块头的 resolution 量化为整数（round(value / resolution)），
+//          第一个为量化值本身，之后为相邻差分，均为 zigzag varint。
+// 索引只在正常关闭时写入；文件末尾没有有效 Footer 时读取端从头顺序扫描各块（采集中断的情况）。
+namespace ArchiveFormat {
+
+constexpr char MAGIC[8] = {'L', 'T', 'A', 'A', 'R', 'C', 'H', '1'};
+constexpr char FOOTER_MAGIC[8] = {'L', 'T', 'A', 'I', 'N', 'D', 'E', 'X'};
+constexpr quint32 CHUNK_MAGIC = 0x43415444; // "DTAC"
+constexpr quint32 VERSION = 1;
+constexpr int MAX_CHANNELS = 15;
+
+struct FileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;      // sizeof(FileHeader)
+    qint64 startEpochMs;     // 归档开始的墙上时间
+    qint64 startTimestampUs; // 归档开始的 AcqClock 时间
+};
+static_assert(sizeof(FileHeader) == 32, "FileHeader layout");
+
+struct ChunkHeader {
+    quint32 magic;           // CHUNK_MAGIC
+    quint16 armId;
+    quint8 channelCount;
+    quint8 reserved;
+    quint32 sampleCount;
+    quint32 payloadSize;     // 块头之后的字节数
+    qint64 firstTimestampUs;
+    qint64 lastTimestampUs;
+    double resolution;       // 量化步长（如 CAN 关节角为 0.1°）
+    quint32 columnEnd[MAX_CHANNELS + 1]; // [0] 时间戳列，[1..channelCount] 各通道；payload 内的结束偏移
+};
+static_assert(sizeof(ChunkHeader) == 104, "ChunkHeader layout");
+
+struct IndexEntry {
+    qint64 offset;           // 块头在文件中的偏移
+    qint64 firstTimestampUs;
+    qint64 lastTimestampUs;
+    quint32 sampleCount;
+    quint16 armId;
+    quint8 channelCount;
+    quint8 reserved;
+};
+static_assert(sizeof(IndexEntry) == 32, "IndexEntry layout");
+
+struct Footer {
+    qint64 indexOffset;
+    quint32 chunkCount;
+    quint32 reserved;
+    char magic[8];           // FOOTER_MAGIC
+};
+static_assert(sizeof(Footer) == 24, "Footer layout");
+
+} // namespace ArchiveFormat
+
+#endif // ARCHIVEFORMAT_H
@@ -0,0 +1,240 @@
+#include "archivereader.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+inline bool getVarint(const uchar *&p, const uchar *end, quint64 &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uchar byte = *p++;
+        value |= static_cast<quint64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline qint64 unzigzag(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+} // namespace
+
+ArchiveReader::ArchiveReader()
+{
+}
+
+ArchiveReader::~ArchiveReader()
+{
+    close();
+}
+
+bool ArchiveReader::open(const QString &fileName)
+{
+    close();
+    m_errorString.clear();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = QString("无法打开归档文件: %1").arg(m_file.errorString());
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(ArchiveFormat::FileHeader))) {
+        m_errorString = "归档文件格式错误: 文件过短";
+        close();
+        return false;
+    }
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        m_errorString = QString("无法映射归档文件: %1").arg(m_file.errorString());
+        close();
+        return false;
+    }
+
+    ArchiveFormat::FileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (std::memcmp(header.magic, ArchiveFormat::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != ArchiveFormat::VERSION ||
+        header.headerSize < sizeof(ArchiveFormat::FileHeader) || static_cast<qint64>(header.headerSize) > m_size) {
+        m_errorString = "归档文件格式错误: 文件头无效或版本不支持";
+        close();
+        return false;
+    }
+    m_startTimestampUs = header.startTimestampUs;
+    m_startEpochMs = header.startEpochMs;
+
+    m_recovered = !readIndex();
+    if (m_recovered) {
+        scanChunks();
+    }
+
+    m_positionInArm.resize(m_index.size());
+    for (int i = 0; i < m_index.size(); ++i) {
+        QVector<int> &chunks = m_armChunks[m_index[i].armId];
+        m_positionInArm[i] = chunks.size();
+        chunks.append(i);
+    }
+    return true;
+}
+
+void ArchiveReader::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+    m_recovered = false;
+    m_index.clear();
+    m_armChunks.clear();
+    m_positionInArm.clear();
+}
+
+bool ArchiveReader::readIndex()
+{
+    const qint64 footerOffset = m_size - static_cast<qint64>(sizeof(ArchiveFormat::Footer));
+    if (footerOffset < static_cast<qint64>(sizeof(ArchiveFormat::FileHeader))) return false;
+
+    ArchiveFormat::Footer footer;
+    std::memcpy(&footer, m_data + footerOffset, sizeof(footer));
+    if (std::memcmp(footer.magic, ArchiveFormat::FOOTER_MAGIC, sizeof(footer.magic)) != 0 ||
+        footer.indexOffset < static_cast<qint64>(sizeof(ArchiveFormat::FileHeader)) ||
+        footer.indexOffset + static_cast<qint64>(footer.chunkCount) * static_cast<qint64>(sizeof(ArchiveFormat::IndexEntry))
+            != footerOffset) {
+        return false;
+    }
+
+    m_index.resize(static_cast<int>(footer.chunkCount));
+    std::memcpy(m_index.data(), m_data + footer.indexOffset, footer.chunkCount * sizeof(ArchiveFormat::IndexEntry));
+    return true;
+}
+
+void ArchiveReader::scanChunks()
+{
+    qint64 offset;
+    {
+        ArchiveFormat::FileHeader header;
+        std::memcpy(&header, m_data, sizeof(header));
+        offset = header.headerSize;
+    }
+
+    // 最后一块可能只写了一半：遇到不完整或无效的块头就停止
+    while (offset + static_cast<qint64>(sizeof(ArchiveFormat::ChunkHeader)) <= m_size) {
+        ArchiveFormat::ChunkHeader header;
+        std::memcpy(&header, m_data + offset, sizeof(header));
+        const qint64 end = offset + static_cast<qint64>(sizeof(header)) + header.payloadSize;
+        if (header.magic != ArchiveFormat::CHUNK_MAGIC || end > m_size) break;
+
+        ArchiveFormat::IndexEntry entry;
+        entry.offset = offset;
+        entry.firstTimestampUs = header.firstTimestampUs;
+        entry.lastTimestampUs = header.lastTimestampUs;
+        entry.sampleCount = header.sampleCount;
+        entry.armId = header.armId;
+        entry.channelCount = header.channelCount;
+        entry.reserved = 0;
+        m_index.append(entry);
+        offset = end;
+    }
+}
+
+QVector<quint16> ArchiveReader::armIds() const
+{
+    QVector<quint16> ids;
+    for (auto it = m_armChunks.constBegin(); it != m_armChunks.constEnd(); ++it) {
+        ids.append(it.key());
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+int ArchiveReader::findChunk(quint16 armId, qint64 timestampUs) const
+{
+    const auto it = m_armChunks.constFind(armId);
+    if (it == m_armChunks.constEnd()) return -1;
+
+    const QVector<int> &chunks = it.value();
+    const auto found = std::lower_bound(chunks.constBegin(), chunks.constEnd(), timestampUs,
+                                        [this](int index, qint64 t) { return m_index[index].lastTimestampUs < t; });
+    return found == chunks.constEnd() ? -1 : *found;
+}
+
+int ArchiveReader::nextChunk(int index) const
+{
+    if (index < 0 || index >= m_index.size()) return -1;
+    const QVector<int> &chunks = m_armChunks[m_index[index].armId];
+    const int next = m_positionInArm[index] + 1;
+    return next < chunks.size() ? chunks[next] : -1;
+}
+
+bool ArchiveReader::chunkHeader(int index, ArchiveFormat::ChunkHeader &header) const
+{
+    if (!m_data || index < 0 || index >= m_index.size()) return false;
+    const qint64 offset = m_index[index].offset;
+    if (offset < 0 || offset + static_cast<qint64>(sizeof(header)) > m_size) return false;
+
+    std::memcpy(&header, m_data + offset, sizeof(header));
+    if (header.magic != ArchiveFormat::CHUNK_MAGIC || header.channelCount > ArchiveFormat::MAX_CHANNELS ||
+        header.sampleCount == 0 || !(header.resolution > 0.0) ||
+        offset + static_cast<qint64>(sizeof(header)) + header.payloadSize > m_size) {
+        return false;
+    }
+    // 每个值至少 1 个字节（时间戳列少第一个）
+    quint32 previous = 0;
+    for (int column = 0; column <= header.channelCount; ++column) {
+        const quint32 minimum = column == 0 ? header.sampleCount - 1 : header.sampleCount;
+        if (header.columnEnd[column] < previous || header.columnEnd[column] > header.payloadSize ||
+            header.columnEnd[column] - previous < minimum) {
+            return false;
+        }
+        previous = header.columnEnd[column];
+    }
+    return true;
+}
+
+bool ArchiveReader::readTimestamps(int index, QVector<qint64> &out) const
+{
+    ArchiveFormat::ChunkHeader header;
+    if (!chunkHeader(index, header)) return false;
+
+    const uchar *p = m_data + m_index[index].offset + sizeof(header);
+    const uchar *const end = p + header.columnEnd[0];
+    out.resize(static_cast<int>(header.sampleCount));
+    qint64 timestamp = header.firstTimestampUs;
+    qint64 delta = 0;
+    out[0] = timestamp;
+    for (int i = 1; i < out.size(); ++i) {
+        quint64 value;
+        if (!getVarint(p, end, value)) return false;
+        delta += unzigzag(value);
+        timestamp += delta;
+        out[i] = timestamp;
+    }
+    return true;
+}
+
+bool ArchiveReader::readChannel(int index, int channel, QVector<float> &out) const
+{
+    ArchiveFormat::ChunkHeader header;
+    if (!chunkHeader(index, header) || channel < 0 || channel >= header.channelCount) return false;
+
+    const uchar *const payload = m_data + m_index[index].offset + sizeof(header);
+    const uchar *p = payload + header.columnEnd[channel];
+    const uchar *const end = payload + header.columnEnd[channel + 1];
+    const double scale = 1.0 / header.resolution;
+    out.resize(static_cast<int>(header.sampleCount));
+    qint64 quantized = 0;
+    for (int i = 0; i < out.size(); ++i) {
+        quint64 value;
+        if (!getVarint(p, end, value)) return false;
+        quantized += unzigzag(value);
+        out[i] = static_cast<float>(quantized / scale);
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef ARCHIVEREADER_H
+#define ARCHIVEREADER_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "archiveformat.h"
+
+// 列式归档读取（格式见 archiveformat.h）：文件通过 QFile::map 映射，按块索引随机访问，
+// 每次只解码需要的块和列。没有索引（采集中断）时打开时顺序扫描块头重建索引。
+class ArchiveReader
+{
+public:
+    ArchiveReader();
+    ~ArchiveReader();
+
+    // 失败时返回 false，原因见 errorString()
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    QString errorString() const { return m_errorString; }
+
+    qint64 startTimestampUs() const { return m_startTimestampUs; }
+    qint64 startEpochMs() const { return m_startEpochMs; }
+    // 文件尾没有索引，块列表由扫描得到
+    bool recovered() const { return m_recovered; }
+
+    // 块按写入顺序排列；同一个 armId 的块时间递增
+    int chunkCount() const { return m_index.size(); }
+    const ArchiveFormat::IndexEntry &chunk(int index) const { return m_index[index]; }
+    QVector<quint16> armIds() const;
+    // 某个臂数据流中最后时间戳 >= timestampUs 的第一个块（块序号），没有时返回 -1
+    int findChunk(quint16 armId, qint64 timestampUs) const;
+    // 同一个臂数据流中的下一个块，没有时返回 -1
+    int nextChunk(int index) const;
+
+    // 解码一个块的时间戳列或某个通道列，out 会被覆盖；数据损坏时返回 false
+    bool readTimestamps(int index, QVector<qint64> &out) const;
+    bool readChannel(int index, int channel, QVector<float> &out) const;
+
+private:
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    QString m_errorString;
+    qint64 m_startTimestampUs = 0;
+    qint64 m_startEpochMs = 0;
+    bool m_recovered = false;
+
+    QVector<ArchiveFormat::IndexEntry> m_index;
+    QHash<quint16, QVector<int>> m_armChunks;   // armId -> 块序号（时间递增）
+    QVector<int> m_positionInArm;               // 块序号 -> 在 m_armChunks 中的位置
+
+    bool readIndex();
+    void scanChunks();
+    bool chunkHeader(int index, ArchiveFormat::ChunkHeader &header) const;
+};
+
+#endif // ARCHIVEREADER_H
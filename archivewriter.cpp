@@ -0,0 +1,218 @@
+#include "archivewriter.h"
+#include "acqclock.h"
+#include "sessionformat.h"
+#include "trace.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 有符号数映射为无符号，使小的负数也只占 1 个字节
+inline quint64 zigzag(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+inline char *putVarint(char *out, quint64 value)
+{
+    while (value >= 0x80) {
+        *out++ = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+// 单个 varint 最多 10 字节
+constexpr int MAX_VARINT_BYTES = 10;
+
+} // namespace
+
+ArchiveWriter::ArchiveWriter()
+{
+}
+
+ArchiveWriter::~ArchiveWriter()
+{
+    close();
+}
+
+bool ArchiveWriter::open(const QString &fileName, double resolution, int chunkSamples)
+{
+    close();
+    m_errorString.clear();
+    if (!(resolution > 0.0) || chunkSamples < 1) {
+        m_errorString = QString("归档参数无效: 分辨率 %1, 每块 %2 个样本").arg(resolution).arg(chunkSamples);
+        return false;
+    }
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorString = QString("无法创建归档文件: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    m_resolution = resolution;
+    m_scale = 1.0 / resolution;
+    m_chunkSamples = chunkSamples;
+    m_streams.clear();
+    m_lastStream = -1;
+    m_index.clear();
+    m_samples = 0;
+    m_bytesWritten = 0;
+    m_rawBytes = 0;
+    // 最坏情况下每个值占满一个 varint，预先分配后编码时不再扩容
+    m_chunk.resize(static_cast<int>(sizeof(ArchiveFormat::ChunkHeader))
+                   + (ArchiveFormat::MAX_CHANNELS + 1) * chunkSamples * MAX_VARINT_BYTES);
+
+    ArchiveFormat::FileHeader header;
+    std::memcpy(header.magic, ArchiveFormat::MAGIC, sizeof(header.magic));
+    header.version = ArchiveFormat::VERSION;
+    header.headerSize = sizeof(ArchiveFormat::FileHeader);
+    header.startTimestampUs = AcqClock::nowUs();
+    header.startEpochMs = AcqClock::toEpochMs(header.startTimestampUs);
+    if (!write(reinterpret_cast<const char *>(&header), sizeof(header))) {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool ArchiveWriter::close()
+{
+    if (!m_file.isOpen()) return true;
+
+    bool ok = true;
+    for (Stream &s : m_streams) {
+        ok = flush(s) && ok;
+    }
+
+    ArchiveFormat::Footer footer;
+    footer.indexOffset = m_file.pos();
+    footer.chunkCount = static_cast<quint32>(m_index.size());
+    footer.reserved = 0;
+    std::memcpy(footer.magic, ArchiveFormat::FOOTER_MAGIC, sizeof(footer.magic));
+    ok = ok && write(reinterpret_cast<const char *>(m_index.constData()),
+                     m_index.size() * static_cast<qint64>(sizeof(ArchiveFormat::IndexEntry)));
+    ok = ok && write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+    m_file.close();
+    m_streams.clear();
+    m_index.clear();
+    return ok;
+}
+
+bool ArchiveWriter::append(qint64 timestampUs, quint16 armId, const float *values, int count)
+{
+    if (!m_file.isOpen()) return false;
+    count = qBound(0, count, ArchiveFormat::MAX_CHANNELS);
+
+    // 通常只有一两个流交替到达，先查上一次的流
+    int index = m_lastStream;
+    if (index < 0 || m_streams[index].armId != armId) {
+        index = -1;
+        for (int i = 0; i < m_streams.size(); ++i) {
+            if (m_streams[i].armId == armId) {
+                index = i;
+                break;
+            }
+        }
+        if (index < 0) {
+            Stream s;
+            s.armId = armId;
+            s.channelCount = count;
+            s.timestamps.resize(m_chunkSamples);
+            s.values.resize(ArchiveFormat::MAX_CHANNELS * m_chunkSamples);
+            m_streams.append(s);
+            index = m_streams.size() - 1;
+        }
+        m_lastStream = index;
+    }
+
+    Stream &s = m_streams[index];
+    bool ok = true;
+    if (s.channelCount != count) {
+        // 同一个流的通道数变化：先结束当前块
+        ok = flush(s);
+        s.channelCount = count;
+    }
+
+    const int i = s.count;
+    s.timestamps[i] = timestampUs;
+    for (int ch = 0; ch < count; ++ch) {
+        const double scaled = values[ch] * m_scale;
+        s.values[ch * m_chunkSamples + i] =
+            std::isfinite(scaled) ? static_cast<qint32>(std::llround(qBound(-2.0e9, scaled, 2.0e9))) : 0;
+    }
+    ++s.count;
+    ++m_samples;
+    m_rawBytes += SessionFormat::recordSize(static_cast<quint32>(count * sizeof(float)));
+
+    if (s.count == m_chunkSamples) {
+        ok = flush(s) && ok;
+    }
+    return ok;
+}
+
+bool ArchiveWriter::flush(Stream &stream)
+{
+    if (stream.count == 0) return true;
+    TRACE_SCOPE_ARG(ArchiveEncode, stream.count);
+
+    ArchiveFormat::ChunkHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = ArchiveFormat::CHUNK_MAGIC;
+    header.armId = stream.armId;
+    header.channelCount = static_cast<quint8>(stream.channelCount);
+    header.sampleCount = static_cast<quint32>(stream.count);
+    header.firstTimestampUs = stream.timestamps[0];
+    header.lastTimestampUs = stream.timestamps[stream.count - 1];
+    header.resolution = m_resolution;
+
+    char *const payload = m_chunk.data() + sizeof(header);
+    char *out = payload;
+
+    // 时间戳：采样周期基本恒定，二阶差分通常只有抖动，1 个字节
+    qint64 previousDelta = 0;
+    for (int i = 1; i < stream.count; ++i) {
+        const qint64 delta = stream.timestamps[i] - stream.timestamps[i - 1];
+        out = putVarint(out, zigzag(delta - previousDelta));
+        previousDelta = delta;
+    }
+    header.columnEnd[0] = static_cast<quint32>(out - payload);
+
+    for (int ch = 0; ch < stream.channelCount; ++ch) {
+        const qint32 *column = stream.values.constData() + ch * m_chunkSamples;
+        qint64 previous = 0;
+        for (int i = 0; i < stream.count; ++i) {
+            out = putVarint(out, zigzag(static_cast<qint64>(column[i]) - previous));
+            previous = column[i];
+        }
+        header.columnEnd[ch + 1] = static_cast<quint32>(out - payload);
+    }
+    header.payloadSize = static_cast<quint32>(out - payload);
+    std::memcpy(m_chunk.data(), &header, sizeof(header));
+
+    ArchiveFormat::IndexEntry entry;
+    entry.offset = m_file.pos();
+    entry.firstTimestampUs = header.firstTimestampUs;
+    entry.lastTimestampUs = header.lastTimestampUs;
+    entry.sampleCount = header.sampleCount;
+    entry.armId = header.armId;
+    entry.channelCount = header.channelCount;
+    entry.reserved = 0;
+
+    stream.count = 0;
+    if (!write(m_chunk.constData(), static_cast<qint64>(sizeof(header)) + header.payloadSize)) return false;
+    m_index.append(entry);
+    return true;
+}
+
+bool ArchiveWriter::write(const char *data, qint64 size)
+{
+    if (m_file.write(data, size) != size) {
+        m_errorString = QString("写入归档文件失败: %1").arg(m_file.errorString());
+        return false;
+    }
+    m_bytesWritten += size;
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef ARCHIVEWRITER_H
+#define ARCHIVEWRITER_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "archiveformat.h"
+
+// 列式归档写入（格式见 archiveformat.h）：每个臂数据流在内存中按列积攒一块样本，
+// 攒满 chunkSamples 个（或 close() 时）一次性编码写出。append() 只做量化和拷贝，
+// 编码摊到每块一次，可以直接在采集线程中调用；不加锁，只能由一个线程使用。
+class ArchiveWriter
+{
+public:
+    static constexpr int DEFAULT_CHUNK_SAMPLES = 1024;
+
+    ArchiveWriter();
+    ~ArchiveWriter();
+
+    // resolution：量化步长（与数据源精度一致，如 CAN 为 0.1°）；失败时返回 false，原因见 errorString()
+    bool open(const QString &fileName, double resolution, int chunkSamples = DEFAULT_CHUNK_SAMPLES);
+    // 写出未满的块、索引和文件尾
+    bool close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_errorString; }
+
+    // 非有限值（NaN/Inf）按 0 存储；count 超过 MAX_CHANNELS 时只保存前 MAX_CHANNELS 个
+    bool append(qint64 timestampUs, quint16 armId, const float *values, int count);
+
+    quint64 samplesWritten() const { return m_samples; }
+    quint64 bytesWritten() const { return m_bytesWritten; }
+    // 同样的样本按 SessionFormat 臂数据记录存放所需的字节数，用于比较压缩率
+    quint64 rawBytes() const { return m_rawBytes; }
+
+private:
+    // 一个臂数据流当前正在积攒的块
+    struct Stream {
+        quint16 armId = 0;
+        int channelCount = 0;
+        int count = 0;
+        QVector<qint64> timestamps;
+        QVector<qint32> values;   // [channel * chunkSamples + i]
+    };
+
+    QFile m_file;
+    QString m_errorString;
+    double m_resolution = 0.1;
+    double m_scale = 10.0;        // 1 / resolution
+    int m_chunkSamples = DEFAULT_CHUNK_SAMPLES;
+    QVector<Stream> m_streams;
+    int m_lastStream = -1;
+    QByteArray m_chunk;
+    QVector<ArchiveFormat::IndexEntry> m_index;
+
+    quint64 m_samples = 0;
+    quint64 m_bytesWritten = 0;
+    quint64 m_rawBytes = 0;
+
+    bool flush(Stream &stream);
+    bool write(const char *data, qint64 size);
+};
+
+#endif // ARCHIVEWRITER_H
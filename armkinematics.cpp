@@ -0,0 +1,402 @@
+#include "armkinematics.h"
+#include "simdvec.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG_TO_RAD = PI / 180.0;
+
+// ===== 配置阶段：双精度 3x4 仿射变换 =====
+struct Affine {
+    double m[3][4];
+
+    static Affine identity()
+    {
+        Affine a;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c) a.m[r][c] = r == c ? 1.0 : 0.0;
+        }
+        return a;
+    }
+
+    Affine operator*(const Affine &b) const
+    {
+        Affine out;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                out.m[r][c] = m[r][0] * b.m[0][c] + m[r][1] * b.m[1][c] + m[r][2] * b.m[2][c];
+            }
+            out.m[r][3] += m[r][3];
+        }
+        return out;
+    }
+
+    Affine transposedRotation() const
+    {
+        Affine t = identity();
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) t.m[r][c] = m[c][r];
+        }
+        return t;
+    }
+};
+
+Affine translation(double x, double y, double z)
+{
+    Affine a = Affine::identity();
+    a.m[0][3] = x;
+    a.m[1][3] = y;
+    a.m[2][3] = z;
+    return a;
+}
+
+Affine rotX(double deg)
+{
+    const double c = std::cos(deg * DEG_TO_RAD), s = std::sin(deg * DEG_TO_RAD);
+    Affine a = Affine::identity();
+    a.m[1][1] = c; a.m[1][2] = -s;
+    a.m[2][1] = s; a.m[2][2] = c;
+    return a;
+}
+
+Affine rotY(double deg)
+{
+    const double c = std::cos(deg * DEG_TO_RAD), s = std::sin(deg * DEG_TO_RAD);
+    Affine a = Affine::identity();
+    a.m[0][0] = c; a.m[0][2] = s;
+    a.m[2][0] = -s; a.m[2][2] = c;
+    return a;
+}
+
+Affine rotZ(double deg)
+{
+    const double c = std::cos(deg * DEG_TO_RAD), s = std::sin(deg * DEG_TO_RAD);
+    Affine a = Affine::identity();
+    a.m[0][0] = c; a.m[0][1] = -s;
+    a.m[1][0] = s; a.m[1][1] = c;
+    return a;
+}
+
+Affine fromFrame(const ArmKinematics::Frame &frame)
+{
+    return translation(frame.xyz[0], frame.xyz[1], frame.xyz[2])
+         * rotZ(frame.rpy[2]) * rotY(frame.rpy[1]) * rotX(frame.rpy[0]);
+}
+
+// 把 z 轴转到 axis 的旋转（第三列为 axis），绕 axis 转 θ = A · Rz(θ) · Aᵀ
+bool zToAxis(const double axis[3], Affine &out)
+{
+    const double norm = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    if (norm < 1e-9) return false;
+    const double u[3] = {axis[0] / norm, axis[1] / norm, axis[2] / norm};
+
+    // 任取一条与 u 不平行的轴做正交化
+    double x[3] = {1.0, 0.0, 0.0};
+    if (std::fabs(u[0]) > 0.9) {
+        x[0] = 0.0;
+        x[1] = 1.0;
+    }
+    const double dot = x[0] * u[0] + x[1] * u[1] + x[2] * u[2];
+    for (int i = 0; i < 3; ++i) x[i] -= dot * u[i];
+    const double xNorm = std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+    for (double &v : x) v /= xNorm;
+    const double y[3] = {u[1] * x[2] - u[2] * x[1], u[2] * x[0] - u[0] * x[2], u[0] * x[1] - u[1] * x[0]};
+
+    out = Affine::identity();
+    for (int r = 0; r < 3; ++r) {
+        out.m[r][0] = x[r];
+        out.m[r][1] = y[r];
+        out.m[r][2] = u[r];
+    }
+    return true;
+}
+
+// ===== 运行阶段：4 通道浮点向量（见 simdvec.h） =====
+using namespace SimdVec;
+
+#ifdef SIMDVEC_SSE2
+// sin/cos 同时计算（Cephes 单精度多项式，|x| < 1e4 时误差约 1e-7）：
+// 按 π/2 取整分象限，余数在 [-π/4, π/4] 内用多项式，再按象限交换/取反
+inline void sincos(Vec x, Vec &sinOut, Vec &cosOut)
+{
+    const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x.v, _mm_set1_ps(0.63661977236758134f)));
+    const __m128 j = _mm_cvtepi32_ps(quadrant);
+    __m128 y = _mm_sub_ps(x.v, _mm_mul_ps(j, _mm_set1_ps(1.5703125f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(j, _mm_set1_ps(4.837512969970703125e-4f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(j, _mm_set1_ps(7.54978995489188216e-8f)));
+    const __m128 z = _mm_mul_ps(y, y);
+
+    __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(-1.6666654611e-1f));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), y), y);
+
+    __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(-1.388731625493765e-3f));
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(4.166664568298827e-2f));
+    c = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(c, z), z), _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(z, _mm_set1_ps(0.5f))));
+
+    // 奇数象限 sin/cos 互换；sin 在第 2、3 象限取反，cos 在第 1、2 象限取反
+    const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+    const __m128 cosSign = _mm_castsi128_ps(
+        _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+    const __m128 sinValue = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+    const __m128 cosValue = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+    sinOut.v = _mm_xor_ps(sinValue, sinSign);
+    cosOut.v = _mm_xor_ps(cosValue, cosSign);
+}
+#else
+inline void sincos(Vec x, Vec &sinOut, Vec &cosOut)
+{
+    for (int i = 0; i < 4; ++i) {
+        sinOut.v[i] = std::sin(x.v[i]);
+        cosOut.v[i] = std::cos(x.v[i]);
+    }
+}
+#endif
+
+bool readVector3(const QJsonObject &object, const char *key, double out[3], QString *error)
+{
+    if (!object.contains(key)) return true;
+    const QJsonArray array = object.value(key).toArray();
+    if (array.size() != 3) {
+        if (error) *error = QString("\"%1\" 应为 3 个数").arg(key);
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) out[i] = array[i].toDouble();
+    return true;
+}
+
+bool readFrame(const QJsonObject &object, ArmKinematics::Frame &frame, QString *error)
+{
+    return readVector3(object, "xyz", frame.xyz, error) && readVector3(object, "rpy", frame.rpy, error);
+}
+
+bool readConvention(const QJsonValue &value, ArmKinematics::Convention &convention, QString *error)
+{
+    if (value.isUndefined()) return true;
+    const QString name = value.toString().toLower();
+    if (name == "dh") {
+        convention = ArmKinematics::StandardDH;
+    } else if (name == "mdh") {
+        convention = ArmKinematics::ModifiedDH;
+    } else if (name == "urdf") {
+        convention = ArmKinematics::Urdf;
+    } else {
+        if (error) *error = QString("未知的参数写法: %1（dh / mdh / urdf）").arg(value.toString());
+        return false;
+    }
+    return true;
+}
+
+bool readArm(const QJsonObject &object, ArmKinematics::Config &config, QString *error)
+{
+    config = ArmKinematics::Config();
+    ArmKinematics::Convention armConvention = ArmKinematics::StandardDH;
+    if (!readConvention(object.value("convention"), armConvention, error)) return false;
+    if (!readFrame(object.value("base").toObject(), config.base, error)) return false;
+    if (!readFrame(object.value("tool").toObject(), config.tool, error)) return false;
+
+    const QJsonArray joints = object.value("joints").toArray();
+    if (joints.size() != ArmKinematics::JOINT_COUNT) {
+        if (error) *error = QString("需要 %1 个关节参数，实际 %2 个").arg(ArmKinematics::JOINT_COUNT).arg(joints.size());
+        return false;
+    }
+    for (int i = 0; i < ArmKinematics::JOINT_COUNT; ++i) {
+        const QJsonObject item = joints[i].toObject();
+        ArmKinematics::Joint &joint = config.joints[i];
+        joint.convention = armConvention;
+        if (!readConvention(item.value("convention"), joint.convention, error)) return false;
+        joint.a = item.value("a").toDouble();
+        joint.alpha = item.value("alpha").toDouble();
+        joint.d = item.value("d").toDouble();
+        joint.offset = item.value("offset").toDouble();
+        joint.sign = item.value("sign").toDouble(1.0);
+        QString jointError;
+        if (!readFrame(item, joint.origin, &jointError) || !readVector3(item, "axis", joint.axis, &jointError)) {
+            if (error) *error = QString("关节 %1: %2").arg(i + 1).arg(jointError);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+ArmKinematics::ArmKinematics()
+{
+    std::memset(m_chain, 0, sizeof(m_chain));
+    std::memset(m_scale, 0, sizeof(m_scale));
+}
+
+bool ArmKinematics::setConfig(const Config &config, QString *error)
+{
+    // 每个关节拆成 pre · Rz(q) · post，相邻关节的 post 与下一个 pre 合并成一个固定变换
+    Affine pre[JOINT_COUNT];
+    Affine post[JOINT_COUNT];
+    for (int i = 0; i < JOINT_COUNT; ++i) {
+        const Joint &joint = config.joints[i];
+        switch (joint.convention) {
+        case StandardDH:
+            pre[i] = rotZ(joint.offset);
+            post[i] = translation(0.0, 0.0, joint.d) * translation(joint.a, 0.0, 0.0) * rotX(joint.alpha);
+            break;
+        case ModifiedDH:
+            pre[i] = rotX(joint.alpha) * translation(joint.a, 0.0, 0.0) * rotZ(joint.offset);
+            post[i] = translation(0.0, 0.0, joint.d);
+            break;
+        case Urdf: {
+            Affine axis;
+            if (!zToAxis(joint.axis, axis)) {
+                if (error) *error = QString("关节 %1 的转轴为零向量").arg(i + 1);
+                return false;
+            }
+            pre[i] = fromFrame(joint.origin) * axis * rotZ(joint.offset);
+            post[i] = axis.transposedRotation();
+            break;
+        }
+        }
+    }
+
+    Affine fixed[JOINT_COUNT + 1];
+    fixed[0] = fromFrame(config.base) * pre[0];
+    for (int i = 1; i < JOINT_COUNT; ++i) {
+        fixed[i] = post[i - 1] * pre[i];
+    }
+    fixed[JOINT_COUNT] = post[JOINT_COUNT - 1] * fromFrame(config.tool);
+
+    for (int t = 0; t <= JOINT_COUNT; ++t) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 3; ++r) {
+                const float value = static_cast<float>(fixed[t].m[r][c]);
+                for (float &lane : m_chain[t].lanes[c * 3 + r]) lane = value;
+            }
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        m_scale[i] = i < JOINT_COUNT ? static_cast<float>(config.joints[i].sign * DEG_TO_RAD) : 0.0f;
+    }
+    m_valid = true;
+    return true;
+}
+
+void ArmKinematics::compute(const float *jointsDeg, Pose &pose) const
+{
+    // 7 个关节的 sin/cos 分两组向量计算
+    alignas(16) float angles[8];
+    std::memcpy(angles, jointsDeg, JOINT_COUNT * sizeof(float));
+    angles[7] = 0.0f;
+    alignas(16) float sines[8];
+    alignas(16) float cosines[8];
+    for (int v = 0; v < 2; ++v) {
+        Vec s, c;
+        sincos(load(angles + 4 * v) * load(m_scale + 4 * v), s, c);
+        store(sines + 4 * v, s);
+        store(cosines + 4 * v, c);
+    }
+
+    // 当前变换按列存放：col0..col2 为旋转，col3 为平移（每列第 4 个通道不用）
+    const FixedTransform &first = m_chain[0];
+    alignas(16) float columns[4][4];
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 3; ++r) columns[c][r] = first.lanes[c * 3 + r][0];
+        columns[c][3] = 0.0f;
+    }
+    Vec col0 = load(columns[0]), col1 = load(columns[1]), col2 = load(columns[2]), col3 = load(columns[3]);
+
+    for (int i = 0; i < JOINT_COUNT; ++i) {
+        // M · Rz(q)：只影响前两列
+        const Vec cq = splat(cosines[i]);
+        const Vec sq = splat(sines[i]);
+        const Vec r0 = col0 * cq + col1 * sq;
+        const Vec r1 = col1 * cq - col0 * sq;
+
+        // · F：结果第 j 列 = r0·F0j + r1·F1j + col2·F2j（平移列再加 col3）
+        const float (*f)[4] = m_chain[i + 1].lanes;
+        const Vec n0 = r0 * load(f[0]) + r1 * load(f[1]) + col2 * load(f[2]);
+        const Vec n1 = r0 * load(f[3]) + r1 * load(f[4]) + col2 * load(f[5]);
+        const Vec n2 = r0 * load(f[6]) + r1 * load(f[7]) + col2 * load(f[8]);
+        col3 = r0 * load(f[9]) + r1 * load(f[10]) + col2 * load(f[11]) + col3;
+        col0 = n0;
+        col1 = n1;
+        col2 = n2;
+    }
+    store(columns[0], col0);
+    store(columns[1], col1);
+    store(columns[2], col2);
+    store(columns[3], col3);
+
+    // R(r, c) = columns[c][r]
+    const float r00 = columns[0][0], r01 = columns[1][0], r02 = columns[2][0];
+    const float r10 = columns[0][1], r11 = columns[1][1], r12 = columns[2][1];
+    const float r20 = columns[0][2], r21 = columns[1][2], r22 = columns[2][2];
+    pose.position[0] = columns[3][0];
+    pose.position[1] = columns[3][1];
+    pose.position[2] = columns[3][2];
+
+    // 旋转矩阵 -> 四元数（按最大的对角量选分支，避免除以小数）
+    float *q = pose.quaternion;
+    const float trace = r00 + r11 + r22;
+    if (trace > 0.0f) {
+        const float s = std::sqrt(trace + 1.0f) * 2.0f;
+        q[0] = 0.25f * s;
+        q[1] = (r21 - r12) / s;
+        q[2] = (r02 - r20) / s;
+        q[3] = (r10 - r01) / s;
+    } else if (r00 > r11 && r00 > r22) {
+        const float s = std::sqrt(1.0f + r00 - r11 - r22) * 2.0f;
+        q[0] = (r21 - r12) / s;
+        q[1] = 0.25f * s;
+        q[2] = (r01 + r10) / s;
+        q[3] = (r02 + r20) / s;
+    } else if (r11 > r22) {
+        const float s = std::sqrt(1.0f + r11 - r00 - r22) * 2.0f;
+        q[0] = (r02 - r20) / s;
+        q[1] = (r01 + r10) / s;
+        q[2] = 0.25f * s;
+        q[3] = (r12 + r21) / s;
+    } else {
+        const float s = std::sqrt(1.0f + r22 - r00 - r11) * 2.0f;
+        q[0] = (r10 - r01) / s;
+        q[1] = (r02 + r20) / s;
+        q[2] = (r12 + r21) / s;
+        q[3] = 0.25f * s;
+    }
+
+    constexpr float RAD_TO_DEG = static_cast<float>(180.0 / PI);
+    pose.rpy[0] = std::atan2(r21, r22) * RAD_TO_DEG;
+    pose.rpy[1] = std::asin(qBound(-1.0f, -r20, 1.0f)) * RAD_TO_DEG;
+    pose.rpy[2] = std::atan2(r10, r00) * RAD_TO_DEG;
+}
+
+bool ArmKinematics::loadFile(const QString &fileName, Config &left, Config &right, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("无法打开 %1: %2").arg(fileName, file.errorString());
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (document.isNull()) {
+        if (error) *error = QString("%1 格式错误: %2").arg(fileName, parseError.errorString());
+        return false;
+    }
+
+    const QJsonObject root = document.object();
+    QString armError;
+    if (!readArm(root.value("left").toObject(), left, &armError)) {
+        if (error) *error = "左臂: " + armError;
+        return false;
+    }
+    if (!readArm(root.value("right").toObject(), right, &armError)) {
+        if (error) *error = "右臂: " + armError;
+        return false;
+    }
+    return true;
+}
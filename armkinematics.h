@@ -0,0 +1,84 @@
+#ifndef ARMKINEMATICS_H
+#define ARMKINEMATICS_H
+
+#include <QtGlobal>
+#include <QString>
+
+// 7 自由度正运动学：关节角（°）-> 末端位姿（基座/世界坐标系，位置 mm）。
+// 每个关节的参数可以用三种写法之一（可混用）：
+//   StandardDH  A = Rz(θ+offset) · Tz(d) · Tx(a) · Rx(alpha)
+//   ModifiedDH  A = Rx(alpha) · Tx(a) · Rz(θ+offset) · Tz(d)          （Craig，alpha/a 为前一连杆参数）
+//   Urdf        A = T(xyz) · R(rpy) · Rot(axis, θ+offset)              （父坐标系到本关节的原点 + 转轴）
+// 设置参数时统一化简为 T = F0 · Rz(q0) · F1 · Rz(q1) · … · Rz(q6) · F7，F 为预先算好的固定变换
+// （含基座、工具、零位偏置和转轴变换），按连续内存存放；运行时每个关节只有一次 sin/cos（7 个关节一起用 SIMD 算）、
+// 当前矩阵前两列的旋转和一次与固定变换的乘法（SSE2，不可用时退化为标量）。
+// 不加锁：同一个对象只在一个线程中使用。
+class ArmKinematics
+{
+public:
+    static constexpr int JOINT_COUNT = 7;
+
+    enum Convention {
+        StandardDH = 0,
+        ModifiedDH,
+        Urdf
+    };
+
+    // 刚体变换：先旋转（rpy，固定轴 X-Y-Z，即 R = Rz(yaw)·Ry(pitch)·Rx(roll)，°）再平移（mm）
+    struct Frame {
+        double xyz[3] = {0.0, 0.0, 0.0};
+        double rpy[3] = {0.0, 0.0, 0.0};
+    };
+
+    struct Joint {
+        Convention convention = StandardDH;
+        double a = 0.0;         // mm
+        double alpha = 0.0;     // °
+        double d = 0.0;         // mm
+        double offset = 0.0;    // 零位偏置（°），模型角 = sign × 读数 + offset
+        double sign = 1.0;      // 读数方向与模型相反时为 -1
+        Frame origin;           // Urdf
+        double axis[3] = {0.0, 0.0, 1.0}; // Urdf：本关节坐标系下的转轴
+    };
+
+    struct Config {
+        Frame base;             // 基座在世界坐标系中的位姿
+        Frame tool;             // 末端工具相对最后一个关节坐标系
+        Joint joints[JOINT_COUNT];
+    };
+
+    struct Pose {
+        float position[3];      // mm
+        float quaternion[4];    // w, x, y, z
+        float rpy[3];           // °，与 Frame 的约定相同
+    };
+
+    ArmKinematics();
+
+    // 预计算固定变换链；参数无效（如转轴为零向量）时返回 false，原因写入 error
+    bool setConfig(const Config &config, QString *error = nullptr);
+    void clear() { m_valid = false; }
+    bool isValid() const { return m_valid; }
+
+    // jointsDeg：7 个关节读数（°）
+    void compute(const float *jointsDeg, Pose &pose) const;
+
+    // 从 JSON 文件读取左右臂参数：
+    // { "left": ARM, "right": ARM }，ARM = { "convention": "dh" | "mdh" | "urdf",
+    //   "base": {"xyz": [x,y,z], "rpy": [r,p,y]}, "tool": {...},
+    //   "joints": [ 7 个 {"a", "alpha", "d", "offset", "sign"} 或 {"xyz", "rpy", "axis", "offset", "sign"} ] }
+    // 单个关节可以用 "convention" 覆盖整臂的写法；缺省的数值为 0（sign 为 1，axis 为 z）。
+    static bool loadFile(const QString &fileName, Config &left, Config &right, QString *error = nullptr);
+
+private:
+    // 预先展开的固定变换：12 个矩阵元素（3 行 × 4 列，列优先）各自复制成 4 份，运行时直接按向量加载
+    struct alignas(16) FixedTransform {
+        float lanes[12][4];
+    };
+
+    FixedTransform m_chain[JOINT_COUNT + 1];
+    alignas(16) float m_scale[8];   // sign × π/180，第 8 个通道补 0
+    bool m_valid = false;
+};
+
+#endif // ARMKINEMATICS_H
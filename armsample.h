@@ -0,0 +1,18 @@
+#ifndef ARMSAMPLE_H
+#define ARMSAMPLE_H
+
+#include <QtGlobal>
+#include "canprotocol.h"
+
+// 末端位姿曲线的通道：x, y, z（mm）, roll, pitch, yaw（°）
+constexpr int POSE_CHANNELS = 6;
+
+// 单臂历史样本：7个关节角度 + 采集时间戳
+struct ArmHistoryEntry {
+    qint64 timestampUs = 0; // AcqClock 单调时钟（微秒）
+    float joints[CANProtocol::JOINTS_PER_ARM] = {};
+    bool hasPose = false;   // 已加载运动学参数时由正运动学填入
+    float pose[POSE_CHANNELS] = {};
+};
+
+#endif // ARMSAMPLE_H
@@ -0,0 +1,323 @@
+#include "armstateshm.h"
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ArmStateShm {
+
+int64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifdef _WIN32
+// POSIX 风格的 "/name" -> Windows 会话内命名对象 "Local\name"
+static std::string windowsName(const char *name)
+{
+    std::string n = name ? name : DEFAULT_NAME;
+    if (!n.empty() && n[0] == '/') n.erase(0, 1);
+    return "Local\\" + n;
+}
+#endif
+
+// 进程是否仍在运行（无法判断时按仍在运行处理）
+static bool processAlive(uint32_t pid)
+{
+    if (pid == 0) return false;
+#ifdef _WIN32
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+    if (!process) return GetLastError() == ERROR_ACCESS_DENIED;
+    const bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return alive;
+#else
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+static uint32_t currentPid()
+{
+#ifdef _WIN32
+    return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+// 另一个写端从创建段到写入 magic 之间的最长等待；超时视为它在初始化途中退出
+static const int INIT_WAIT_MS = 100;
+
+static void sleepMs(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// 段的写端是否仍在运行（owner 输出其进程号）。
+// 段刚被另一个写端创建、尚未写入 magic 时先等待，不能当作遗留段接管
+static bool ownedByLiveWriter(const Segment *segment, uint32_t &owner)
+{
+    const volatile uint32_t &magic = segment->magic;
+    for (int i = 0; i < INIT_WAIT_MS && magic != MAGIC; ++i) {
+        sleepMs(1);
+    }
+    owner = 0;
+    if (magic != MAGIC) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    owner = segment->ownerPid;
+    return processAlive(owner);
+}
+
+// Publisher 实现
+Publisher::~Publisher()
+{
+    close();
+}
+
+bool Publisher::open(const char *name)
+{
+    close();
+    m_name = name ? name : DEFAULT_NAME;
+    const size_t size = sizeof(Segment);
+
+#ifdef _WIN32
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        0, static_cast<DWORD>(size), windowsName(m_name.c_str()).c_str());
+    if (!mapping) {
+        m_error = "CreateFileMapping failed: " + std::to_string(GetLastError());
+        return false;
+    }
+    const bool existed = GetLastError() == ERROR_ALREADY_EXISTS;
+    void *addr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!addr) {
+        m_error = "MapViewOfFile failed: " + std::to_string(GetLastError());
+        CloseHandle(mapping);
+        return false;
+    }
+    // 命名对象没有“删除”：已存在时（读端仍打开着，或另一个写端）只在原写端已退出时接管
+    uint32_t owner = 0;
+    if (existed && ownedByLiveWriter(static_cast<const Segment *>(addr), owner)) {
+        m_error = "shared memory segment is in use by process " + std::to_string(owner);
+        UnmapViewOfFile(addr);
+        CloseHandle(mapping);
+        return false;
+    }
+    m_mapping = mapping;
+#else
+    // O_EXCL：不接管别人正在写的段。同名段已存在时，写端仍在运行则失败；
+    // 写端已退出（崩溃遗留）则删除名字后重新创建（旧段的读端继续看到最后的状态）。
+    // 另一个写端刚创建、尚未 ftruncate 或写入 magic 的段先等待其初始化，不能直接删除
+    int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        const int existing = shm_open(m_name.c_str(), O_RDONLY, 0);
+        if (existing >= 0) {
+            struct stat st;
+            bool sized = false;
+            for (int i = 0; i < INIT_WAIT_MS; ++i) {
+                if (fstat(existing, &st) == 0 && static_cast<size_t>(st.st_size) >= size) {
+                    sized = true;
+                    break;
+                }
+                sleepMs(1);
+            }
+            bool inUse = false;
+            uint32_t owner = 0;
+            if (sized) {
+                void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, existing, 0);
+                if (mapped == MAP_FAILED) {
+                    // 无法判断写端是否存活，按占用处理
+                    inUse = true;
+                } else {
+                    inUse = ownedByLiveWriter(static_cast<const Segment *>(mapped), owner);
+                    munmap(mapped, size);
+                }
+            }
+            ::close(existing);
+            if (inUse) {
+                m_error = "shared memory segment " + m_name + " is in use by process " + std::to_string(owner);
+                return false;
+            }
+        }
+        shm_unlink(m_name.c_str());
+        fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+        m_error = std::string("shm_open failed: ") + std::strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        m_error = std::string("ftruncate failed: ") + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        m_error = std::string("mmap failed: ") + std::strerror(errno);
+        return false;
+    }
+#endif
+
+    // 先清零并初始化序号，最后写入 magic，读端以 magic 判断段是否就绪
+    std::memset(addr, 0, size);
+    m_segment = new (addr) Segment;
+    m_segment->seq.store(0, std::memory_order_relaxed);
+    m_segment->version = VERSION;
+    m_segment->jointCount = JOINT_COUNT;
+    m_segment->segmentSize = static_cast<uint32_t>(size);
+    m_segment->ownerPid = currentPid();
+    std::atomic_thread_fence(std::memory_order_release);
+    m_segment->magic = MAGIC;
+    m_sequence = 0;
+    m_error.clear();
+    return true;
+}
+
+void Publisher::close()
+{
+    if (!m_segment) return;
+
+    m_segment->ownerPid = 0;
+#ifdef _WIN32
+    UnmapViewOfFile(m_segment);
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+    m_mapping = nullptr;
+#else
+    munmap(m_segment, sizeof(Segment));
+    // 删除名字；已映射的读端仍可访问到最后的状态
+    shm_unlink(m_name.c_str());
+#endif
+    m_segment = nullptr;
+}
+
+void Publisher::publish(int64_t timestampUs, const float *joints, uint32_t validMask)
+{
+    if (!m_segment) return;
+
+    std::atomic<uint64_t> &seq = m_segment->seq;
+    const uint64_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    State &state = m_segment->state;
+    state.sequence = ++m_sequence;
+    state.timestampUs = timestampUs;
+    state.validMask = validMask;
+    std::memcpy(state.joints, joints, sizeof(state.joints));
+    state.publishUs = nowUs();
+
+    seq.store(s + 2, std::memory_order_release);
+}
+
+// Reader 实现
+Reader::~Reader()
+{
+    close();
+}
+
+bool Reader::open(const char *name)
+{
+    close();
+    const size_t size = sizeof(Segment);
+    const void *addr = nullptr;
+
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, windowsName(name).c_str());
+    if (!mapping) {
+        m_error = "OpenFileMapping failed: " + std::to_string(GetLastError());
+        return false;
+    }
+    addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    if (!addr) {
+        m_error = "MapViewOfFile failed: " + std::to_string(GetLastError());
+        CloseHandle(mapping);
+        return false;
+    }
+    m_mapping = mapping;
+#else
+    const int fd = shm_open(name ? name : DEFAULT_NAME, O_RDONLY, 0);
+    if (fd < 0) {
+        m_error = std::string("shm_open failed: ") + std::strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < size) {
+        m_error = "shared memory segment is too small";
+        ::close(fd);
+        return false;
+    }
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        m_error = std::string("mmap failed: ") + std::strerror(errno);
+        return false;
+    }
+    addr = mapped;
+#endif
+
+    m_segment = static_cast<const Segment *>(addr);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_segment->magic != MAGIC || m_segment->version != VERSION ||
+        m_segment->jointCount != static_cast<uint32_t>(JOINT_COUNT)) {
+        m_error = "shared memory segment is not initialized or has an incompatible version";
+        close();
+        return false;
+    }
+    m_error.clear();
+    return true;
+}
+
+void Reader::close()
+{
+    if (!m_segment) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_segment);
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+    m_mapping = nullptr;
+#else
+    munmap(const_cast<Segment *>(m_segment), sizeof(Segment));
+#endif
+    m_segment = nullptr;
+}
+
+bool Reader::tryRead(State &out) const
+{
+    if (!m_segment) return false;
+
+    const uint64_t s1 = m_segment->seq.load(std::memory_order_acquire);
+    if (s1 == 0 || (s1 & 1)) return false; // 尚未发布或正在写入
+
+    std::memcpy(&out, &m_segment->state, sizeof(State));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    const uint64_t s2 = m_segment->seq.load(std::memory_order_relaxed);
+    return s1 == s2;
+}
+
+bool Reader::read(State &out, int maxAttempts) const
+{
+    for (int i = 0; i < maxAttempts; ++i) {
+        if (tryRead(out)) return true;
+    }
+    return false;
+}
+
+uint64_t Reader::sequence() const
+{
+    return m_segment ? m_segment->seq.load(std::memory_order_acquire) / 2 : 0;
+}
+
+} // namespace ArmStateShm
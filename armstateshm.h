@@ -0,0 +1,108 @@
+#ifndef ARMSTATESHM_H
+#define ARMSTATESHM_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 共享内存中的最新臂状态（seqlock）
+// 写端（采集进程）每收到一个样本就覆盖写入；读端（其他本地进程）无锁、无系统调用地读取最新值。
+// 本文件及对应实现不依赖 Qt，下游控制程序可以直接链接 Linker_TA_shm。
+// 时间戳均为 std::chrono::steady_clock 微秒（Linux 上即 CLOCK_MONOTONIC，跨进程可比较）。
+namespace ArmStateShm {
+
+constexpr const char *DEFAULT_NAME = "/linker_ta_arm_state";
+constexpr uint32_t MAGIC = 0x5341544C; // "LTAS"
+constexpr uint32_t VERSION = 1;
+constexpr int JOINT_COUNT = 14;
+
+enum ValidMask : uint32_t {
+    LeftArmValid = 0x01,   // joints[0..6]
+    RightArmValid = 0x02   // joints[7..13]
+};
+
+// 一次读取得到的完整状态
+struct State {
+    uint64_t sequence = 0;      // 每次发布加 1
+    int64_t timestampUs = 0;    // 采集时间
+    int64_t publishUs = 0;      // 写入共享内存的时间
+    uint32_t validMask = 0;
+    float joints[JOINT_COUNT] = {};
+};
+
+// 共享内存布局；seq 为奇数表示正在写入
+struct alignas(64) Segment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t jointCount;
+    uint32_t segmentSize;
+    uint32_t ownerPid;          // 写端进程号（关闭时清零）；同名段只允许一个存活的写端
+    alignas(64) std::atomic<uint64_t> seq;
+    State state;
+};
+
+// steady_clock 微秒
+int64_t nowUs();
+
+// 写端：创建并映射共享内存。
+// 同名的段已存在且写端进程仍在运行时 open() 失败（两个写端会破坏 seqlock）；
+// 写端进程已退出（崩溃后遗留）的段会被替换
+class Publisher
+{
+public:
+    Publisher() = default;
+    ~Publisher();
+    Publisher(const Publisher &) = delete;
+    Publisher &operator=(const Publisher &) = delete;
+
+    bool open(const char *name = DEFAULT_NAME);
+    void close();
+    bool isOpen() const { return m_segment != nullptr; }
+    const std::string &errorString() const { return m_error; }
+
+    // 只能由一个线程调用
+    void publish(int64_t timestampUs, const float *joints, uint32_t validMask);
+    uint64_t publishedCount() const { return m_sequence; }
+
+private:
+    Segment *m_segment = nullptr;
+    std::string m_name;
+    std::string m_error;
+    uint64_t m_sequence = 0;
+#ifdef _WIN32
+    void *m_mapping = nullptr;
+#endif
+};
+
+// 读端：映射已存在的共享内存（只读）
+class Reader
+{
+public:
+    Reader() = default;
+    ~Reader();
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    bool open(const char *name = DEFAULT_NAME);
+    void close();
+    bool isOpen() const { return m_segment != nullptr; }
+    const std::string &errorString() const { return m_error; }
+
+    // 单次尝试读取：写端正在写入或读取期间被覆盖时返回 false
+    bool tryRead(State &out) const;
+    // 重试直到读到一致的状态（写入只有几十纳秒，通常一次成功）
+    bool read(State &out, int maxAttempts = 64) const;
+    // 当前序号（可用于轮询是否有新数据）
+    uint64_t sequence() const;
+
+private:
+    const Segment *m_segment = nullptr;
+    std::string m_error;
+#ifdef _WIN32
+    void *m_mapping = nullptr;
+#endif
+};
+
+} // namespace ArmStateShm
+
+#endif // ARMSTATESHM_H
@@ -0,0 +1,50 @@
+#ifndef ARMSTREAMFORMAT_H
+#define ARMSTREAMFORMAT_H
+
+#include <cstdint>
+
+// 臂数据推送流的数据报格式（小端）
+// 每个数据报 = DatagramHeader + sampleCount 个 Sample。不依赖 Qt，接收端可以直接包含本文件。
+// 发送端不重传：接收端用 datagramSequence 判断丢包，用 firstSampleSequence 统计丢失的样本数。
+namespace ArmStreamFormat {
+
+constexpr uint32_t MAGIC = 0x4441544C; // "LTAD"
+// 版本 2 增加末端位姿样本（ArmId LeftPose/RightPose，7 个值不是关节角）；
+// 只处理关节角的接收端应检查 version，或按 armId 跳过不认识的样本
+constexpr uint16_t VERSION = 2;
+constexpr int MAX_JOINTS = 14;
+constexpr int MAX_SAMPLES_PER_DATAGRAM = 64;
+
+struct DatagramHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sampleCount;
+    uint64_t datagramSequence;    // 每个数据报加 1（对所有接收端相同）
+    uint64_t firstSampleSequence; // 第一个样本的序号，样本序号每个样本加 1
+    int64_t sendUs;               // 发送时间（steady_clock 微秒）
+};
+static_assert(sizeof(DatagramHeader) == 32, "DatagramHeader layout");
+
+// 与 SessionFormat::ArmId 取值一致
+enum ArmId : uint16_t {
+    LeftArm = 0,    // joints[0..6]
+    RightArm = 1,   // joints[0..6]
+    BothArms = 2,   // joints[0..13]
+    LeftPose = 3,   // joints[0..6] 为末端位姿：x, y, z（mm）, qw, qx, qy, qz；版本 2 起
+    RightPose = 4
+};
+
+struct Sample {
+    int64_t timestampUs;          // 采集时间（steady_clock 微秒）
+    uint16_t armId;
+    uint16_t jointCount;
+    uint32_t reserved;
+    float joints[MAX_JOINTS];     // 只有前 jointCount 个有效
+};
+static_assert(sizeof(Sample) == 72, "Sample layout");
+
+constexpr int MAX_DATAGRAM_SIZE = sizeof(DatagramHeader) + MAX_SAMPLES_PER_DATAGRAM * sizeof(Sample);
+
+} // namespace ArmStreamFormat
+
+#endif // ARMSTREAMFORMAT_H
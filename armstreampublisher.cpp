@@ -0,0 +1,391 @@
+#include "armstreampublisher.h"
+#include "acqclock.h"
+#include "trace.h"
+#include <QFile>
+#include <cstddef>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace ArmStreamFormat;
+
+static void closeSocket(qintptr &fd)
+{
+    if (fd == -1) return;
+#ifdef Q_OS_WIN
+    ::closesocket(static_cast<SOCKET>(fd));
+#else
+    ::close(static_cast<int>(fd));
+#endif
+    fd = -1;
+}
+
+ArmStreamPublisher::ArmStreamPublisher(QObject *parent)
+    : QThread(parent)
+{
+}
+
+ArmStreamPublisher::~ArmStreamPublisher()
+{
+    close();
+}
+
+bool ArmStreamPublisher::open(const QStringList &consumers, int latencyBudgetUs, int batchSamples)
+{
+    if (m_open) {
+        close();
+    }
+
+    m_consumerCount = 0;
+    for (const QString &spec : consumers) {
+        if (spec.trimmed().isEmpty()) continue;
+        if (!addConsumer(spec.trimmed())) {
+            m_consumerCount = 0;
+            return false;
+        }
+    }
+    if (m_consumerCount == 0) {
+        emit errorOccurred("未指定推送接收端");
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        emit errorOccurred("WSAStartup 失败");
+        return false;
+    }
+#endif
+
+    bool needUdp = false;
+    bool needUnix = false;
+    for (int i = 0; i < m_consumerCount; ++i) {
+        (m_consumers[i].isUnix ? needUnix : needUdp) = true;
+    }
+    if (needUdp) {
+        m_udpSocket = static_cast<qintptr>(::socket(AF_INET, SOCK_DGRAM, 0));
+#ifdef Q_OS_WIN
+        if (static_cast<SOCKET>(m_udpSocket) == INVALID_SOCKET) m_udpSocket = -1;
+        u_long nonBlocking = 1;
+        if (m_udpSocket != -1) ioctlsocket(static_cast<SOCKET>(m_udpSocket), FIONBIO, &nonBlocking);
+#endif
+    }
+#ifndef Q_OS_WIN
+    if (needUnix) {
+        m_unixSocket = static_cast<qintptr>(::socket(AF_UNIX, SOCK_DGRAM, 0));
+    }
+#endif
+    if ((needUdp && m_udpSocket == -1) || (needUnix && m_unixSocket == -1)) {
+        emit errorOccurred("创建推送套接字失败");
+        closeSockets();
+        return false;
+    }
+
+    m_latencyBudgetUs = qMax(100, latencyBudgetUs);
+    m_batchSamples = qBound(1, batchSamples, MAX_SAMPLES_PER_DATAGRAM);
+    const int stride = static_cast<int>(sizeof(DatagramHeader) + m_batchSamples * sizeof(Sample));
+    m_datagrams = QByteArray(stride * MAX_DATAGRAMS_PER_FLUSH, Qt::Uninitialized);
+
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_wake.acquire(m_wake.available());
+    m_pendingSamples = 0;
+    m_pendingStartUs.store(0, std::memory_order_relaxed);
+    m_datagramSequence = 0;
+    m_sampleSequence = 0;
+    m_publishedSamples.store(0, std::memory_order_relaxed);
+    m_queueDropped.store(0, std::memory_order_relaxed);
+
+    m_stopping.store(false);
+    m_open = true;
+    start();
+    return true;
+}
+
+bool ArmStreamPublisher::addConsumer(const QString &spec)
+{
+    if (m_consumerCount >= MAX_CONSUMERS) {
+        emit errorOccurred(QString("推送接收端最多 %1 个").arg(MAX_CONSUMERS));
+        return false;
+    }
+
+    Consumer &consumer = m_consumers[m_consumerCount];
+    std::memset(consumer.addr, 0, sizeof(consumer.addr));
+    consumer.address = spec;
+    consumer.datagramsSent.store(0, std::memory_order_relaxed);
+    consumer.datagramsDropped.store(0, std::memory_order_relaxed);
+    consumer.samplesDropped.store(0, std::memory_order_relaxed);
+
+    if (spec.startsWith("udp:")) {
+        const QString rest = spec.mid(4);
+        const int colon = rest.lastIndexOf(':');
+        QString host = rest.left(colon);
+        bool ok = false;
+        const quint16 port = rest.mid(colon + 1).toUShort(&ok);
+        if (host == "localhost") host = "127.0.0.1";
+
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (colon < 0 || !ok || port == 0 ||
+            inet_pton(AF_INET, host.toLatin1().constData(), &addr.sin_addr) != 1) {
+            emit errorOccurred(QString("无效的 UDP 接收端: %1（格式 udp:127.0.0.1:9870）").arg(spec));
+            return false;
+        }
+        std::memcpy(consumer.addr, &addr, sizeof(addr));
+        consumer.addrLen = sizeof(addr);
+        consumer.isUnix = false;
+    } else if (spec.startsWith("unix:")) {
+#ifdef Q_OS_WIN
+        emit errorOccurred(QString("Windows 不支持 Unix 数据报套接字: %1").arg(spec));
+        return false;
+#else
+        const QByteArray path = QFile::encodeName(spec.mid(5));
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.isEmpty() || path.size() >= static_cast<int>(sizeof(addr.sun_path))) {
+            emit errorOccurred(QString("无效的 Unix 套接字路径: %1").arg(spec));
+            return false;
+        }
+        std::memcpy(addr.sun_path, path.constData(), path.size());
+        static_assert(sizeof(sockaddr_un) <= sizeof(Consumer::addr), "sockaddr buffer");
+        std::memcpy(consumer.addr, &addr, sizeof(addr));
+        consumer.addrLen = static_cast<int>(offsetof(sockaddr_un, sun_path) + path.size() + 1);
+        consumer.isUnix = true;
+#endif
+    } else {
+        emit errorOccurred(QString("无法识别的推送接收端: %1（udp:HOST:PORT 或 unix:PATH）").arg(spec));
+        return false;
+    }
+
+    ++m_consumerCount;
+    return true;
+}
+
+void ArmStreamPublisher::close()
+{
+    if (!m_open) return;
+
+    m_stopping.store(true);
+    m_wake.release();
+    wait();
+
+    closeSockets();
+    m_open = false;
+}
+
+void ArmStreamPublisher::closeSockets()
+{
+    closeSocket(m_udpSocket);
+    closeSocket(m_unixSocket);
+#ifdef Q_OS_WIN
+    WSACleanup();
+#endif
+}
+
+void ArmStreamPublisher::publish(qint64 timestampUs, quint16 armId, const float *values, int count)
+{
+    if (!m_open) return;
+
+    const quint64 tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) >= QUEUE_CAPACITY) {
+        // 发送线程跟不上：丢弃本样本
+        m_queueDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Sample &sample = m_queue[tail & (QUEUE_CAPACITY - 1)];
+    count = qBound(0, count, MAX_JOINTS);
+    sample.timestampUs = timestampUs;
+    sample.armId = armId;
+    sample.jointCount = static_cast<uint16_t>(count);
+    sample.reserved = 0;
+    std::memcpy(sample.joints, values, count * sizeof(float));
+    if (count < MAX_JOINTS) {
+        std::memset(sample.joints + count, 0, (MAX_JOINTS - count) * sizeof(float));
+    }
+    m_tail.store(tail + 1, std::memory_order_release);
+    m_publishedSamples.fetch_add(1, std::memory_order_relaxed);
+
+    // 凑满一个数据报或第一个样本已等待超过延迟预算时唤醒发送线程
+    const qint64 nowUs = AcqClock::nowUs();
+    if (m_pendingSamples++ == 0) {
+        m_pendingStartUs.store(nowUs, std::memory_order_relaxed);
+    }
+    if (m_pendingSamples >= m_batchSamples ||
+        nowUs - m_pendingStartUs.load(std::memory_order_relaxed) >= m_latencyBudgetUs) {
+        m_pendingSamples = 0;
+        m_pendingStartUs.store(0, std::memory_order_relaxed);
+        m_wake.release();
+    }
+}
+
+QVector<ArmStreamPublisher::ConsumerStats> ArmStreamPublisher::consumerStats() const
+{
+    QVector<ConsumerStats> stats;
+    stats.reserve(m_consumerCount);
+    for (int i = 0; i < m_consumerCount; ++i) {
+        const Consumer &consumer = m_consumers[i];
+        ConsumerStats s;
+        s.address = consumer.address;
+        s.datagramsSent = consumer.datagramsSent.load(std::memory_order_relaxed);
+        s.datagramsDropped = consumer.datagramsDropped.load(std::memory_order_relaxed);
+        s.samplesDropped = consumer.samplesDropped.load(std::memory_order_relaxed);
+        stats.append(s);
+    }
+    return stats;
+}
+
+int ArmStreamPublisher::drainToDatagrams()
+{
+    const int stride = static_cast<int>(sizeof(DatagramHeader) + m_batchSamples * sizeof(Sample));
+    quint64 head = m_head.load(std::memory_order_relaxed);
+    const quint64 tail = m_tail.load(std::memory_order_acquire);
+
+    int datagramCount = 0;
+    while (head != tail && datagramCount < MAX_DATAGRAMS_PER_FLUSH) {
+        const int count = static_cast<int>(qMin<quint64>(tail - head, m_batchSamples));
+        char *dst = m_datagrams.data() + datagramCount * stride;
+
+        DatagramHeader header;
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.sampleCount = static_cast<uint16_t>(count);
+        header.datagramSequence = m_datagramSequence++;
+        header.firstSampleSequence = m_sampleSequence;
+        header.sendUs = AcqClock::nowUs();
+        std::memcpy(dst, &header, sizeof(header));
+
+        Sample *samples = reinterpret_cast<Sample *>(dst + sizeof(header));
+        for (int i = 0; i < count; ++i) {
+            std::memcpy(samples + i, &m_queue[(head + i) & (QUEUE_CAPACITY - 1)], sizeof(Sample));
+        }
+        head += count;
+        m_sampleSequence += count;
+
+        m_datagramSizes[datagramCount] = static_cast<int>(sizeof(header) + count * sizeof(Sample));
+        m_datagramSamples[datagramCount] = count;
+        ++datagramCount;
+    }
+    // 样本已拷出，归还队列空间
+    m_head.store(head, std::memory_order_release);
+    return datagramCount;
+}
+
+void ArmStreamPublisher::sendDatagrams(int datagramCount)
+{
+    const int stride = static_cast<int>(sizeof(DatagramHeader) + m_batchSamples * sizeof(Sample));
+    const auto account = [this](int consumerIndex, int datagramIndex, bool sent) {
+        Consumer &consumer = m_consumers[consumerIndex];
+        if (sent) {
+            consumer.datagramsSent.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            // 接收端缓冲区满、未监听等：只丢弃发给该接收端的数据报
+            consumer.datagramsDropped.fetch_add(1, std::memory_order_relaxed);
+            consumer.samplesDropped.fetch_add(m_datagramSamples[datagramIndex], std::memory_order_relaxed);
+        }
+    };
+
+#ifdef Q_OS_LINUX
+    // 每个套接字一次 sendmmsg 发出 (数据报 x 接收端) 条消息
+    constexpr int MAX_MESSAGES = MAX_DATAGRAMS_PER_FLUSH * MAX_CONSUMERS;
+    mmsghdr messages[MAX_MESSAGES];
+    iovec iovecs[MAX_MESSAGES];
+    int consumerOf[MAX_MESSAGES];
+    int datagramOf[MAX_MESSAGES];
+
+    for (const bool unixFamily : {false, true}) {
+        const int fd = static_cast<int>(unixFamily ? m_unixSocket : m_udpSocket);
+        if (fd == -1) continue;
+
+        int count = 0;
+        for (int c = 0; c < m_consumerCount; ++c) {
+            if (m_consumers[c].isUnix != unixFamily) continue;
+            for (int d = 0; d < datagramCount; ++d) {
+                iovecs[count].iov_base = m_datagrams.data() + d * stride;
+                iovecs[count].iov_len = static_cast<size_t>(m_datagramSizes[d]);
+                std::memset(&messages[count], 0, sizeof(mmsghdr));
+                messages[count].msg_hdr.msg_name = m_consumers[c].addr;
+                messages[count].msg_hdr.msg_namelen = static_cast<socklen_t>(m_consumers[c].addrLen);
+                messages[count].msg_hdr.msg_iov = &iovecs[count];
+                messages[count].msg_hdr.msg_iovlen = 1;
+                consumerOf[count] = c;
+                datagramOf[count] = d;
+                ++count;
+            }
+        }
+
+        int offset = 0;
+        while (offset < count) {
+            const int sent = ::sendmmsg(fd, messages + offset, static_cast<unsigned int>(count - offset), MSG_DONTWAIT);
+            if (sent > 0) {
+                for (int i = offset; i < offset + sent; ++i) {
+                    account(consumerOf[i], datagramOf[i], true);
+                }
+                offset += sent;
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else {
+                // sendmmsg 在第一条失败的消息处停止：记为丢弃后从下一条继续
+                account(consumerOf[offset], datagramOf[offset], false);
+                ++offset;
+            }
+        }
+    }
+#else
+    for (int c = 0; c < m_consumerCount; ++c) {
+        const Consumer &consumer = m_consumers[c];
+        const qintptr fd = consumer.isUnix ? m_unixSocket : m_udpSocket;
+        if (fd == -1) continue;
+        for (int d = 0; d < datagramCount; ++d) {
+            const char *data = m_datagrams.constData() + d * stride;
+#ifdef Q_OS_WIN
+            const int sent = ::sendto(static_cast<SOCKET>(fd), data, m_datagramSizes[d], 0,
+                                      reinterpret_cast<const sockaddr *>(consumer.addr), consumer.addrLen);
+#else
+            const ssize_t sent = ::sendto(static_cast<int>(fd), data, static_cast<size_t>(m_datagramSizes[d]), MSG_DONTWAIT,
+                                          reinterpret_cast<const sockaddr *>(consumer.addr),
+                                          static_cast<socklen_t>(consumer.addrLen));
+#endif
+            account(c, d, sent == static_cast<decltype(sent)>(m_datagramSizes[d]));
+        }
+    }
+#endif
+}
+
+void ArmStreamPublisher::run()
+{
+    TRACE_THREAD_NAME("stream-sender");
+    const int waitMs = qMax(1, m_latencyBudgetUs / 1000);
+    while (true) {
+        const bool woken = m_wake.tryAcquire(1, waitMs);
+        // 先读停止标志再取队列：停止前写入的样本一定能在本轮发出
+        const bool stopping = m_stopping.load();
+
+        if (!woken && !stopping) {
+            // 超时未被唤醒：数据流停顿，只有残留样本已等待超过预算时才发出
+            const qint64 startUs = m_pendingStartUs.load(std::memory_order_relaxed);
+            if (startUs == 0 || AcqClock::nowUs() - startUs < m_latencyBudgetUs) continue;
+        }
+
+        int datagramCount;
+        while ((datagramCount = drainToDatagrams()) > 0) {
+            TRACE_SCOPE_ARG(StreamSend, datagramCount);
+            sendDatagrams(datagramCount);
+        }
+
+        if (stopping) break;
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef ARMSTREAMPUBLISHER_H
+#define ARMSTREAMPUBLISHER_H
+
+#include <QThread>
+#include <QSemaphore>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "armstreamformat.h"
+
+// 臂数据推送：把样本打包成数据报（格式见 armstreamformat.h），通过本机 UDP 或 Unix 数据报套接字发给多个接收端。
+// 采集线程只把样本拷进无锁环形队列；发送线程凑满一个数据报或超过延迟预算后统一发出，
+// Linux 上一次 sendmmsg 发给所有接收端。套接字为非阻塞，接收端来不及读时丢弃并按接收端计数，
+// 采集线程永远不会等待网络。
+// publish() 只能由同一个线程调用（单生产者），通常为数据到达的 GUI 线程。
+class ArmStreamPublisher : public QThread
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_CONSUMERS = 8;
+    static constexpr int DEFAULT_LATENCY_BUDGET_US = 2000;
+    static constexpr int DEFAULT_BATCH_SAMPLES = 16;
+
+    // 接收端统计
+    struct ConsumerStats {
+        QString address;
+        quint64 datagramsSent = 0;
+        quint64 datagramsDropped = 0;
+        quint64 samplesDropped = 0;
+    };
+
+    explicit ArmStreamPublisher(QObject *parent = nullptr);
+    ~ArmStreamPublisher();
+
+    // 打开套接字并启动发送线程。接收端格式为 udp:HOST:PORT 或 unix:PATH（Unix 数据报套接字，Windows 不支持）
+    // 失败时发出 errorOccurred 并返回 false
+    bool open(const QStringList &consumers,
+              int latencyBudgetUs = DEFAULT_LATENCY_BUDGET_US,
+              int batchSamples = DEFAULT_BATCH_SAMPLES);
+    // 发出剩余样本并等待发送线程结束
+    void close();
+    bool isOpen() const { return m_open; }
+
+    // 采集线程调用
+    void publish(qint64 timestampUs, quint16 armId, const float *values, int count);
+
+    // 统计（任意线程可读）
+    quint64 publishedSamples() const { return m_publishedSamples.load(std::memory_order_relaxed); }
+    quint64 queueDroppedSamples() const { return m_queueDropped.load(std::memory_order_relaxed); }
+    QVector<ConsumerStats> consumerStats() const;
+
+signals:
+    void errorOccurred(const QString &error);
+
+protected:
+    void run() override;
+
+private:
+    static constexpr int QUEUE_CAPACITY = 4096; // 2 的幂
+    static constexpr int MAX_DATAGRAMS_PER_FLUSH = 16;
+
+    struct Consumer {
+        QString address;
+        bool isUnix = false;
+        alignas(8) unsigned char addr[112] = {}; // sockaddr_in / sockaddr_un
+        int addrLen = 0;
+        std::atomic<quint64> datagramsSent{0};
+        std::atomic<quint64> datagramsDropped{0};
+        std::atomic<quint64> samplesDropped{0};
+    };
+
+    bool m_open = false;
+    std::atomic<bool> m_stopping{false};
+    int m_latencyBudgetUs = DEFAULT_LATENCY_BUDGET_US;
+    int m_batchSamples = DEFAULT_BATCH_SAMPLES;
+
+    Consumer m_consumers[MAX_CONSUMERS];
+    int m_consumerCount = 0;
+    qintptr m_udpSocket = -1;
+    qintptr m_unixSocket = -1;
+
+    // 单生产者单消费者环形队列
+    ArmStreamFormat::Sample m_queue[QUEUE_CAPACITY];
+    std::atomic<quint64> m_head{0}; // 发送线程位置
+    std::atomic<quint64> m_tail{0}; // 采集线程位置
+    QSemaphore m_wake;
+
+    // 采集线程：自上次唤醒发送线程以来的样本数和第一个样本的到达时间
+    // 发送线程等待超时时也读取 m_pendingStartUs，数据流停顿时残留的样本不会超过延迟预算太久
+    int m_pendingSamples = 0;
+    std::atomic<qint64> m_pendingStartUs{0};
+
+    // 发送线程：一次最多组 MAX_DATAGRAMS_PER_FLUSH 个数据报
+    QByteArray m_datagrams;
+    int m_datagramSizes[MAX_DATAGRAMS_PER_FLUSH] = {};
+    int m_datagramSamples[MAX_DATAGRAMS_PER_FLUSH] = {};
+    quint64 m_datagramSequence = 0;
+    quint64 m_sampleSequence = 0;
+
+    std::atomic<quint64> m_publishedSamples{0};
+    std::atomic<quint64> m_queueDropped{0};
+
+    bool addConsumer(const QString &spec);
+    void closeSockets();
+    int drainToDatagrams();
+    void sendDatagrams(int datagramCount);
+};
+
+#endif // ARMSTREAMPUBLISHER_H
@@ -0,0 +1,92 @@
+#include "armtablemodel.h"
+#include <QtMath>
+
+ArmTableModel::ArmTableModel(int firstJointId, const QStringList &jointNames, int decimals, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_decimals(decimals)
+    , m_scale(qPow(10.0, decimals))
+{
+    for (int i = 0; i < jointNames.size(); ++i) {
+        m_labels.append(QString("ID%1(%2)").arg(firstJointId + i).arg(jointNames[i]));
+    }
+    m_quantized.fill(0, m_labels.size());
+    m_valid.fill(false, m_labels.size());
+    m_text.resize(m_labels.size());
+}
+
+bool ArmTableModel::setValues(const float *values, int count)
+{
+    count = qMin(count, m_labels.size());
+
+    int firstChanged = -1;
+    int lastChanged = -1;
+    for (int row = 0; row < count; ++row) {
+        // 只有显示出来的数字发生变化才需要刷新
+        const qint64 q = qRound64(static_cast<double>(values[row]) * m_scale);
+        if (m_valid[row] && m_quantized[row] == q) continue;
+
+        m_valid[row] = true;
+        m_quantized[row] = q;
+        m_text[row] = QString::number(values[row], 'f', m_decimals);
+
+        if (firstChanged < 0) firstChanged = row;
+        lastChanged = row;
+    }
+
+    if (firstChanged < 0) return false;
+    emit dataChanged(index(firstChanged, ValueColumn), index(lastChanged, ValueColumn), {Qt::DisplayRole});
+    return true;
+}
+
+void ArmTableModel::clearValues()
+{
+    bool any = false;
+    for (int row = 0; row < m_valid.size(); ++row) {
+        if (m_valid[row]) {
+            m_valid[row] = false;
+            m_text[row].clear();
+            any = true;
+        }
+    }
+    if (any) {
+        emit dataChanged(index(0, ValueColumn), index(m_valid.size() - 1, ValueColumn), {Qt::DisplayRole});
+    }
+}
+
+int ArmTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_labels.size();
+}
+
+int ArmTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ArmTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) return QVariant();
+
+    const int row = index.row();
+    if (row < 0 || row >= m_labels.size()) return QVariant();
+
+    if (index.column() == LabelColumn) {
+        return m_labels[row];
+    }
+    if (index.column() == ValueColumn && m_valid[row]) {
+        return m_text[row];
+    }
+    return QVariant();
+}
+
+QVariant ArmTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case LabelColumn: return QString("关节");
+    case ValueColumn: return QString("角度(°)");
+    default: return QVariant();
+    }
+}
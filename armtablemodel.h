@@ -0,0 +1,43 @@
+#ifndef ARMTABLEMODEL_H
+#define ARMTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QVector>
+
+// 单臂关节表格模型：第0列为静态关节名称，第1列为最新角度
+// setValues() 只对变化超过显示精度的单元格发出 dataChanged，
+// 因此即使以 30~60Hz 刷新，未变化的单元格也不会重绘。返回是否有单元格变化。
+class ArmTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        LabelColumn = 0,
+        ValueColumn,
+        ColumnCount
+    };
+
+    // firstJointId: 第一行对应的关节ID（左臂0，右臂7）
+    ArmTableModel(int firstJointId, const QStringList &jointNames, int decimals = 2, QObject *parent = nullptr);
+
+    bool setValues(const float *values, int count);
+    void clearValues();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    QStringList m_labels;       // 预先生成的 "ID%1(%2)"
+    int m_decimals;
+    double m_scale;             // 10^decimals
+
+    QVector<qint64> m_quantized; // 按显示精度量化后的值，用于判断是否需要刷新
+    QVector<bool> m_valid;
+    QVector<QString> m_text;     // 缓存的显示文本
+};
+
+#endif // ARMTABLEMODEL_H
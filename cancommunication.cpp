@@ -1,7 +1,15 @@
 #include "cancommunication.h"
+#include "acqclock.h"
+#include "trace.h"
+#include "log.h"
 #include <QDebug>
 #include <QMutexLocker>
+#ifdef Q_OS_WIN
 #include <windows.h>
+#else
+// PCAN-Basic 只提供 Windows DLL；其他平台上 CAN 连接会失败，其余功能照常编译
+#define __stdcall
+#endif
 
 // PCAN-Basic 数据结构
 #pragma pack(push, 1)
@@ -26,7 +34,9 @@ typedef TPCANStatus (__stdcall *FP_CAN_Read)(TPCANHandle, TPCANMsg*, TPCANTimest
 typedef TPCANStatus (__stdcall *FP_CAN_Write)(TPCANHandle, TPCANMsg*);
 
 // 全局函数指针（动态加载）
+#ifdef Q_OS_WIN
 static HMODULE s_pcanDll = nullptr;
+#endif
 static FP_CAN_Initialize s_canInitialize = nullptr;
 static FP_CAN_Uninitialize s_canUninitialize = nullptr;
 static FP_CAN_Read s_canRead = nullptr;
@@ -34,6 +44,10 @@ static FP_CAN_Write s_canWrite = nullptr;
 
 // 动态加载PCAN-Basic DLL
 static bool loadPCANLibrary() {
+#ifndef Q_OS_WIN
+    LOG_CAN_W("PCAN-Basic is only available on Windows.");
+    return false;
+#else
     if (s_pcanDll != nullptr) {
         return true;  // 已加载
     }
@@ -42,7 +56,7 @@ static bool loadPCANLibrary() {
     s_pcanDll = LoadLibraryA("PCANBasic.dll");
 
     if (s_pcanDll == nullptr) {
-        qWarning() << "Failed to load PCANBasic.dll. Please install PCAN-Basic driver.";
+        LOG_CAN_W("Failed to load PCANBasic.dll. Please install PCAN-Basic driver.");
         return false;
     }
 
@@ -53,13 +67,14 @@ static bool loadPCANLibrary() {
     s_canWrite = (FP_CAN_Write)GetProcAddress(s_pcanDll, "CAN_Write");
 
     if (!s_canInitialize || !s_canUninitialize || !s_canRead || !s_canWrite) {
-        qWarning() << "Failed to get PCAN-Basic function addresses.";
+        LOG_CAN_W("Failed to get PCAN-Basic function addresses.");
         FreeLibrary(s_pcanDll);
         s_pcanDll = nullptr;
         return false;
     }
 
     return true;
+#endif
 }
 
 // CANWorkerThread 实现
@@ -89,6 +104,7 @@ void CANWorkerThread::stop() {
 }
 
 void CANWorkerThread::run() {
+    TRACE_THREAD_NAME("can-worker");
     m_running = true;
 
     // 初始化PCAN
@@ -104,19 +120,22 @@ void CANWorkerThread::run() {
     m_connected = true;
     emit connectionChanged(true);
 
-    qDebug() << "PCAN initialized successfully";
+    LOG_CAN_I("PCAN initialized successfully");
 
     // 接收循环
     QByteArray data;
     quint16 id;
+    qint64 timestampUs;
+    m_hwClockSynced = false;
 
     while (m_running) {
         data.resize(8);
-        status = readCAN(m_handle, data, id);
+        status = readCAN(m_handle, data, id, timestampUs);
 
         if (status == PCAN_ERROR_OK) {
             // 成功接收到数据
-            CANDataFrame frame(id, data);
+            CANDataFrame frame(id, data, timestampUs);
+            TRACE_INSTANT(CanRead, id);
             emit frameReceived(frame);
         } else if (status == 0x20) { // PCAN_ERROR_QRCVEMPTY
             // 没有数据，继续等待
@@ -159,7 +178,7 @@ TPCANStatus CANWorkerThread::uninitializeCAN(TPCANHandle handle) {
     return PCAN_ERROR_OK;
 }
 
-TPCANStatus CANWorkerThread::readCAN(TPCANHandle handle, QByteArray &data, quint16 &id) {
+TPCANStatus CANWorkerThread::readCAN(TPCANHandle handle, QByteArray &data, quint16 &id, qint64 &timestampUs) {
     if (!s_canRead) {
         return 0x20; // PCAN_ERROR_QRCVEMPTY
     }
@@ -172,11 +191,30 @@ TPCANStatus CANWorkerThread::readCAN(TPCANHandle handle, QByteArray &data, quint
     if (status == PCAN_ERROR_OK) {
         id = static_cast<quint16>(canMsg.ID);
         data = QByteArray(reinterpret_cast<char*>(canMsg.DATA), canMsg.LEN);
+
+        // PCAN硬件时间戳: micros + 1000 * millis + 0x100000000 * 1000 * millis_overflow
+        const qint64 hardwareUs = static_cast<qint64>(timestamp.micros)
+                                  + 1000LL * timestamp.millis
+                                  + 0x100000000LL * 1000LL * timestamp.millis_overflow;
+        timestampUs = hardwareToHostUs(hardwareUs);
     }
 
     return status;
 }
 
+qint64 CANWorkerThread::hardwareToHostUs(qint64 hardwareUs) {
+    const qint64 hostUs = AcqClock::nowUs();
+    qint64 mapped = hardwareUs + m_hwClockOffsetUs;
+
+    // 换算结果不应晚于当前时间，也不应比当前时间早太多（驱动队列积压上限按50ms计）
+    if (!m_hwClockSynced || mapped > hostUs || hostUs - mapped > 50000) {
+        m_hwClockOffsetUs = hostUs - hardwareUs;
+        m_hwClockSynced = true;
+        mapped = hostUs;
+    }
+    return mapped;
+}
+
 TPCANStatus CANWorkerThread::writeCAN(TPCANHandle handle, quint16 id, const QByteArray &data) {
     if (!s_canWrite) {
         return PCAN_ERROR_INITIALIZE;
@@ -300,15 +338,8 @@ bool CANCommunication::sendRequest(ArmType arm) {
     }
     locker.unlock();
 
-    // 发送请求
-    QString armName;
-    if (arm == LeftArm) armName = "左臂";
-    else if (arm == RightArm) armName = "右臂";
-    else armName = "双臂";
-
-    emit logMessage(QString("发送%1位置请求 (ID=0x%2)")
-                   .arg(armName)
-                   .arg(requestId, 2, 16, QChar('0')), "info");
+    // 发送请求（轮询时每个周期都会调用，这里不做字符串格式化）
+    emit frameSent(frame);
 
     return m_worker->sendFrame(frame);
 }
@@ -323,6 +354,7 @@ bool CANCommunication::sendCalibrate() {
 
     emit logMessage(QString("发送标定命令 (ID=0x%1)")
                    .arg(CANProtocol::CAN_ID_CALIBRATE, 2, 16, QChar('0')), "info");
+    emit frameSent(frame);
 
     return m_worker->sendFrame(frame);
 }
@@ -337,6 +369,7 @@ bool CANCommunication::sendGetVersion() {
 
     emit logMessage(QString("发送获取版本命令 (ID=0x%1)")
                    .arg(CANProtocol::CAN_ID_GET_VERSION, 2, 16, QChar('0')), "info");
+    emit frameSent(frame);
 
     return m_worker->sendFrame(frame);
 }
@@ -351,10 +384,17 @@ bool CANCommunication::sendCustomMessage(quint16 id, const QByteArray &data) {
                    .arg(id, 2, 16, QChar('0'))
                    .arg(QString(data.toHex(' '))), "info");
 
-    return m_worker->sendFrame(CANDataFrame(id, data));
+    CANDataFrame frame(id, data);
+    emit frameSent(frame);
+
+    return m_worker->sendFrame(frame);
 }
 
 void CANCommunication::onFrameReceived(const CANDataFrame &frame) {
+    m_lastDequeueUs = AcqClock::nowUs();
+    TRACE_SCOPE_ARG(CanReassembly, frame.id);
+    emit frameReceived(frame);
+
     QMutexLocker locker(&m_cacheMutex);
 
     // 根据CAN ID处理不同类型的数据
@@ -417,7 +457,7 @@ void CANCommunication::onFrameReceived(const CANDataFrame &frame) {
             // 检查是否完整
             if (m_dataCache.isLeftComplete()) {
                 QVector<float> armData = m_dataCache.getLeftArmData();
-                emit leftArmDataReceived(armData);
+                emit leftArmDataReceived(armData, frame.timestampUs);
                 m_dataCache.clearLeft();
             }
         }
@@ -433,7 +473,7 @@ void CANCommunication::onFrameReceived(const CANDataFrame &frame) {
             
             if (m_dataCache.isLeftComplete()) {
                 QVector<float> armData = m_dataCache.getLeftArmData();
-                emit leftArmDataReceived(armData);
+                emit leftArmDataReceived(armData, frame.timestampUs);
                 m_dataCache.clearLeft();
             }
         }
@@ -449,7 +489,7 @@ void CANCommunication::onFrameReceived(const CANDataFrame &frame) {
 
             if (m_dataCache.isRightComplete()) {
                 QVector<float> armData = m_dataCache.getRightArmData();
-                emit rightArmDataReceived(armData);
+                emit rightArmDataReceived(armData, frame.timestampUs);
                 m_dataCache.clearRight();
             }
         }
@@ -465,7 +505,7 @@ void CANCommunication::onFrameReceived(const CANDataFrame &frame) {
 
             if (m_dataCache.isRightComplete()) {
                 QVector<float> armData = m_dataCache.getRightArmData();
-                emit rightArmDataReceived(armData);
+                emit rightArmDataReceived(armData, frame.timestampUs);
                 m_dataCache.clearRight();
             }
         }
@@ -63,10 +63,15 @@ private:
     TPCANHandle m_handle;
     unsigned int m_baudrate;
 
+    // 硬件时间戳 -> 主机单调时钟的偏移（首帧对齐，偏差过大时重新对齐）
+    qint64 m_hwClockOffsetUs = 0;
+    bool m_hwClockSynced = false;
+    qint64 hardwareToHostUs(qint64 hardwareUs);
+
     // PCAN API调用（需要在实现文件中动态加载或链接）
     TPCANStatus initializeCAN(TPCANHandle handle, unsigned int baudrate);
     TPCANStatus uninitializeCAN(TPCANHandle handle);
-    TPCANStatus readCAN(TPCANHandle handle, QByteArray &data, quint16 &id);
+    TPCANStatus readCAN(TPCANHandle handle, QByteArray &data, quint16 &id, qint64 &timestampUs);
     TPCANStatus writeCAN(TPCANHandle handle, quint16 id, const QByteArray &data);
 };
 
@@ -105,14 +110,22 @@ public:
     // 获取数据缓存（用于同步模式）
     const CANArmDataCache& dataCache() const { return m_dataCache; }
 
+    // 最近一帧在本对象所在线程开始处理的时间（AcqClock），用于统计排队延迟
+    qint64 lastDequeueUs() const { return m_lastDequeueUs; }
+
 signals:
     void statusChanged(int status);
-    void leftArmDataReceived(const QVector<float> &data);
-    void rightArmDataReceived(const QVector<float> &data);
+    // timestampUs：组成该臂数据的最后一个分片的接收时间（AcqClock）
+    void leftArmDataReceived(const QVector<float> &data, qint64 timestampUs);
+    void rightArmDataReceived(const QVector<float> &data, qint64 timestampUs);
     void versionReceived(const QString &version);
     void calibrationResultReceived(bool success);
     void errorOccurred(const QString &error);
     void logMessage(const QString &message, const QString &type = "info");
+    // 高频发送（轮询请求）不格式化文本，由接收方按需记录
+    void frameSent(const CANDataFrame &frame);
+    // 收到的每一帧原始数据（解码之前，用于录制）
+    void frameReceived(const CANDataFrame &frame);
 
 public slots:
     void onFrameReceived(const CANDataFrame &frame);
@@ -122,6 +135,7 @@ private:
     CANWorkerThread *m_worker;
     CANArmDataCache m_dataCache;
     QMutex m_cacheMutex;
+    qint64 m_lastDequeueUs = 0;
 
     // 通道名称转换
     TPCANHandle channelToHandle(const QString &channel);
@@ -31,13 +31,15 @@ namespace CANProtocol {
 struct CANDataFrame {
     quint16 id;
     QByteArray data;  // 最多8字节
+    qint64 timestampUs = 0; // 接收时间（AcqClock 单调时钟，微秒；有硬件时间戳时由其换算）
 
     CANDataFrame() : id(0) {
         data.resize(CANProtocol::CAN_MAX_DATA_LENGTH);
         data.fill(0);
     }
 
-    CANDataFrame(quint16 id, const QByteArray &data) : id(id), data(data) {}
+    CANDataFrame(quint16 id, const QByteArray &data, qint64 timestampUs = 0)
+        : id(id), data(data), timestampUs(timestampUs) {}
 };
 
 // CAN臂数据缓存（用于组合分帧）
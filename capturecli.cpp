@@ -0,0 +1,688 @@
+#include "capturecli.h"
+#include "seriallink.h"
+#include "sessionformat.h"
+#include "sessionrecorder.h"
+#include "sessionreplayer.h"
+#include "armstreampublisher.h"
+#include "serialdevicemanager.h"
+#include "archivewriter.h"
+#include "archivereader.h"
+#include "acqclock.h"
+#include "trace.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QVector>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+CaptureCli::CaptureCli(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_pollTimer(new QTimer(this))
+    , m_flushTimer(new QTimer(this))
+{
+    m_pollTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_flushTimer, &QTimer::timeout, this, &CaptureCli::flushOutput);
+}
+
+CaptureCli::~CaptureCli()
+{
+    stop();
+    delete m_archive;
+}
+
+void CaptureCli::printError(const QString &message)
+{
+    std::fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+}
+
+bool CaptureCli::start()
+{
+    if (!openOutput()) return false;
+
+    if (multiDevice() && !m_options.shmName.isEmpty()) {
+        printError("多串口采集不支持 --shm");
+        return false;
+    }
+    // 多串口时每个设备单独录制（见 startSerialDevices）
+    if (!m_options.recordPath.isEmpty() && !multiDevice()) {
+        m_recorder = new SessionRecorder(this);
+        connect(m_recorder, &SessionRecorder::errorOccurred, this, &CaptureCli::printError);
+        if (!m_recorder->open(m_options.recordPath)) return false;
+    }
+
+    if (!m_options.shmName.isEmpty() && !m_shm.open(m_options.shmName.toLocal8Bit().constData())) {
+        printError(QString("无法创建共享内存 %1: %2")
+                       .arg(m_options.shmName, QString::fromStdString(m_shm.errorString())));
+        return false;
+    }
+
+    if (!m_options.streamTargets.isEmpty()) {
+        m_stream = new ArmStreamPublisher(this);
+        connect(m_stream, &ArmStreamPublisher::errorOccurred, this, &CaptureCli::printError);
+        if (!m_stream->open(m_options.streamTargets, m_options.streamLatencyBudgetUs, m_options.streamBatchSamples)) {
+            return false;
+        }
+    }
+
+    m_filters.resize(2 * qMax(1, m_options.serialPorts.size()));
+    if (!applyFilterSpec(m_options.filterSpec)) return false;
+    if (!m_options.kinematicsPath.isEmpty()) {
+        ArmKinematics::Config left;
+        ArmKinematics::Config right;
+        QString error;
+        if (!ArmKinematics::loadFile(m_options.kinematicsPath, left, right, &error)
+            || !m_kinematics[0].setConfig(left, &error) || !m_kinematics[1].setConfig(right, &error)) {
+            printError(QString("运动学参数无效: %1").arg(error));
+            return false;
+        }
+    }
+    if (!m_options.tracePath.isEmpty()) {
+        Trace::setEnabled(true);
+    }
+    m_fusion.setMode(m_options.fusionMode);
+    if (!m_options.archivePath.isEmpty() && !openArchive()) return false;
+
+    m_stats.reset(AcqClock::nowUs());
+
+    bool ok = false;
+    if (!m_options.archiveExportPath.isEmpty()) {
+        ok = startArchiveExport();
+    } else if (!m_options.replayPath.isEmpty()) {
+        ok = startReplay();
+    } else if (multiDevice()) {
+        ok = startSerialDevices();
+    } else if (!m_options.serialPorts.isEmpty()) {
+        ok = startSerial();
+    } else if (!m_options.canChannel.isEmpty()) {
+        ok = startCan();
+    } else {
+        printError("未指定数据源（--serial / --can / --replay / --archive-export）");
+    }
+    if (!ok) return false;
+
+    m_flushTimer->start(OUTPUT_FLUSH_MS);
+    if (m_options.durationMs > 0) {
+        QTimer::singleShot(m_options.durationMs, this, &CaptureCli::stop);
+    }
+    return true;
+}
+
+bool CaptureCli::openOutput()
+{
+    bool opened;
+    if (m_options.outputPath.isEmpty() || m_options.outputPath == "-") {
+        opened = m_output.open(stdout, QIODevice::WriteOnly);
+    } else {
+        m_output.setFileName(m_options.outputPath);
+        opened = m_output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!opened) {
+        printError(QString("无法打开输出: %1").arg(m_output.errorString()));
+        return false;
+    }
+
+    m_outputBuffer.reserve(OUTPUT_FLUSH_BYTES * 2);
+    if (m_options.binaryOutput) {
+        SessionFormat::FileHeader header;
+        std::memcpy(header.magic, SessionFormat::MAGIC, sizeof(header.magic));
+        header.version = SessionFormat::VERSION;
+        header.headerSize = sizeof(SessionFormat::FileHeader);
+        header.startTimestampUs = AcqClock::nowUs();
+        header.startEpochMs = AcqClock::toEpochMs(header.startTimestampUs);
+        m_outputBuffer.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    } else {
+        // 每行的值个数随 arm 而定（both 为 14 个关节角，left/right 和位姿为 7 个）：
+        // 只有确定每行都是 14 个关节角（串口采集、不输出位姿）时才写 j0..j13，否则写通用的 values 列
+        m_outputBuffer.append(multiDevice() ? "timestamp_us,device,arm" : "timestamp_us,arm");
+        const bool exporting = !m_options.archiveExportPath.isEmpty();
+        const bool bothArmsOnly = !m_options.serialPorts.isEmpty() && !exporting && m_options.replayPath.isEmpty()
+                                  && m_options.kinematicsPath.isEmpty();
+        if (exporting && m_options.archiveChannel >= 0) {
+            m_outputBuffer.append(QString(",j%1\n").arg(m_options.archiveChannel).toLatin1());
+        } else if (bothArmsOnly) {
+            m_outputBuffer.append(",j0,j1,j2,j3,j4,j5,j6,j7,j8,j9,j10,j11,j12,j13\n");
+        } else {
+            m_outputBuffer.append(",values...\n");
+        }
+    }
+    return true;
+}
+
+bool CaptureCli::startSerial()
+{
+    m_serial = new SerialLink(this);
+    QSerialPort *port = m_serial->port();
+    port->setPortName(m_options.serialPorts.first());
+    port->setBaudRate(m_options.baudRate);
+    port->setDataBits(QSerialPort::Data8);
+    port->setParity(QSerialPort::NoParity);
+    port->setStopBits(QSerialPort::OneStop);
+    port->setFlowControl(QSerialPort::NoFlowControl);
+    if (!m_serial->open(m_options.lowLatencySerial ? SerialLink::LowLatencyBackend : SerialLink::QtBackend)) {
+        printError(QString("无法打开串口 %1: %2").arg(m_options.serialPorts.first(), m_serial->errorString()));
+        return false;
+    }
+
+    connect(m_serial, &SerialLink::frameReceived, this, &CaptureCli::onSerialFrame);
+    if (m_recorder) {
+        connect(m_serial, &SerialLink::bytesReceived, this, [this](const QByteArray &data, qint64 ts) {
+            m_recorder->recordSerialBytes(ts, false, data);
+        });
+        connect(m_serial, &SerialLink::bytesSent, this, [this](const QByteArray &data, qint64 ts) {
+            m_recorder->recordSerialBytes(ts, true, data);
+        });
+    }
+    connect(port, &QSerialPort::errorOccurred, this, [this, port](QSerialPort::SerialPortError error) {
+        if (error == QSerialPort::NoError) return;
+        printError("串口错误: " + port->errorString());
+        if (error == QSerialPort::ResourceError) {
+            stop();
+        }
+    });
+    connect(m_serial, &SerialLink::errorOccurred, this, [this](const QString &error) {
+        printError("串口错误: " + error);
+        stop();
+    });
+
+    // 开启下位机数据推送
+    m_serial->write(SerialProtocol::buildEnableDataStreamCommand());
+    return true;
+}
+
+bool CaptureCli::startSerialDevices()
+{
+    m_devices = new SerialDeviceManager(this);
+    m_devices->setWorkerCount(m_options.serialWorkers);
+    const QFileInfo recordInfo(m_options.recordPath);
+    for (const QString &portName : m_options.serialPorts) {
+        SerialDeviceManager::DeviceConfig config;
+        config.name = QFileInfo(portName).fileName();
+        config.portName = portName;
+        config.baudRate = m_options.baudRate;
+        config.backend = m_options.lowLatencySerial ? SerialLink::LowLatencyBackend : SerialLink::QtBackend;
+        // session.ltarec -> session_ttyUSB0.ltarec
+        if (!m_options.recordPath.isEmpty()) {
+            config.recordPath = recordInfo.dir().filePath(
+                QString("%1_%2.%3").arg(recordInfo.completeBaseName(), config.name, recordInfo.suffix()));
+        }
+        m_devices->addDevice(config);
+        m_deviceNames.append(config.name.toLocal8Bit());
+    }
+
+    connect(m_devices, &SerialDeviceManager::armSampleReceived, this,
+            [this](int device, const QVector<float> &joints, qint64 timestampUs) {
+        writeSample(SessionFormat::deviceArmId(device, SessionFormat::BothArms),
+                    joints.constData(), joints.size(), timestampUs, false);
+    });
+    connect(m_devices, &SerialDeviceManager::deviceError, this, [this](int device, const QString &error) {
+        printError(QString("%1: %2").arg(m_devices->deviceName(device), error));
+    });
+
+    QString error;
+    if (!m_devices->start(&error)) {
+        printError(error);
+        return false;
+    }
+    std::fprintf(stderr, "%d serial devices on %d worker threads\n", m_devices->deviceCount(), m_devices->workerCount());
+    return true;
+}
+
+bool CaptureCli::startCan()
+{
+    m_can = new CANCommunication(this);
+    connectCanSignals();
+    connect(m_can, &CANCommunication::errorOccurred, this, &CaptureCli::printError);
+    connect(m_can, &CANCommunication::statusChanged, this, [this](int status) {
+        if (status == CANCommunication::Connected) {
+            m_pollTimer->start(m_options.pollIntervalMs);
+        } else {
+            m_pollTimer->stop();
+        }
+    });
+    connect(m_pollTimer, &QTimer::timeout, this, [this]() {
+        if (m_options.fuseArms && m_options.canArm == CANCommunication::BothArms) {
+            DualArmFusion::Sample fused;
+            if (m_fusion.beginCycle(AcqClock::nowUs(), fused)) {
+                writeFused(fused);
+            }
+        }
+        m_can->sendRequest(m_options.canArm);
+    });
+    if (m_recorder) {
+        connect(m_can, &CANCommunication::frameSent, this, [this](const CANDataFrame &frame) {
+            m_recorder->recordCanFrame(AcqClock::nowUs(), true, frame.id, frame.data);
+        });
+    }
+    return m_can->connect(m_options.canChannel, m_options.canBitrate);
+}
+
+bool CaptureCli::startReplay()
+{
+    m_replayer = new SessionReplayer(this);
+    connect(m_replayer, &SessionReplayer::errorOccurred, this, &CaptureCli::printError);
+    if (!m_replayer->open(m_options.replayPath)) return false;
+
+    // 回放数据走与实时采集相同的拆帧/重组流程，但不打开任何设备
+    m_serial = new SerialLink(this);
+    connect(m_serial, &SerialLink::frameReceived, this, &CaptureCli::onSerialFrame);
+    connect(m_replayer, &SessionReplayer::serialBytes, m_serial, &SerialLink::feed);
+
+    m_can = new CANCommunication(this);
+    connectCanSignals();
+    connect(m_replayer, &SessionReplayer::canFrame, m_can, &CANCommunication::onFrameReceived);
+
+    connect(m_replayer, &SessionReplayer::finished, this, &CaptureCli::stop);
+    m_replayer->start(m_options.replaySpeed);
+    return true;
+}
+
+bool CaptureCli::openArchive()
+{
+    double resolution = m_options.archiveResolution;
+    if (resolution <= 0.0) {
+        // CAN 关节角为 int16 / 10，原样输出时 0.1° 无损；滤波、外推融合（插值结果不在 0.1° 网格上）
+        // 或串口 float 数据保留到 0.001°
+        const bool extrapolating = m_options.fuseArms && m_options.fusionMode == DualArmFusion::Extrapolate;
+        const bool canRaw = !m_options.canChannel.isEmpty() && !m_filters.first().isActive() && !extrapolating;
+        resolution = canRaw ? 0.1 : 0.001;
+    }
+    m_archive = new ArchiveWriter;
+    if (!m_archive->open(m_options.archivePath, resolution)) {
+        printError(m_archive->errorString());
+        return false;
+    }
+    return true;
+}
+
+bool CaptureCli::startArchiveExport()
+{
+    ArchiveReader reader;
+    if (!reader.open(m_options.archiveExportPath)) {
+        printError(reader.errorString());
+        return false;
+    }
+    if (reader.recovered()) {
+        printError("归档文件没有索引（采集未正常结束），已按块扫描恢复");
+    }
+
+    const qint64 fromUs = reader.startTimestampUs() + m_options.archiveFromUs;
+    const qint64 toUs = m_options.archiveToUs > 0 ? reader.startTimestampUs() + m_options.archiveToUs
+                                                  : std::numeric_limits<qint64>::max();
+    const int selected = m_options.archiveChannel;
+
+    // 按臂数据流依次输出；每块只解码需要的列
+    QVector<qint64> timestamps;
+    QVector<QVector<float>> columns(ArchiveFormat::MAX_CHANNELS);
+    float values[ArchiveFormat::MAX_CHANNELS];
+    for (const quint16 armId : reader.armIds()) {
+        for (int chunk = reader.findChunk(armId, fromUs); chunk >= 0 && reader.chunk(chunk).firstTimestampUs <= toUs;
+             chunk = reader.nextChunk(chunk)) {
+            const int channels = reader.chunk(chunk).channelCount;
+            bool ok = reader.readTimestamps(chunk, timestamps);
+            for (int ch = 0; ch < channels && ok; ++ch) {
+                if (selected < 0 || ch == selected) ok = reader.readChannel(chunk, ch, columns[ch]);
+            }
+            if (!ok) {
+                printError(QString("归档数据块 %1 损坏，已跳过").arg(chunk));
+                continue;
+            }
+            if (selected >= channels) continue;
+
+            for (int i = 0; i < timestamps.size(); ++i) {
+                if (timestamps[i] < fromUs || timestamps[i] > toUs) continue;
+                if (selected >= 0) {
+                    outputSample(armId, &columns[selected][i], 1, timestamps[i]);
+                    continue;
+                }
+                for (int ch = 0; ch < channels; ++ch) {
+                    values[ch] = columns[ch][i];
+                }
+                outputSample(armId, values, channels, timestamps[i]);
+            }
+        }
+    }
+
+    // 导出在启动时同步完成
+    QTimer::singleShot(0, this, &CaptureCli::stop);
+    return true;
+}
+
+void CaptureCli::connectCanSignals()
+{
+    connect(m_can, &CANCommunication::leftArmDataReceived, this, [this](const QVector<float> &data, qint64 ts) {
+        if (m_options.fuseArms) {
+            fuseSample(0, data, ts);
+        } else {
+            writeSample(SessionFormat::LeftArm, data.constData(), data.size(), ts);
+        }
+    });
+    connect(m_can, &CANCommunication::rightArmDataReceived, this, [this](const QVector<float> &data, qint64 ts) {
+        if (m_options.fuseArms) {
+            fuseSample(1, data, ts);
+        } else {
+            writeSample(SessionFormat::RightArm, data.constData(), data.size(), ts);
+        }
+    });
+    if (m_recorder) {
+        connect(m_can, &CANCommunication::frameReceived, this, [this](const CANDataFrame &frame) {
+            m_recorder->recordCanFrame(frame.timestampUs, false, frame.id, frame.data);
+        });
+    }
+}
+
+void CaptureCli::onSerialFrame(const SerialProtocol::Frame &frame, qint64 timestampUs)
+{
+    // 只处理 56 字节的推送数据，其余为命令响应
+    if (frame.dataLength != 56) return;
+
+    QVector<float> armData;
+    if (SerialProtocol::parseArmData(frame.data, armData) && armData.size() == 14) {
+        writeSample(SessionFormat::BothArms, armData.constData(), armData.size(), timestampUs);
+    }
+}
+
+bool CaptureCli::applyFilterSpec(const QString &spec)
+{
+    JointFilter::JointConfig config;
+    int medianWindow = 1;
+    for (const QString &item : spec.split(',')) {
+        const QStringList parts = item.trimmed().split(':');
+        const QString name = parts.first().toLower();
+        bool ok = true;
+        if (name.isEmpty() || name == "none") {
+            continue;
+        } else if (name == "lowpass" && parts.size() == 2) {
+            config.smoothing = JointFilter::LowPass;
+            config.cutoffHz = parts[1].toFloat(&ok);
+            ok = ok && config.cutoffHz > 0.0f;
+        } else if (name == "median" && parts.size() == 2) {
+            medianWindow = parts[1].toInt(&ok);
+            ok = ok && medianWindow >= 1 && medianWindow <= JointFilter::MAX_MEDIAN_WINDOW && medianWindow % 2 == 1;
+            config.median = true;
+        } else if (name == "oneeuro" && (parts.size() == 2 || parts.size() == 3)) {
+            config.smoothing = JointFilter::OneEuro;
+            config.minCutoffHz = parts[1].toFloat(&ok);
+            ok = ok && config.minCutoffHz > 0.0f;
+            if (ok && parts.size() == 3) {
+                config.beta = parts[2].toFloat(&ok);
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printError(QString("滤波配置无效: %1").arg(item));
+            return false;
+        }
+    }
+
+    for (JointFilter &filter : m_filters) {
+        filter.setAllJoints(config);
+        filter.setMedianWindow(medianWindow);
+    }
+    return true;
+}
+
+void CaptureCli::fuseSample(int arm, const QVector<float> &data, qint64 timestampUs)
+{
+    if (m_stopped || data.size() != DualArmFusion::JOINTS_PER_ARM) return;
+
+    // 录制原始分臂数据，输出融合后的双臂样本
+    if (m_recorder) {
+        m_recorder->recordArmSample(timestampUs, arm == 0 ? SessionFormat::LeftArm : SessionFormat::RightArm,
+                                    data.constData(), data.size());
+    }
+    TRACE_SCOPE_ARG(ArmFusion, arm);
+    DualArmFusion::Sample fused;
+    const bool ready = arm == 0 ? m_fusion.addLeft(timestampUs, data.constData(), fused)
+                                : m_fusion.addRight(timestampUs, data.constData(), fused);
+    if (!ready) return;
+    m_maxFusionSkewUs = qMax(m_maxFusionSkewUs, qAbs(fused.skewUs));
+    m_maxFusionAgeUs = qMax(m_maxFusionAgeUs, fused.ageUs);
+    writeFused(fused);
+}
+
+void CaptureCli::writeFused(const DualArmFusion::Sample &fused)
+{
+    // 另一半还没到过（或已超时）时，补齐的值是 0 或过期数据，不能当作双臂样本输出
+    switch (fused.validMask) {
+    case DualArmFusion::LeftArmBit | DualArmFusion::RightArmBit:
+        writeSample(SessionFormat::BothArms, fused.joints, DualArmFusion::JOINT_COUNT, fused.timestampUs, false);
+        break;
+    case DualArmFusion::LeftArmBit:
+        writeSample(SessionFormat::LeftArm, fused.joints, DualArmFusion::JOINTS_PER_ARM, fused.timestampUs, false);
+        break;
+    case DualArmFusion::RightArmBit:
+        writeSample(SessionFormat::RightArm, fused.joints + DualArmFusion::JOINTS_PER_ARM,
+                    DualArmFusion::JOINTS_PER_ARM, fused.timestampUs, false);
+        break;
+    default:
+        break;
+    }
+}
+
+void CaptureCli::writeSample(quint16 armId, const float *values, int count, qint64 timestampUs, bool record)
+{
+    if (m_stopped) return;
+    TRACE_SCOPE_ARG(ArmProcess, armId);
+
+    m_stats.addSample(timestampUs);
+    if (m_recorder && record) {
+        m_recorder->recordArmSample(timestampUs, armId, values, count);
+    }
+
+    // 多串口时 armId 高位为设备序号
+    const int device = armId >> SessionFormat::DEVICE_SHIFT;
+    const quint16 arm = armId & ((1 << SessionFormat::DEVICE_SHIFT) - 1);
+
+    // 滤波在录制之后，输出/共享内存/推送使用滤波后的值
+    float filtered[14];
+    JointFilter *filters = m_filters.data() + 2 * device;
+    if (filters[0].isActive() && count <= 14) {
+        TRACE_SCOPE(ArmFilter);
+        if (arm == SessionFormat::BothArms && count == 14) {
+            filters[0].process(timestampUs, values, filtered);
+            filters[1].process(timestampUs, values + 7, filtered + 7);
+            values = filtered;
+        } else if ((arm == SessionFormat::LeftArm || arm == SessionFormat::RightArm) && count == 7) {
+            filters[arm == SessionFormat::LeftArm ? 0 : 1].process(timestampUs, values, filtered);
+            values = filtered;
+        }
+    }
+    outputSample(armId, values, count, timestampUs);
+
+    if (m_kinematics[0].isValid()) {
+        if (arm == SessionFormat::BothArms && count == 14) {
+            outputPose(device, 0, values, timestampUs);
+            outputPose(device, 1, values + 7, timestampUs);
+        } else if ((arm == SessionFormat::LeftArm || arm == SessionFormat::RightArm) && count == 7) {
+            outputPose(device, arm, values, timestampUs);
+        }
+    }
+}
+
+void CaptureCli::outputPose(int device, int arm, const float *joints, qint64 timestampUs)
+{
+    ArmKinematics::Pose pose;
+    {
+        TRACE_SCOPE_ARG(ForwardKinematics, arm);
+        m_kinematics[arm].compute(joints, pose);
+    }
+    float values[SessionFormat::POSE_VALUES];
+    std::memcpy(values, pose.position, sizeof(pose.position));
+    std::memcpy(values + 3, pose.quaternion, sizeof(pose.quaternion));
+    outputSample(SessionFormat::deviceArmId(device, arm == 0 ? SessionFormat::LeftPose : SessionFormat::RightPose),
+                 values, SessionFormat::POSE_VALUES, timestampUs);
+}
+
+void CaptureCli::outputSample(quint16 armId, const float *values, int count, qint64 timestampUs)
+{
+    const int device = armId >> SessionFormat::DEVICE_SHIFT;
+    const quint16 arm = armId & ((1 << SessionFormat::DEVICE_SHIFT) - 1);
+
+    // 共享内存和归档只有关节角
+    if (m_shm.isOpen() && arm <= SessionFormat::BothArms) {
+        publishSample(armId, values, count, timestampUs);
+    }
+    if (m_archive && arm <= SessionFormat::BothArms && !m_archive->append(timestampUs, armId, values, count)) {
+        printError(m_archive->errorString());
+        delete m_archive;
+        m_archive = nullptr;
+    }
+    if (m_stream) {
+        m_stream->publish(timestampUs, armId, values, count);
+    }
+
+    if (m_options.binaryOutput) {
+        SessionFormat::RecordHeader header;
+        header.timestampUs = timestampUs;
+        header.type = SessionFormat::ArmSample;
+        header.flags = 0;
+        header.id = armId;
+        header.size = static_cast<quint32>(count * sizeof(float));
+        const int padding = static_cast<int>(SessionFormat::recordSize(header.size) - sizeof(header) - header.size);
+        m_outputBuffer.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        m_outputBuffer.append(reinterpret_cast<const char *>(values), static_cast<int>(header.size));
+        static const char zeros[8] = {};
+        m_outputBuffer.append(zeros, padding);
+    } else {
+        static const char *const armNames[] = {"left", "right", "both", "left_pose", "right_pose"};
+        char line[512];
+        int len = std::snprintf(line, sizeof(line), "%lld", static_cast<long long>(timestampUs));
+        if (m_devices) {
+            len += std::snprintf(line + len, sizeof(line) - len, ",%s", m_deviceNames[device].constData());
+        }
+        len += std::snprintf(line + len, sizeof(line) - len, ",%s", armNames[qMin<int>(arm, SessionFormat::RightPose)]);
+        for (int i = 0; i < count && len < static_cast<int>(sizeof(line)) - 16; ++i) {
+            len += std::snprintf(line + len, sizeof(line) - len, ",%.3f", values[i]);
+        }
+        len = qMin(len, static_cast<int>(sizeof(line)) - 2);
+        line[len++] = '\n';
+        m_outputBuffer.append(line, len);
+    }
+
+    if (m_outputBuffer.size() >= OUTPUT_FLUSH_BYTES) {
+        flushOutput();
+    }
+}
+
+void CaptureCli::publishSample(quint16 armId, const float *values, int count, qint64 timestampUs)
+{
+    // CAN 模式左右臂分别到达，合并到同一份 14 关节状态后整体发布
+    int first = 0;
+    quint32 validBits = ArmStateShm::LeftArmValid | ArmStateShm::RightArmValid;
+    if (armId == SessionFormat::LeftArm) {
+        validBits = ArmStateShm::LeftArmValid;
+    } else if (armId == SessionFormat::RightArm) {
+        first = 7;
+        validBits = ArmStateShm::RightArmValid;
+    }
+    count = qMin(count, ArmStateShm::JOINT_COUNT - first);
+    std::memcpy(m_latestJoints + first, values, count * sizeof(float));
+    m_latestValidMask |= validBits;
+    m_shm.publish(timestampUs, m_latestJoints, m_latestValidMask);
+}
+
+void CaptureCli::flushOutput()
+{
+    if (m_outputBuffer.isEmpty() || !m_output.isOpen()) return;
+    m_output.write(m_outputBuffer);
+    m_output.flush();
+    m_outputBuffer.clear();
+}
+
+void CaptureCli::stop()
+{
+    if (m_stopped) return;
+    m_stopped = true;
+
+    m_pollTimer->stop();
+    m_flushTimer->stop();
+    if (m_replayer) {
+        m_replayer->stop();
+    }
+    if (m_serial && m_serial->isOpen()) {
+        m_serial->write(SerialProtocol::buildDisableDataStreamCommand());
+        m_serial->close();
+    }
+    if (m_can && m_can->isConnected()) {
+        m_can->disconnect();
+    }
+    if (m_recorder) {
+        m_recorder->close();
+    }
+    if (m_devices) {
+        m_devices->stop();
+        for (int i = 0; i < m_devices->deviceCount(); ++i) {
+            const SerialDeviceManager::DeviceStatus status = m_devices->status(i);
+            std::fprintf(stderr, "%s (worker %d): samples %llu, %.2f Hz, interval p99/max %.3f/%.3f ms, gaps %llu, "
+                         "invalid frames %llu, recorded %llu, dropped %llu\n",
+                         status.name.toLocal8Bit().constData(), status.worker,
+                         static_cast<unsigned long long>(status.samples.count), status.samples.meanRateHz,
+                         status.samples.p99IntervalUs / 1000.0, status.samples.maxIntervalUs / 1000.0,
+                         static_cast<unsigned long long>(status.samples.gapCount),
+                         static_cast<unsigned long long>(status.invalidFrames),
+                         static_cast<unsigned long long>(status.recordedRecords),
+                         static_cast<unsigned long long>(status.droppedRecords));
+        }
+    }
+    if (!m_options.tracePath.isEmpty()) {
+        Trace::setEnabled(false);
+        QString error;
+        if (Trace::writeChromeTrace(m_options.tracePath, &error)) {
+            std::fprintf(stderr, "trace written: %s\n", m_options.tracePath.toLocal8Bit().constData());
+        } else {
+            printError(error);
+        }
+    }
+    if (m_options.fuseArms) {
+        std::fprintf(stderr, "fused: paired %llu, filled %llu, max skew %lld us, max age %lld us\n",
+                     static_cast<unsigned long long>(m_fusion.pairedCount()),
+                     static_cast<unsigned long long>(m_fusion.filledCount()),
+                     static_cast<long long>(m_maxFusionSkewUs), static_cast<long long>(m_maxFusionAgeUs));
+    }
+    if (m_stream) {
+        m_stream->close();
+        std::fprintf(stderr, "stream published: %llu, queue dropped: %llu\n",
+                     static_cast<unsigned long long>(m_stream->publishedSamples()),
+                     static_cast<unsigned long long>(m_stream->queueDroppedSamples()));
+        for (const ArmStreamPublisher::ConsumerStats &consumer : m_stream->consumerStats()) {
+            std::fprintf(stderr, "  %s: datagrams sent %llu, dropped %llu (%llu samples)\n",
+                         consumer.address.toLocal8Bit().constData(),
+                         static_cast<unsigned long long>(consumer.datagramsSent),
+                         static_cast<unsigned long long>(consumer.datagramsDropped),
+                         static_cast<unsigned long long>(consumer.samplesDropped));
+        }
+    }
+    if (m_shm.isOpen()) {
+        std::fprintf(stderr, "shm published: %llu\n", static_cast<unsigned long long>(m_shm.publishedCount()));
+        m_shm.close();
+    }
+    if (m_archive) {
+        if (!m_archive->close()) {
+            printError(m_archive->errorString());
+        }
+        std::fprintf(stderr, "archived: %llu samples, %llu bytes (%.1fx smaller than records)\n",
+                     static_cast<unsigned long long>(m_archive->samplesWritten()),
+                     static_cast<unsigned long long>(m_archive->bytesWritten()),
+                     m_archive->bytesWritten() > 0 ? double(m_archive->rawBytes()) / m_archive->bytesWritten() : 0.0);
+    }
+
+    flushOutput();
+    m_output.close();
+
+    const StreamStats::Snapshot s = m_stats.snapshot(AcqClock::nowUs());
+    std::fprintf(stderr, "samples: %llu, mean rate: %.2f Hz, interval p50/p99/max: %.3f/%.3f/%.3f ms, gaps: %llu\n",
+                 static_cast<unsigned long long>(s.count), s.meanRateHz,
+                 s.p50IntervalUs / 1000.0, s.p99IntervalUs / 1000.0, s.maxIntervalUs / 1000.0,
+                 static_cast<unsigned long long>(s.gapCount));
+    if (m_recorder) {
+        std::fprintf(stderr, "recorded: %llu records, dropped: %llu\n",
+                     static_cast<unsigned long long>(m_recorder->recordsWritten()),
+                     static_cast<unsigned long long>(m_recorder->droppedRecords()));
+    }
+
+    QCoreApplication::exit(0);
+}
@@ -0,0 +1,128 @@
+#ifndef CAPTURECLI_H
+#define CAPTURECLI_H
+
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include "cancommunication.h"
+#include "serialprotocol.h"
+#include "streamstats.h"
+#include "armstateshm.h"
+#include "jointfilter.h"
+#include "dualarmfusion.h"
+#include "armkinematics.h"
+
+class SerialLink;
+class SessionRecorder;
+class SessionReplayer;
+class ArmStreamPublisher;
+class SerialDeviceManager;
+class ArchiveWriter;
+
+// 无界面采集：连接串口或 CAN（或回放录制文件），把臂数据以 CSV 或二进制记录写到文件/标准输出。
+// 只依赖核心库（QtCore + QtSerialPort），可在没有图形环境的控制机上运行。
+class CaptureCli : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        QStringList serialPorts;        // 串口名（与 canChannel/replayPath 三选一），多个时同时采集
+        int serialWorkers = 0;          // 多串口时的工作线程数，0 为自动
+        qint32 baudRate = 2000000;
+        bool lowLatencySerial = false;  // Linux 原始 tty 后端（见 rawserialport.h）
+        QString canChannel;             // 如 PCAN_USBBUS1
+        quint32 canBitrate = 1000000;
+        int pollIntervalMs = 1;         // CAN 轮询间隔
+        CANCommunication::ArmType canArm = CANCommunication::BothArms;
+        QString replayPath;             // 回放录制文件
+        QString archiveExportPath;      // 把列式归档（archiveformat.h）导出到输出，作为数据源
+        int archiveChannel = -1;        // 导出时只解码该通道，< 0 为全部
+        qint64 archiveFromUs = 0;       // 导出的时间范围（相对归档开始），toUs <= 0 为到结尾
+        qint64 archiveToUs = 0;
+        double replaySpeed = 1.0;       // <= 0 为尽可能快
+        QString outputPath = "-";       // "-" 表示标准输出
+        bool binaryOutput = false;      // 二进制记录（sessionformat.h）或 CSV
+        QString recordPath;             // 同时录制原始帧
+        QString archivePath;            // 同时把输出的关节角写成列式归档
+        double archiveResolution = 0.0; // 归档量化步长（°），<= 0 为自动：未滤波的 CAN 为 0.1，其余 0.001
+        int durationMs = 0;             // > 0 时采集指定时长后退出
+        QString shmName;                // 非空时把最新臂状态发布到该共享内存
+        QStringList streamTargets;      // 数据推送接收端（udp:HOST:PORT / unix:PATH）
+        int streamLatencyBudgetUs = 2000;
+        int streamBatchSamples = 16;
+        QString filterSpec;             // 关节角滤波，见 applyFilterSpec；录制保留原始值
+        QString kinematicsPath;         // 非空时对滤波后的关节角做正运动学，额外输出 LeftPose/RightPose
+        bool fuseArms = false;          // CAN：左右臂配对成 14 关节样本输出（录制仍为原始分臂数据）
+        DualArmFusion::Mode fusionMode = DualArmFusion::HoldLast;
+        QString tracePath;              // 非空时开启性能追踪，退出时写出 Chrome trace JSON
+    };
+
+    explicit CaptureCli(const Options &options, QObject *parent = nullptr);
+    ~CaptureCli();
+
+    // 打开输出和数据源；失败时把原因写到标准错误并返回 false
+    bool start();
+
+public slots:
+    // 停止采集、写出剩余数据并打印统计，然后退出事件循环
+    void stop();
+
+private:
+    // 积攒到一定大小或超过刷新间隔后统一写出
+    static constexpr int OUTPUT_FLUSH_BYTES = 64 * 1024;
+    static constexpr int OUTPUT_FLUSH_MS = 50;
+
+    Options m_options;
+    SerialLink *m_serial = nullptr;
+    CANCommunication *m_can = nullptr;
+    SessionRecorder *m_recorder = nullptr;
+    SessionReplayer *m_replayer = nullptr;
+    ArmStreamPublisher *m_stream = nullptr;
+    SerialDeviceManager *m_devices = nullptr;   // 多串口
+    ArchiveWriter *m_archive = nullptr;
+    QVector<QByteArray> m_deviceNames;          // CSV 输出的设备列
+    QTimer *m_pollTimer;
+    QTimer *m_flushTimer;
+    QFile m_output;
+    QByteArray m_outputBuffer;
+    StreamStats m_stats;
+    ArmStateShm::Publisher m_shm;
+    float m_latestJoints[ArmStateShm::JOINT_COUNT] = {};
+    quint32 m_latestValidMask = 0;
+    QVector<JointFilter> m_filters;     // 每个设备左臂、右臂各一个
+    ArmKinematics m_kinematics[2];      // 左臂、右臂（所有设备相同）
+    DualArmFusion m_fusion;
+    qint64 m_maxFusionSkewUs = 0;
+    qint64 m_maxFusionAgeUs = 0;
+    bool m_stopped = false;
+
+    // 滤波配置：逗号分隔的 none / lowpass:HZ / median:N / oneeuro:MINCUT[:BETA]
+    bool applyFilterSpec(const QString &spec);
+    bool openOutput();
+    bool startSerial();
+    bool startSerialDevices();
+    bool startCan();
+    bool startReplay();
+    bool startArchiveExport();
+    bool openArchive();
+    void connectCanSignals();
+
+    void onSerialFrame(const SerialProtocol::Frame &frame, qint64 timestampUs);
+    void publishSample(quint16 armId, const float *values, int count, qint64 timestampUs);
+    void fuseSample(int arm, const QVector<float> &data, qint64 timestampUs);
+    // 输出融合样本：只输出有效的一半（validMask），两半都有效时才作为双臂样本
+    void writeFused(const DualArmFusion::Sample &fused);
+    void writeSample(quint16 armId, const float *values, int count, qint64 timestampUs, bool record = true);
+    // 滤波之后的样本写到共享内存、推送和输出
+    void outputSample(quint16 armId, const float *values, int count, qint64 timestampUs);
+    void outputPose(int device, int arm, const float *joints, qint64 timestampUs);
+    bool multiDevice() const { return m_options.serialPorts.size() > 1; }
+    void flushOutput();
+    void printError(const QString &message);
+};
+
+#endif // CAPTURECLI_H
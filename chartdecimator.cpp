@@ -0,0 +1,121 @@
+#include "chartdecimator.h"
+
+ChartDecimator::ChartDecimator(int channels, int columns, qint64 windowUs)
+    : m_channels(qMax(1, channels))
+    , m_columns(qMax(1, columns))
+    , m_windowUs(qMax<qint64>(1, windowUs))
+    , m_bucketSpanUs(qMax<qint64>(1, m_windowUs / m_columns))
+{
+    allocate();
+}
+
+void ChartDecimator::setColumns(int columns)
+{
+    columns = qMax(1, columns);
+    if (columns == m_columns) return;
+    m_columns = columns;
+    m_bucketSpanUs = qMax<qint64>(1, m_windowUs / m_columns);
+    allocate();
+}
+
+void ChartDecimator::setWindow(qint64 windowUs)
+{
+    windowUs = qMax<qint64>(1, windowUs);
+    if (windowUs == m_windowUs) return;
+    m_windowUs = windowUs;
+    m_bucketSpanUs = qMax<qint64>(1, m_windowUs / m_columns);
+    clear();
+}
+
+void ChartDecimator::allocate()
+{
+    m_keys.fill(-1, m_columns);
+    m_counts.fill(0, m_columns);
+    m_minValue.fill(0.0f, m_columns * m_channels);
+    m_maxValue.fill(0.0f, m_columns * m_channels);
+    m_minX.fill(0, m_columns * m_channels);
+    m_maxX.fill(0, m_columns * m_channels);
+    clear();
+}
+
+void ChartDecimator::clear()
+{
+    m_head = -1;
+    m_bucketCount = 0;
+    m_currentKey = -1;
+}
+
+void ChartDecimator::openBucket(qint64 key)
+{
+    m_head = (m_head + 1) % m_columns;
+    if (m_bucketCount < m_columns) {
+        ++m_bucketCount;
+    }
+    m_keys[m_head] = key;
+    m_counts[m_head] = 0;
+    m_currentKey = key;
+}
+
+void ChartDecimator::addSample(qint64 timestampUs, const float *values)
+{
+    // 按采集时间分桶；时间戳偶尔回退（如硬件时钟重新对齐）时并入当前桶
+    const qint64 x = timestampUs;
+    const qint64 key = x / m_bucketSpanUs;
+    if (m_currentKey < 0 || key > m_currentKey) {
+        openBucket(key);
+    }
+
+    const int base = m_head * m_channels;
+    if (m_counts[m_head] == 0) {
+        for (int ch = 0; ch < m_channels; ++ch) {
+            m_minValue[base + ch] = values[ch];
+            m_maxValue[base + ch] = values[ch];
+            m_minX[base + ch] = x;
+            m_maxX[base + ch] = x;
+        }
+    } else {
+        for (int ch = 0; ch < m_channels; ++ch) {
+            const float v = values[ch];
+            if (v < m_minValue[base + ch]) {
+                m_minValue[base + ch] = v;
+                m_minX[base + ch] = x;
+            }
+            if (v > m_maxValue[base + ch]) {
+                m_maxValue[base + ch] = v;
+                m_maxX[base + ch] = x;
+            }
+        }
+    }
+    ++m_counts[m_head];
+}
+
+void ChartDecimator::points(int channel, QVector<QPointF> &out) const
+{
+    out.clear();
+    if (channel < 0 || channel >= m_channels || m_bucketCount == 0) return;
+
+    out.reserve(m_bucketCount * 2);
+
+    // 从最旧的桶开始输出；数据中断时旧桶可能已滑出时间窗口，跳过
+    const qint64 oldestKey = m_currentKey - m_columns + 1;
+    int idx = (m_head - m_bucketCount + 1 + m_columns) % m_columns;
+    for (int n = 0; n < m_bucketCount; ++n, idx = (idx + 1) % m_columns) {
+        if (m_keys[idx] < oldestKey) continue;
+
+        const int off = idx * m_channels + channel;
+        const qint64 minX = m_minX[off];
+        const qint64 maxX = m_maxX[off];
+        const float minV = m_minValue[off];
+        const float maxV = m_maxValue[off];
+
+        if (minX == maxX) {
+            out.append(QPointF(minX, minV));
+        } else if (minX < maxX) {
+            out.append(QPointF(minX, minV));
+            out.append(QPointF(maxX, maxV));
+        } else {
+            out.append(QPointF(maxX, maxV));
+            out.append(QPointF(minX, minV));
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef CHARTDECIMATOR_H
+#define CHARTDECIMATOR_H
+
+#include <QPointF>
+#include <QVector>
+#include <QtGlobal>
+
+// 图表降采样：按像素列做 min/max 聚合（增量计算）
+// 时间窗口被均分为若干像素列，每列对应一个桶，新样本只更新所在桶内各通道的最小/最大值；
+// 输出时每个桶最多产生2个点，曲线点数只与列数有关，与历史长度无关，且峰值不会丢失。
+class ChartDecimator
+{
+public:
+    explicit ChartDecimator(int channels = 7, int columns = 800, qint64 windowUs = 60000000);
+
+    // 像素列数（通常取图表绘图区宽度），修改后会清空已有桶
+    void setColumns(int columns);
+    int columns() const { return m_columns; }
+
+    // 时间窗口长度（微秒），每列宽度 = windowUs / columns
+    void setWindow(qint64 windowUs);
+    qint64 window() const { return m_windowUs; }
+
+    // 追加一个样本；timestampUs 为采集时间，values 至少包含 channels 个值
+    void addSample(qint64 timestampUs, const float *values);
+    void clear();
+
+    bool isEmpty() const { return m_bucketCount == 0; }
+    int channelCount() const { return m_channels; }
+
+    // 取出某个通道降采样后的点（x 为采集时间，微秒，递增），out 会被覆盖
+    void points(int channel, QVector<QPointF> &out) const;
+
+private:
+    int m_channels;
+    int m_columns;
+    qint64 m_windowUs;
+    qint64 m_bucketSpanUs;
+
+    // 环形桶：m_head 为最新桶下标，m_bucketCount 为有效桶数
+    int m_head = -1;
+    int m_bucketCount = 0;
+    qint64 m_currentKey = -1;
+
+    QVector<qint64> m_keys;      // [bucket] 桶对应的时间片序号
+    QVector<int> m_counts;       // [bucket]
+    QVector<float> m_minValue;   // [bucket * channels + ch]
+    QVector<float> m_maxValue;
+    QVector<qint64> m_minX;
+    QVector<qint64> m_maxX;
+
+    void allocate();
+    void openBucket(qint64 key);
+};
+
+#endif // CHARTDECIMATOR_H
@@ -0,0 +1,68 @@
+#include "displayscheduler.h"
+
+DisplayScheduler::DisplayScheduler(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setTimerType(Qt::PreciseTimer);
+    m_timer->setInterval(1000 / m_frameRate);
+    connect(m_timer, &QTimer::timeout, this, &DisplayScheduler::onTick);
+    m_clock.start();
+}
+
+void DisplayScheduler::setFrameRate(int hz)
+{
+    m_frameRate = qBound(1, hz, 240);
+    m_timer->setInterval(qMax(1, 1000 / m_frameRate));
+}
+
+void DisplayScheduler::setMinimumInterval(Subsystem subsystem, int intervalMs)
+{
+    for (int i = 0; i < SubsystemCount; ++i) {
+        if (subsystem & (1 << i)) {
+            m_minInterval[i] = qMax(0, intervalMs);
+        }
+    }
+}
+
+void DisplayScheduler::markDirty(Subsystems subsystems)
+{
+    m_dirty |= subsystems;
+    if (!m_paused && !m_timer->isActive()) {
+        m_timer->start();
+    }
+}
+
+void DisplayScheduler::setPaused(bool paused)
+{
+    m_paused = paused;
+    if (m_paused) {
+        m_timer->stop();
+    } else if (m_dirty) {
+        m_timer->start();
+    }
+}
+
+void DisplayScheduler::onTick()
+{
+    if (!m_dirty) {
+        // 没有任何变化：停止节拍，直到下一次 markDirty
+        m_timer->stop();
+        return;
+    }
+
+    // 未到最小间隔的子系统保留脏标记，留到后续帧
+    const qint64 now = m_clock.elapsed();
+    Subsystems due;
+    for (int i = 0; i < SubsystemCount; ++i) {
+        const Subsystem s = static_cast<Subsystem>(1 << i);
+        if (!(m_dirty & s)) continue;
+        if (m_minInterval[i] > 0 && now - m_lastRender[i] < m_minInterval[i]) continue;
+        due |= s;
+        m_lastRender[i] = now;
+    }
+    if (!due) return;
+
+    m_dirty &= ~due;
+    emit frame(due);
+}
@@ -0,0 +1,61 @@
+#ifndef DISPLAYSCHEDULER_H
+#define DISPLAYSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+// 显示帧调度：数据到达时只标记对应子系统为“脏”，
+// 由统一的显示节拍在一帧内集中刷新表格、曲线、状态栏和日志；没有任何变化时不产生节拍。
+class DisplayScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Subsystem {
+        Tables = 0x01,
+        Charts = 0x02,
+        Status = 0x04,
+        Log    = 0x08,
+        AllSubsystems = Tables | Charts | Status | Log
+    };
+    Q_DECLARE_FLAGS(Subsystems, Subsystem)
+    Q_FLAG(Subsystems)
+
+    explicit DisplayScheduler(QObject *parent = nullptr);
+
+    // 显示帧率（Hz）
+    void setFrameRate(int hz);
+    int frameRate() const { return m_frameRate; }
+
+    // 某个子系统的最小刷新间隔（例如状态栏文字不需要每帧变化）
+    void setMinimumInterval(Subsystem subsystem, int intervalMs);
+
+    // 标记子系统需要刷新；必要时唤醒节拍定时器
+    void markDirty(Subsystems subsystems);
+
+    // 暂停/恢复（暂停期间只累积脏标记）
+    void setPaused(bool paused);
+
+signals:
+    // 一帧内需要刷新的子系统
+    void frame(DisplayScheduler::Subsystems dirty);
+
+private slots:
+    void onTick();
+
+private:
+    static constexpr int SubsystemCount = 4;
+
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    int m_frameRate = 30;
+    bool m_paused = false;
+    Subsystems m_dirty;
+    int m_minInterval[SubsystemCount] = {};
+    qint64 m_lastRender[SubsystemCount] = {};
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(DisplayScheduler::Subsystems)
+
+#endif // DISPLAYSCHEDULER_H
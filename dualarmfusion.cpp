@@ -0,0 +1,109 @@
+#include "dualarmfusion.h"
+#include <cstring>
+
+DualArmFusion::DualArmFusion()
+{
+}
+
+void DualArmFusion::reset()
+{
+    for (ArmState &arm : m_arms) {
+        arm = ArmState();
+    }
+    m_pendingMask = 0;
+    m_cycleRequestUs = 0;
+    m_paired = 0;
+    m_filled = 0;
+}
+
+bool DualArmFusion::beginCycle(qint64 requestUs, Sample &out)
+{
+    const bool emitted = m_pendingMask != 0;
+    if (emitted) {
+        emitCycle(out);
+    }
+    m_cycleRequestUs = requestUs;
+    return emitted;
+}
+
+bool DualArmFusion::addArm(int arm, qint64 timestampUs, const float *values, Sample &out)
+{
+    const quint32 bit = 1u << arm;
+
+    // 同一半在本周期内再次到达：另一半没来，先结束上一周期
+    bool emitted = false;
+    if (m_pendingMask & bit) {
+        emitCycle(out);
+        emitted = true;
+    }
+
+    ArmState &state = m_arms[arm];
+    std::memcpy(state.previous, state.current, sizeof(state.current));
+    state.previousUs = state.currentUs;
+    std::memcpy(state.current, values, sizeof(state.current));
+    state.currentUs = timestampUs;
+    state.history = qMin(state.history + 1, 2);
+    m_pendingMask |= bit;
+
+    if (m_pendingMask == (LeftArmBit | RightArmBit)) {
+        emitCycle(out);
+        return true;
+    }
+    return emitted;
+}
+
+void DualArmFusion::fillArm(int arm, qint64 atUs, float *out) const
+{
+    const ArmState &state = m_arms[arm];
+    const qint64 spanUs = state.currentUs - state.previousUs;
+    if (m_mode == HoldLast || state.history < 2 || spanUs <= 0 || atUs <= state.currentUs) {
+        std::memcpy(out, state.current, sizeof(state.current));
+        return;
+    }
+    const qint64 aheadUs = qMin(atUs - state.currentUs, m_maxExtrapolateUs);
+    const float k = static_cast<float>(aheadUs) / static_cast<float>(spanUs);
+    for (int j = 0; j < JOINTS_PER_ARM; ++j) {
+        out[j] = state.current[j] + (state.current[j] - state.previous[j]) * k;
+    }
+}
+
+void DualArmFusion::emitCycle(Sample &out)
+{
+    const ArmState &left = m_arms[0];
+    const ArmState &right = m_arms[1];
+
+    // 本帧时刻取本周期内最后到达的一半
+    qint64 frameUs = 0;
+    if (m_pendingMask & LeftArmBit) frameUs = left.currentUs;
+    if (m_pendingMask & RightArmBit) frameUs = qMax(frameUs, right.currentUs);
+
+    out.timestampUs = frameUs;
+    out.requestUs = m_cycleRequestUs;
+    out.freshMask = m_pendingMask;
+    out.validMask = 0;
+    out.skewUs = 0;
+    out.ageUs = 0;
+    fillArm(0, frameUs, out.joints);
+    fillArm(1, frameUs, out.joints + JOINTS_PER_ARM);
+
+    for (int arm = 0; arm < 2; ++arm) {
+        const ArmState &state = m_arms[arm];
+        if (state.history == 0) continue;
+        const qint64 ageUs = frameUs - state.currentUs;
+        out.ageUs = qMax(out.ageUs, ageUs);
+        if (ageUs <= m_maxAgeUs) {
+            out.validMask |= 1u << arm;
+        }
+    }
+    if (left.history > 0 && right.history > 0) {
+        out.skewUs = right.currentUs - left.currentUs;
+    }
+
+    if (m_pendingMask == (LeftArmBit | RightArmBit)) {
+        ++m_paired;
+    } else {
+        ++m_filled;
+    }
+    m_pendingMask = 0;
+    m_cycleRequestUs = 0;
+}
@@ -0,0 +1,83 @@
+#ifndef DUALARMFUSION_H
+#define DUALARMFUSION_H
+
+#include <QtGlobal>
+
+// 双臂数据融合（CAN）：左右臂分别到达，按周期配对成一帧 14 关节数据。
+// 一个周期从双臂请求（0x04）发出开始（beginCycle），左右臂都到齐时立即输出；
+// 下一个请求发出时仍缺一半，或者同一半在本周期内再次到达，则用该臂的历史数据补齐后输出。
+// 没有请求节拍时（如回放）只按到达顺序配对。
+// 补齐和对齐方式：
+//   HoldLast     - 使用该臂最近一次的值
+//   Extrapolate  - 按该臂最近两次的值线性外推到本帧时刻（最多外推 maxExtrapolateUs），
+//                  两半都到齐时也把较早的一半外推到较晚的时刻，消除左右臂的时间差
+class DualArmFusion
+{
+public:
+    static constexpr int JOINTS_PER_ARM = 7;
+    static constexpr int JOINT_COUNT = 14;
+
+    enum Mode {
+        HoldLast,
+        Extrapolate
+    };
+
+    enum ArmBits {
+        LeftArmBit = 0x01,
+        RightArmBit = 0x02
+    };
+
+    struct Sample {
+        qint64 timestampUs = 0;  // 本帧时刻：本周期内最后到达的一半的时间戳
+        qint64 requestUs = 0;    // 本周期双臂请求的发出时间；没有请求节拍时为 0
+        float joints[JOINT_COUNT] = {};
+        quint32 freshMask = 0;   // 本周期实际收到的臂（ArmBits）
+        quint32 validMask = 0;   // 有数据的臂（收到过，且未超过 maxAgeUs）
+        qint64 skewUs = 0;       // 右臂原始时间戳 - 左臂原始时间戳
+        qint64 ageUs = 0;        // 较旧一半的原始时间戳距本帧时刻的时间
+    };
+
+    DualArmFusion();
+
+    void setMode(Mode mode) { m_mode = mode; }
+    Mode mode() const { return m_mode; }
+    // 超过该时间未更新的一半不再视为有效（仍输出保持的值）
+    void setMaxAgeUs(qint64 us) { m_maxAgeUs = us; }
+    void setMaxExtrapolateUs(qint64 us) { m_maxExtrapolateUs = us; }
+
+    void reset();
+
+    // 发出双臂请求时调用。上一周期只到了一半时补齐输出到 out 并返回 true
+    bool beginCycle(qint64 requestUs, Sample &out);
+    // 一半到达。完成一帧（本周期凑齐，或上一周期被本次到达结束）时写入 out 并返回 true
+    bool addLeft(qint64 timestampUs, const float *values, Sample &out) { return addArm(0, timestampUs, values, out); }
+    bool addRight(qint64 timestampUs, const float *values, Sample &out) { return addArm(1, timestampUs, values, out); }
+
+    // 统计：完整周期数 / 补齐的周期数
+    quint64 pairedCount() const { return m_paired; }
+    quint64 filledCount() const { return m_filled; }
+
+private:
+    struct ArmState {
+        float current[JOINTS_PER_ARM] = {};
+        float previous[JOINTS_PER_ARM] = {};
+        qint64 currentUs = 0;
+        qint64 previousUs = 0;
+        int history = 0;          // 已有的样本数（最多记 2）
+    };
+
+    Mode m_mode = HoldLast;
+    qint64 m_maxAgeUs = 100000;
+    qint64 m_maxExtrapolateUs = 5000;
+    ArmState m_arms[2];
+    quint32 m_pendingMask = 0;    // 本周期已到达的臂
+    qint64 m_cycleRequestUs = 0;
+    quint64 m_paired = 0;
+    quint64 m_filled = 0;
+
+    bool addArm(int arm, qint64 timestampUs, const float *values, Sample &out);
+    void emitCycle(Sample &out);
+    void fillArm(int arm, qint64 atUs, float *out) const;
+};
+
+#endif // DUALARMFUSION_H
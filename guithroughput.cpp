@@ -0,0 +1,283 @@
+// 界面主链路离屏吞吐量测试（不需要硬件和显示器）
+// 用法:
+//   Linker_TA_gui_throughput [--source serial|can|all] [--start-rate HZ] [--max-rate HZ] [--seconds S]
+//                            [--tab joints|pose|table]
+// 在 QT_QPA_PLATFORM=offscreen 下创建 MainWindow，由独立线程按设定速率生成合成的串口推送帧或 CAN 分片，
+// 以排队调用送到界面线程（与串口/CAN 工作线程的投递方式相同），经过拆帧/重组、解码、滤波、历史、
+// 表格和曲线刷新的完整流程。速率逐级翻倍，直到界面线程处理不过来（积压持续增长）为止。
+// 先报告窗口构造耗时；每级报告：实际处理速率、积压（已投递未处理的样本数）峰值和结束值、界面事件循环延迟 p50/p99/最大
+// （探测事件从投递到执行的时间）。
+#include "mainwindow.h"
+#include "acqclock.h"
+#include "latencytracker.h"
+#include "serialprotocol.h"
+#include "trace.h"
+
+#include <QApplication>
+#include <QTabWidget>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace {
+
+enum class Source {
+    Serial,
+    Can
+};
+
+// 一级测试的结果
+struct StepResult {
+    double achievedHz = 0.0;
+    quint64 maxBacklog = 0;
+    quint64 endBacklog = 0;
+    LatencyHistogram loopLatency;
+    bool sustainable = false;
+};
+
+// 生成一个样本的 14 个关节角：各关节不同频率的正弦，保证表格和曲线每帧都有变化
+void syntheticJoints(quint64 sample, float *joints)
+{
+    const double t = sample * 0.001;
+    for (int j = 0; j < 14; ++j) {
+        joints[j] = static_cast<float>(90.0 * std::sin(t * (0.5 + 0.1 * j)));
+    }
+}
+
+QByteArray serialFrame(const float *joints)
+{
+    QByteArray data;
+    data.reserve(56);
+    for (int j = 0; j < 14; ++j) {
+        data.append(SerialProtocol::floatToBytes(joints[j]));
+    }
+    return SerialProtocol::buildCommandFrame(SerialProtocol::CMD_GET_ARM_DATA, data);
+}
+
+// CAN 分片：大端 int16，原始值为角度 × 10
+CANDataFrame canFrame(quint16 id, const float *joints, int count, qint64 timestampUs)
+{
+    QByteArray data(count * 2, 0);
+    for (int i = 0; i < count; ++i) {
+        const qint16 value = static_cast<qint16>(std::lround(joints[i] * 10.0f));
+        data[2 * i] = static_cast<char>((value >> 8) & 0xFF);
+        data[2 * i + 1] = static_cast<char>(value & 0xFF);
+    }
+    return CANDataFrame(id, data, timestampUs);
+}
+
+class Benchmark
+{
+public:
+    explicit Benchmark(MainWindow *window) : m_window(window) {}
+
+    // 在界面线程以外运行；按 rateHz 投递 seconds 秒
+    StepResult runStep(Source source, int rateHz, double seconds);
+
+private:
+    // 每 1ms 投递一批（串口一次读到多帧；CAN 每帧单独投递）
+    static constexpr int TICK_US = 1000;
+    static constexpr int PROBE_INTERVAL_US = 10000;
+
+    MainWindow *m_window;
+    std::atomic<quint64> m_posted{0};
+    std::atomic<quint64> m_processed{0};
+    quint64 m_nextSample = 0;
+    LatencyHistogram m_loopLatency;   // 只在界面线程中写
+
+    void post(Source source, int count);
+    void probe();
+    void drain(double timeoutSeconds);
+};
+
+void Benchmark::post(Source source, int count)
+{
+    float joints[14];
+    const qint64 nowUs = AcqClock::nowUs();
+    if (source == Source::Serial) {
+        QByteArray bytes;
+        for (int i = 0; i < count; ++i) {
+            syntheticJoints(m_nextSample++, joints);
+            bytes.append(serialFrame(joints));
+        }
+        m_posted.fetch_add(count);
+        QMetaObject::invokeMethod(m_window, [this, bytes, nowUs, count]() {
+            m_window->injectSerialBytes(bytes, nowUs);
+            m_processed.fetch_add(count);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        syntheticJoints(m_nextSample++, joints);
+        const CANDataFrame frames[4] = {
+            canFrame(CANProtocol::CAN_ID_LEFT_PART1, joints, 4, nowUs),
+            canFrame(CANProtocol::CAN_ID_LEFT_PART2, joints + 4, 3, nowUs),
+            canFrame(CANProtocol::CAN_ID_RIGHT_PART1, joints + 7, 4, nowUs),
+            canFrame(CANProtocol::CAN_ID_RIGHT_PART2, joints + 11, 3, nowUs),
+        };
+        m_posted.fetch_add(1);
+        for (int f = 0; f < 4; ++f) {
+            const CANDataFrame frame = frames[f];
+            const bool last = f == 3;
+            QMetaObject::invokeMethod(m_window, [this, frame, last]() {
+                m_window->injectCanFrame(frame);
+                if (last) m_processed.fetch_add(1);
+            }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void Benchmark::probe()
+{
+    const qint64 postedUs = AcqClock::nowUs();
+    QMetaObject::invokeMethod(m_window, [this, postedUs]() {
+        m_loopLatency.add(AcqClock::nowUs() - postedUs);
+    }, Qt::QueuedConnection);
+}
+
+void Benchmark::drain(double timeoutSeconds)
+{
+    const qint64 deadlineUs = AcqClock::nowUs() + static_cast<qint64>(timeoutSeconds * 1e6);
+    while (m_processed.load() < m_posted.load() && AcqClock::nowUs() < deadlineUs) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+StepResult Benchmark::runStep(Source source, int rateHz, double seconds)
+{
+    StepResult result;
+    QMetaObject::invokeMethod(m_window, [this]() { m_loopLatency.reset(); }, Qt::BlockingQueuedConnection);
+
+    const quint64 processedStart = m_processed.load();
+    const qint64 startUs = AcqClock::nowUs();
+    const qint64 endUs = startUs + static_cast<qint64>(seconds * 1e6);
+    // 积压超过 1 秒的数据即可判定跟不上，提前结束以免内存无限增长
+    const quint64 giveUpBacklog = static_cast<quint64>(rateHz);
+    quint64 sent = 0;
+    qint64 nextProbeUs = startUs;
+
+    for (qint64 nowUs = startUs; nowUs < endUs; nowUs = AcqClock::nowUs()) {
+        const quint64 due = static_cast<quint64>((nowUs - startUs) * static_cast<double>(rateHz) / 1e6);
+        if (due > sent) {
+            post(source, static_cast<int>(due - sent));
+            sent = due;
+        }
+        if (nowUs >= nextProbeUs) {
+            probe();
+            nextProbeUs += PROBE_INTERVAL_US;
+        }
+        const quint64 backlog = m_posted.load() - m_processed.load();
+        result.maxBacklog = std::max(result.maxBacklog, backlog);
+        if (backlog > giveUpBacklog) break;
+        std::this_thread::sleep_for(std::chrono::microseconds(TICK_US));
+    }
+
+    const qint64 elapsedUs = AcqClock::nowUs() - startUs;
+    result.endBacklog = m_posted.load() - m_processed.load();
+    result.achievedHz = (m_processed.load() - processedStart) * 1e6 / std::max<qint64>(1, elapsedUs);
+    // 结束时积压不超过 100ms 的数据、且处理速率达到设定值的 95% 视为可持续
+    result.sustainable = result.endBacklog <= std::max<quint64>(10, static_cast<quint64>(rateHz / 10))
+                         && result.achievedHz >= 0.95 * rateHz;
+
+    drain(10.0);
+    QMetaObject::invokeMethod(m_window, [this, &result]() {
+        result.loopLatency = m_loopLatency;
+    }, Qt::BlockingQueuedConnection);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 没有显示器也能运行；已设置时保留调用方的平台
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    TRACE_THREAD_NAME("gui");
+
+    std::string sourceName = "all";
+    std::string tabName = "joints";
+    int startRate = 250;
+    int maxRate = 64000;
+    double seconds = 3.0;
+
+    const QStringList args = QCoreApplication::arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        const QString &arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        if (arg == "--source" && hasValue) {
+            sourceName = args[++i].toStdString();
+        } else if (arg == "--start-rate" && hasValue) {
+            startRate = std::max(1, args[++i].toInt());
+        } else if (arg == "--max-rate" && hasValue) {
+            maxRate = std::max(1, args[++i].toInt());
+        } else if (arg == "--seconds" && hasValue) {
+            seconds = std::max(0.5, args[++i].toDouble());
+        } else if (arg == "--tab" && hasValue) {
+            tabName = args[++i].toStdString();
+        } else {
+            std::fprintf(stderr, "usage: %s [--source serial|can|all] [--start-rate HZ] [--max-rate HZ] "
+                         "[--seconds S] [--tab joints|pose|table]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    QVector<Source> sources;
+    if (sourceName == "serial" || sourceName == "all") sources.append(Source::Serial);
+    if (sourceName == "can" || sourceName == "all") sources.append(Source::Can);
+    if (sources.isEmpty()) {
+        std::fprintf(stderr, "--source 只支持 serial / can / all\n");
+        return 2;
+    }
+
+    MainWindow window;
+    window.resize(1600, 1000);
+    window.show();
+    std::printf("startup: window constructed in %.1f ms\n", window.constructionTimeUs() / 1000.0);
+
+    // 曲线页可见时才重绘曲线；默认测最重的关节曲线页
+    const char *tabTitle = tabName == "pose" ? "末端位姿" : tabName == "table" ? nullptr : "关节曲线";
+    if (QTabWidget *tabs = window.findChild<QTabWidget *>()) {
+        for (int i = 0; tabTitle && i < tabs->count(); ++i) {
+            if (tabs->tabText(i) == QString::fromUtf8(tabTitle)) tabs->setCurrentIndex(i);
+        }
+    }
+
+    Benchmark benchmark(&window);
+    std::thread producer([&]() {
+        TRACE_THREAD_NAME("producer");
+        for (const Source source : sources) {
+            const char *name = source == Source::Serial ? "serial" : "can";
+            std::printf("%s (%s tab, %.1f s per step)\n", name, tabName.c_str(), seconds);
+            std::printf("%10s %12s %12s %12s %26s\n", "rate_hz", "achieved_hz", "max_backlog", "end_backlog",
+                        "loop_latency_us p50/p99/max");
+            int sustainableRate = 0;
+            for (int rate = startRate; rate <= maxRate; rate *= 2) {
+                const StepResult r = benchmark.runStep(source, rate, seconds);
+                std::printf("%10d %12.1f %12llu %12llu %10lld/%lld/%lld%s\n", rate, r.achievedHz,
+                            static_cast<unsigned long long>(r.maxBacklog),
+                            static_cast<unsigned long long>(r.endBacklog),
+                            static_cast<long long>(r.loopLatency.percentileUs(0.5)),
+                            static_cast<long long>(r.loopLatency.percentileUs(0.99)),
+                            static_cast<long long>(r.loopLatency.maxUs()),
+                            r.sustainable ? "" : "  backlog");
+                std::fflush(stdout);
+                if (!r.sustainable) break;
+                sustainableRate = rate;
+            }
+            std::printf("%s max sustainable rate: %d Hz\n\n", name, sustainableRate);
+        }
+        QMetaObject::invokeMethod(&app, "quit", Qt::QueuedConnection);
+    });
+
+    const int result = app.exec();
+    producer.join();
+    return result;
+}
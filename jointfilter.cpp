@@ -0,0 +1,159 @@
+#include "jointfilter.h"
+#include "simdvec.h"
+#include <cstring>
+
+namespace {
+
+constexpr float TWO_PI = 6.28318530717958647692f;
+
+using namespace SimdVec;
+
+// 一阶低通系数：alpha = 1 / (1 + tau / dt)，tau = 1 / (2π fc)
+inline Vec smoothingAlpha(Vec cutoffHz, Vec dt)
+{
+    const Vec a = splat(TWO_PI) * cutoffHz * dt;
+    return a / (a + splat(1.0f));
+}
+
+} // namespace
+
+JointFilter::JointFilter(int jointCount)
+    : m_jointCount(qBound(1, jointCount, MAX_JOINTS))
+    , m_vectorCount((m_jointCount + 3) / 4)
+{
+    setAllJoints(JointConfig());
+}
+
+void JointFilter::setJointConfig(int joint, const JointConfig &config)
+{
+    if (joint < 0 || joint >= m_jointCount) return;
+    m_configs[joint] = config;
+    updateLanes();
+}
+
+void JointFilter::setAllJoints(const JointConfig &config)
+{
+    for (int i = 0; i < m_jointCount; ++i) {
+        m_configs[i] = config;
+    }
+    updateLanes();
+}
+
+void JointFilter::setMedianWindow(int window)
+{
+    window = qBound(1, window, MAX_MEDIAN_WINDOW);
+    if (window % 2 == 0) --window;
+    if (window != m_medianWindow) {
+        m_medianWindow = window;
+        reset();
+    }
+    updateLanes();
+}
+
+void JointFilter::updateLanes()
+{
+    // 多余的通道（补齐到 4 的倍数）不做任何滤波
+    m_active = false;
+    for (int i = 0; i < MAX_JOINTS; ++i) {
+        const bool used = i < m_jointCount;
+        const JointConfig &config = m_configs[used ? i : 0];
+        const bool median = used && config.median && m_medianWindow > 1;
+        const bool lowPass = used && config.smoothing == LowPass;
+        const bool oneEuro = used && config.smoothing == OneEuro;
+        m_medianMask[i] = median ? 0xFFFFFFFFu : 0u;
+        m_lowPassMask[i] = lowPass ? 0xFFFFFFFFu : 0u;
+        m_oneEuroMask[i] = oneEuro ? 0xFFFFFFFFu : 0u;
+        m_cutoff[i] = config.cutoffHz;
+        m_minCutoff[i] = config.minCutoffHz;
+        m_beta[i] = config.beta;
+        m_dCutoff[i] = config.dCutoffHz;
+        m_active = m_active || median || lowPass || oneEuro;
+    }
+}
+
+void JointFilter::reset()
+{
+    m_initialized = false;
+}
+
+void JointFilter::process(qint64 timestampUs, const float *in, float *out)
+{
+    if (!m_active) {
+        if (out != in) std::memcpy(out, in, m_jointCount * sizeof(float));
+        return;
+    }
+
+    alignas(16) float x[MAX_JOINTS] = {};
+    std::memcpy(x, in, m_jointCount * sizeof(float));
+
+    if (!m_initialized) {
+        // 第一帧：所有状态取当前值
+        for (int k = 0; k < m_medianWindow; ++k) {
+            std::memcpy(m_history[k], x, sizeof(x));
+        }
+        std::memcpy(m_lowPass, x, sizeof(x));
+        std::memcpy(m_oneEuro, x, sizeof(x));
+        std::memset(m_oneEuroSpeed, 0, sizeof(m_oneEuroSpeed));
+        m_historyPos = 0;
+        m_lastTimestampUs = timestampUs;
+        m_initialized = true;
+        std::memcpy(out, x, m_jointCount * sizeof(float));
+        return;
+    }
+
+    // 采样间隔（秒）；时间戳重复或回退时沿用上一次的间隔
+    const qint64 dtUs = timestampUs - m_lastTimestampUs;
+    if (dtUs > 0) {
+        m_lastDt = static_cast<float>(dtUs) * 1e-6f;
+        m_lastTimestampUs = timestampUs;
+    }
+    const Vec dt = splat(m_lastDt);
+    const Vec invDt = splat(1.0f / m_lastDt);
+
+    if (m_medianWindow > 1) {
+        std::memcpy(m_history[m_historyPos], x, sizeof(x));
+        m_historyPos = (m_historyPos + 1) % m_medianWindow;
+    }
+
+    for (int g = 0; g < m_vectorCount; ++g) {
+        const int base = g * 4;
+        Vec value = load(x + base);
+
+        // 中值：奇偶换位排序网络，窗口内各帧逐通道排序后取中间值
+        if (m_medianWindow > 1) {
+            Vec window[MAX_MEDIAN_WINDOW];
+            for (int k = 0; k < m_medianWindow; ++k) {
+                window[k] = load(m_history[k] + base);
+            }
+            for (int pass = 0; pass < m_medianWindow; ++pass) {
+                for (int k = pass & 1; k + 1 < m_medianWindow; k += 2) {
+                    const Vec lo = vmin(window[k], window[k + 1]);
+                    window[k + 1] = vmax(window[k], window[k + 1]);
+                    window[k] = lo;
+                }
+            }
+            value = select(loadMask(m_medianMask + base), window[m_medianWindow / 2], value);
+        }
+
+        // 一阶低通
+        Vec lowPass = load(m_lowPass + base);
+        lowPass = lowPass + smoothingAlpha(load(m_cutoff + base), dt) * (value - lowPass);
+        store(m_lowPass + base, lowPass);
+
+        // One-Euro：先对速度低通，再按速度调整截止频率
+        Vec estimate = load(m_oneEuro + base);
+        Vec speed = load(m_oneEuroSpeed + base);
+        const Vec rawSpeed = (value - estimate) * invDt;
+        speed = speed + smoothingAlpha(load(m_dCutoff + base), dt) * (rawSpeed - speed);
+        const Vec cutoff = load(m_minCutoff + base) + load(m_beta + base) * vabs(speed);
+        estimate = estimate + smoothingAlpha(cutoff, dt) * (value - estimate);
+        store(m_oneEuro + base, estimate);
+        store(m_oneEuroSpeed + base, speed);
+
+        value = select(loadMask(m_lowPassMask + base), lowPass, value);
+        value = select(loadMask(m_oneEuroMask + base), estimate, value);
+        store(x + base, value);
+    }
+
+    std::memcpy(out, x, m_jointCount * sizeof(float));
+}
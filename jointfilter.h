@@ -0,0 +1,79 @@
+#ifndef JOINTFILTER_H
+#define JOINTFILTER_H
+
+#include <QtGlobal>
+
+// 关节角滤波：对一组关节（最多 16 个）同时做滤波，每 4 个关节一组用 SIMD 计算（SSE2，不可用时退化为标量）。
+// 处理顺序：滑动中值（去毛刺） -> 平滑（一阶低通或 One-Euro，按关节选择）。
+// 中值窗口对所有关节相同；平滑方式和参数可以按关节配置。
+// 低通和 One-Euro 的系数按实际采样间隔计算，采样率变化时截止频率不变。
+class JointFilter
+{
+public:
+    static constexpr int MAX_JOINTS = 16;
+    static constexpr int MAX_MEDIAN_WINDOW = 9;
+
+    enum Smoothing {
+        NoSmoothing,
+        LowPass,    // 一阶低通，截止频率 cutoffHz
+        OneEuro     // 自适应低通：静止时截止频率为 minCutoffHz，速度越快截止频率越高（beta）
+    };
+
+    struct JointConfig {
+        bool median = false;       // 是否使用中值结果（窗口见 setMedianWindow）
+        Smoothing smoothing = NoSmoothing;
+        float cutoffHz = 5.0f;     // LowPass
+        float minCutoffHz = 1.0f;  // OneEuro
+        float beta = 0.05f;        // OneEuro：速度系数（单位/秒 -> Hz）
+        float dCutoffHz = 1.0f;    // OneEuro：速度估计的低通截止频率
+    };
+
+    explicit JointFilter(int jointCount = 7);
+
+    int jointCount() const { return m_jointCount; }
+    void setJointConfig(int joint, const JointConfig &config);
+    void setAllJoints(const JointConfig &config);
+    const JointConfig &jointConfig(int joint) const { return m_configs[joint]; }
+    // 中值窗口（奇数，1 表示关闭，最大 MAX_MEDIAN_WINDOW）
+    void setMedianWindow(int window);
+    int medianWindow() const { return m_medianWindow; }
+
+    // 是否有任何关节启用了滤波（未启用时 process 只做拷贝）
+    bool isActive() const { return m_active; }
+
+    // 清除历史，下一帧作为初始值
+    void reset();
+
+    // 处理一帧：in/out 各 jointCount 个值，可以是同一块内存
+    void process(qint64 timestampUs, const float *in, float *out);
+
+private:
+    int m_jointCount;
+    int m_vectorCount;         // 4 个关节一组的组数
+    int m_medianWindow = 1;
+    bool m_active = false;
+    JointConfig m_configs[MAX_JOINTS];
+
+    // 按通道展开的配置（与状态一样按 16 字节对齐，供向量加载）
+    alignas(16) quint32 m_medianMask[MAX_JOINTS];   // 全 1 表示启用
+    alignas(16) quint32 m_lowPassMask[MAX_JOINTS];
+    alignas(16) quint32 m_oneEuroMask[MAX_JOINTS];
+    alignas(16) float m_cutoff[MAX_JOINTS];
+    alignas(16) float m_minCutoff[MAX_JOINTS];
+    alignas(16) float m_beta[MAX_JOINTS];
+    alignas(16) float m_dCutoff[MAX_JOINTS];
+
+    // 状态
+    bool m_initialized = false;
+    qint64 m_lastTimestampUs = 0;
+    float m_lastDt = 0.001f;
+    int m_historyPos = 0;
+    alignas(16) float m_history[MAX_MEDIAN_WINDOW][MAX_JOINTS];
+    alignas(16) float m_lowPass[MAX_JOINTS];
+    alignas(16) float m_oneEuro[MAX_JOINTS];
+    alignas(16) float m_oneEuroSpeed[MAX_JOINTS];
+
+    void updateLanes();
+};
+
+#endif // JOINTFILTER_H
@@ -0,0 +1,57 @@
+#include "latencyhistogram.h"
+#include <QtAlgorithms>
+
+int LatencyHistogram::bucketOf(qint64 us)
+{
+    if (us < 16) return static_cast<int>(qMax<qint64>(0, us));
+    const int exponent = 63 - qCountLeadingZeroBits(static_cast<quint64>(us));
+    const int sub = static_cast<int>((us >> (exponent - 3)) & 7);
+    return qMin(BUCKET_COUNT - 1, 16 + (exponent - 4) * 8 + sub);
+}
+
+qint64 LatencyHistogram::bucketUpperUs(int bucket)
+{
+    if (bucket < 16) return bucket;
+    const int exponent = 4 + (bucket - 16) / 8;
+    const int sub = (bucket - 16) % 8;
+    return ((static_cast<qint64>(8 + sub + 1)) << (exponent - 3)) - 1;
+}
+
+void LatencyHistogram::add(qint64 us)
+{
+    us = qMax<qint64>(0, us);
+    ++m_buckets[bucketOf(us)];
+    m_min = m_count ? qMin(m_min, us) : us;
+    m_max = qMax(m_max, us);
+    m_sum += us;
+    ++m_count;
+}
+
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram();
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.m_count == 0) return;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        m_buckets[i] += other.m_buckets[i];
+    }
+    m_min = m_count ? qMin(m_min, other.m_min) : other.m_min;
+    m_max = qMax(m_max, other.m_max);
+    m_sum += other.m_sum;
+    m_count += other.m_count;
+}
+
+qint64 LatencyHistogram::percentileUs(double p) const
+{
+    if (m_count == 0) return 0;
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(p * m_count + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) return qMin(bucketUpperUs(i), m_max);
+    }
+    return m_max;
+}
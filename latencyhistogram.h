@@ -0,0 +1,40 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+
+// 时间直方图（微秒）：对数分桶，小于 16us 每微秒一个桶，之后每个 2 的幂区间再等分 8 份，
+// 相对误差 < 12.5%，范围 0 ~ 2^35us（更大的值计入最后一个桶）。
+// 延迟统计、流间隔统计和轨迹下发的迟到统计共用；只在一个线程中使用，不加锁。
+class LatencyHistogram
+{
+public:
+    static constexpr int BUCKET_COUNT = 16 + (35 - 4) * 8;
+
+    // 负值按 0 记录
+    void add(qint64 us);
+    void reset();
+    // 累加另一个直方图（例如合并滑动窗口的两段）
+    void merge(const LatencyHistogram &other);
+
+    quint64 count() const { return m_count; }
+    qint64 minUs() const { return m_count ? m_min : 0; }
+    qint64 maxUs() const { return m_max; }
+    double meanUs() const { return m_count ? static_cast<double>(m_sum) / m_count : 0.0; }
+    // 分位数（0 ~ 1），返回所在桶的上界（不超过最大值）
+    qint64 percentileUs(double p) const;
+
+    quint64 bucketCount(int bucket) const { return m_buckets[bucket]; }
+    static qint64 bucketUpperUs(int bucket);
+
+private:
+    static int bucketOf(qint64 us);
+
+    quint64 m_buckets[BUCKET_COUNT] = {};
+    quint64 m_count = 0;
+    qint64 m_sum = 0;
+    qint64 m_min = 0;
+    qint64 m_max = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,44 @@
+#include "latencytracker.h"
+#include <QStringList>
+
+const char *LatencyTracker::stageName(Stage stage)
+{
+    static const char *const names[StageCount] = {"queue", "decode", "display", "total"};
+    return stage < StageCount ? names[stage] : "unknown";
+}
+
+void LatencyTracker::sampleDecoded(const Stamp &stamp)
+{
+    m_histograms[Queue].add(stamp.dequeueUs - stamp.arrivalUs);
+    m_histograms[Decode].add(stamp.decodeUs - stamp.dequeueUs);
+    m_pending = stamp;
+    m_hasPending = true;
+}
+
+void LatencyTracker::rendered(qint64 nowUs)
+{
+    if (!m_hasPending) return;
+    m_histograms[Display].add(nowUs - m_pending.decodeUs);
+    m_histograms[Total].add(nowUs - m_pending.arrivalUs);
+    m_hasPending = false;
+}
+
+void LatencyTracker::reset()
+{
+    for (LatencyHistogram &histogram : m_histograms) {
+        histogram.reset();
+    }
+    m_hasPending = false;
+}
+
+QString LatencyTracker::summary() const
+{
+    static const char *const labels[StageCount] = {"排队", "解码", "显示", "总计"};
+    QStringList parts;
+    for (int i = 0; i < StageCount; ++i) {
+        const LatencyHistogram &h = m_histograms[i];
+        parts << QString("%1 %2/%3/%4us").arg(labels[i])
+                     .arg(h.percentileUs(0.5)).arg(h.percentileUs(0.99)).arg(h.maxUs());
+    }
+    return parts.join("  ");
+}
@@ -0,0 +1,52 @@
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+
+#include <QtGlobal>
+#include <QString>
+#include "latencyhistogram.h"
+
+// 端到端延迟：每个样本在到达、出队（界面线程开始处理）、解码完成时打时间戳，
+// 表格或曲线视口真正绘制完成后，对本次绘制显示的最新样本记录显示延迟。
+// 各阶段：
+//   Queue    到达 -> 出队（CAN 为工作线程到界面线程的排队时间；串口为同一次读取内拆帧前的等待）
+//   Decode   出队 -> 解码完成（含重组）
+//   Display  解码完成 -> 显示刷新完成
+//   Total    到达 -> 显示刷新完成
+// 被后续样本覆盖、没有显示出来的样本只计入前两个阶段。
+class LatencyTracker
+{
+public:
+    enum Stage {
+        Queue = 0,
+        Decode,
+        Display,
+        Total,
+        StageCount
+    };
+
+    struct Stamp {
+        qint64 arrivalUs = 0;
+        qint64 dequeueUs = 0;
+        qint64 decodeUs = 0;
+    };
+
+    static const char *stageName(Stage stage);
+
+    // 一个样本解码完成
+    void sampleDecoded(const Stamp &stamp);
+    // 显示刷新完成：有尚未显示的样本时记录其显示延迟
+    void rendered(qint64 nowUs);
+    void reset();
+
+    const LatencyHistogram &histogram(Stage stage) const { return m_histograms[stage]; }
+
+    // 一行摘要："排队 p50/p99 … | 总计 …"
+    QString summary() const;
+
+private:
+    LatencyHistogram m_histograms[StageCount];
+    Stamp m_pending;
+    bool m_hasPending = false;
+};
+
+#endif // LATENCYTRACKER_H
@@ -0,0 +1,324 @@
+#include "log.h"
+#include "acqclock.h"
+#include <QDateTime>
+#include <QFile>
+#include <QSemaphore>
+#include <QStringList>
+#include <QThread>
+#include <cstdio>
+#include <memory>
+
+namespace Log {
+
+std::atomic<int> g_levels[CategoryCount] = {
+    {Warning},  // General
+    {Off},      // Serial
+    {Off},      // Frame
+    {Warning},  // Can
+};
+
+namespace {
+
+const char *const CATEGORY_NAMES[CategoryCount] = {"general", "serial", "frame", "can"};
+const char *const LEVEL_NAMES[] = {"debug", "info", "warning", "error", "off"};
+const char LEVEL_TAGS[] = {'D', 'I', 'W', 'E'};
+
+struct Entry {
+    qint64 timestampUs = 0;
+    quintptr threadId = 0;
+    Category category = General;
+    Level level = Info;
+    QString text;
+};
+
+// 有界多生产者单消费者队列：每个槽位带序号，生产者用 CAS 抢占写入位置
+class EntryQueue
+{
+public:
+    static constexpr quint64 CAPACITY = 16384;
+
+    EntryQueue()
+        : m_slots(new Slot[CAPACITY])
+    {
+        for (quint64 i = 0; i < CAPACITY; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(Entry &entry)
+    {
+        quint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true) {
+            slot = &m_slots[pos & (CAPACITY - 1)];
+            const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+            const qint64 diff = static_cast<qint64>(sequence - pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // 满
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->entry = std::move(entry);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只由后台线程调用
+    bool pop(Entry &entry)
+    {
+        Slot &slot = m_slots[m_dequeuePos & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) return false;
+        entry = std::move(slot.entry);
+        slot.entry.text.clear();
+        slot.sequence.store(m_dequeuePos + CAPACITY, std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<quint64> sequence;
+        Entry entry;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<quint64> m_enqueuePos{0};
+    alignas(64) quint64 m_dequeuePos = 0;
+};
+
+QByteArray formatEntry(const Entry &entry)
+{
+    const QDateTime time = QDateTime::fromMSecsSinceEpoch(AcqClock::toEpochMs(entry.timestampUs));
+    char prefix[64];
+    std::snprintf(prefix, sizeof(prefix), "%03d [%c] %s (%llx): ",
+                  static_cast<int>(entry.timestampUs % 1000), LEVEL_TAGS[entry.level],
+                  CATEGORY_NAMES[entry.category], static_cast<unsigned long long>(entry.threadId));
+    QByteArray line = time.toString("yyyy-MM-dd hh:mm:ss.zzz").toLatin1();
+    line.append(prefix);
+    line.append(entry.text.toUtf8());
+    line.append('\n');
+    return line;
+}
+
+// 后台写入线程
+class Sink : public QThread
+{
+public:
+    bool open(const QString &path, qint64 maxBytes, int maxFiles, QString *error)
+    {
+        if (m_file.isOpen()) m_file.close();
+        m_stopping.store(false);
+        m_path = path;
+        m_maxBytes = qMax<qint64>(64 * 1024, maxBytes);
+        m_maxFiles = qMax(1, maxFiles);
+        m_console = m_path == "-" ? stdout : stderr;
+        if (!m_path.isEmpty() && m_path != "-") {
+            m_file.setFileName(m_path);
+            if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+                if (error) *error = QString("无法打开日志文件 %1: %2").arg(m_path, m_file.errorString());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool push(Entry &entry)
+    {
+        if (!m_queue.push(entry)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // 只在后台线程空闲等待时唤醒，避免每条日志都做一次系统调用
+        if (m_idle.exchange(false, std::memory_order_acq_rel)) {
+            m_wake.release();
+        }
+        return true;
+    }
+
+    void stop()
+    {
+        m_stopping.store(true);
+        m_wake.release();
+        wait();
+        if (m_file.isOpen()) m_file.close();
+    }
+
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+protected:
+    void run() override
+    {
+        QByteArray batch;
+        Entry entry;
+        while (true) {
+            const bool stopping = m_stopping.load();
+            while (m_queue.pop(entry)) {
+                batch.append(formatEntry(entry));
+                if (batch.size() >= 64 * 1024) write(batch);
+            }
+            write(batch);
+            if (stopping) break;
+
+            // 先声明空闲再检查一次队列，防止漏掉声明之前入队的日志
+            m_idle.store(true, std::memory_order_release);
+            if (m_queue.pop(entry)) {
+                m_idle.store(false, std::memory_order_relaxed);
+                batch.append(formatEntry(entry));
+                continue;
+            }
+            m_wake.tryAcquire(1, 100);
+            m_idle.store(false, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    EntryQueue m_queue;
+    QSemaphore m_wake;
+    std::atomic<bool> m_idle{false};
+    std::atomic<bool> m_stopping{false};
+    std::atomic<quint64> m_dropped{0};
+    QString m_path;
+    qint64 m_maxBytes = 0;
+    int m_maxFiles = 1;
+    QFile m_file;
+    FILE *m_console = stderr;   // 不写文件时的输出
+
+    void write(QByteArray &batch)
+    {
+        if (batch.isEmpty()) return;
+        if (!m_file.isOpen()) {
+            std::fwrite(batch.constData(), 1, static_cast<size_t>(batch.size()), m_console);
+            std::fflush(m_console);
+        } else {
+            m_file.write(batch);
+            m_file.flush();
+            if (m_file.size() >= m_maxBytes) rotate();
+        }
+        batch.clear();
+    }
+
+    // path -> path.1 -> path.2 …，最旧的删除
+    void rotate()
+    {
+        m_file.close();
+        QFile::remove(QString("%1.%2").arg(m_path).arg(m_maxFiles));
+        for (int i = m_maxFiles - 1; i >= 1; --i) {
+            QFile::rename(QString("%1.%2").arg(m_path).arg(i), QString("%1.%2").arg(m_path).arg(i + 1));
+        }
+        QFile::rename(m_path, m_path + ".1");
+        m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+};
+
+// 进程内唯一，不析构：其他线程在退出过程中仍可能写日志
+Sink &sink()
+{
+    static Sink *instance = new Sink;
+    return *instance;
+}
+std::atomic<bool> s_running{false};
+
+} // namespace
+
+void setLevel(Category category, Level level)
+{
+    g_levels[category].store(level, std::memory_order_relaxed);
+}
+
+Level level(Category category)
+{
+    return static_cast<Level>(g_levels[category].load(std::memory_order_relaxed));
+}
+
+const char *categoryName(Category category)
+{
+    return category < CategoryCount ? CATEGORY_NAMES[category] : "unknown";
+}
+
+const char *levelName(Level level)
+{
+    return level <= Off ? LEVEL_NAMES[level] : "unknown";
+}
+
+bool applyLevelSpec(const QString &spec, QString *error)
+{
+    for (const QString &item : spec.split(',')) {
+        const QString trimmed = item.trimmed();
+        if (trimmed.isEmpty()) continue;
+
+        const QStringList parts = trimmed.split('=');
+        int levelIndex = -1;
+        if (parts.size() == 2) {
+            for (int i = 0; i <= Off; ++i) {
+                if (parts[1].trimmed().compare(LEVEL_NAMES[i], Qt::CaseInsensitive) == 0) levelIndex = i;
+            }
+        }
+        const QString name = parts.first().trimmed();
+        int categoryIndex = -1;
+        for (int i = 0; i < CategoryCount; ++i) {
+            if (name.compare(CATEGORY_NAMES[i], Qt::CaseInsensitive) == 0) categoryIndex = i;
+        }
+        const bool all = name.compare("all", Qt::CaseInsensitive) == 0;
+        if (levelIndex < 0 || (categoryIndex < 0 && !all)) {
+            if (error) *error = QString("日志级别配置无效: %1").arg(trimmed);
+            return false;
+        }
+
+        for (int i = 0; i < CategoryCount; ++i) {
+            if (all || i == categoryIndex) setLevel(static_cast<Category>(i), static_cast<Level>(levelIndex));
+        }
+    }
+    return true;
+}
+
+bool startSink(const QString &path, qint64 maxBytes, int maxFiles, QString *error)
+{
+    stopSink();
+    if (!sink().open(path, maxBytes, maxFiles, error)) return false;
+    sink().start(QThread::LowPriority);
+    s_running.store(true, std::memory_order_release);
+    return true;
+}
+
+void stopSink()
+{
+    // 停止之后入队的日志留在队列里，下次启动时写出
+    if (!s_running.exchange(false)) return;
+    sink().stop();
+}
+
+quint64 droppedCount()
+{
+    return sink().dropped();
+}
+
+Message::Message(Category category, Level level)
+    : m_category(category)
+    , m_level(level)
+{
+}
+
+Message::~Message()
+{
+    // QDebug 在每项之后补一个空格
+    if (m_text.endsWith(' ')) m_text.chop(1);
+
+    Entry entry;
+    entry.timestampUs = AcqClock::nowUs();
+    entry.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    entry.category = m_category;
+    entry.level = m_level;
+    entry.text = std::move(m_text);
+
+    if (s_running.load(std::memory_order_acquire)) {
+        sink().push(entry);
+    } else {
+        const QByteArray line = formatEntry(entry);
+        std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stderr);
+    }
+}
+
+} // namespace Log
@@ -1,26 +1,86 @@
 #pragma once
 #include <QDebug>
+#include <QString>
+#include <atomic>
 
-// ===== 日志开关 =====
-#define LOG_SERIAL   0
-#define LOG_FRAME    0
-#define LOG_ERROR    1
+// 调试日志：按类别在运行时设置级别，不需要重新编译。
+// 调用线程只做级别判断和文本格式化，然后放入无锁队列（多生产者单消费者）；
+// 写文件/标准输出由后台线程完成，队列满时丢弃并计数，不会阻塞采集线程。
+// 后台线程未启动时（startSink 之前）直接写标准错误。
+namespace Log {
+
+enum Category {
+    General = 0,
+    Serial,         // 串口命令收发
+    Frame,          // 逐帧数据（量大，默认关闭）
+    Can,            // CAN 驱动和通信
+    CategoryCount
+};
+
+enum Level {
+    Debug = 0,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+// 级别表：宏里直接读，避免函数调用
+extern std::atomic<int> g_levels[CategoryCount];
+inline bool isEnabled(Category category, Level level)
+{
+    return level >= g_levels[category].load(std::memory_order_relaxed);
+}
+void setLevel(Category category, Level level);
+Level level(Category category);
+
+const char *categoryName(Category category);
+const char *levelName(Level level);
+
+// 解析级别配置：逗号分隔的 类别=级别，类别可为 all，例如 "all=warning,frame=debug"。
+// 格式错误时返回 false，原因写入 error，已解析的部分仍然生效
+bool applyLevelSpec(const QString &spec, QString *error = nullptr);
+
+// 启动后台写入线程。path 为空时写标准错误，"-" 写标准输出；否则写文件，超过 maxBytes 时轮转为 path.1 … path.N
+bool startSink(const QString &path = QString(), qint64 maxBytes = 16 * 1024 * 1024, int maxFiles = 5,
+               QString *error = nullptr);
+// 写完队列中剩余的日志并停止后台线程
+void stopSink();
+
+// 队列满而丢弃的条数
+quint64 droppedCount();
+
+// 一条日志：析构时入队
+class Message
+{
+public:
+    Message(Category category, Level level);
+    ~Message();
+    QDebug stream() { return QDebug(&m_text).noquote(); }
+
+    Message(const Message &) = delete;
+    Message &operator=(const Message &) = delete;
+
+private:
+    Category m_category;
+    Level m_level;
+    QString m_text;
+};
+
+} // namespace Log
 
 // ===== 日志宏 =====
-#if LOG_SERIAL
-#define LOG_SERIAL_D(...) qDebug().noquote() << __VA_ARGS__
-#else
-#define LOG_SERIAL_D(...)
-#endif
-
-#if LOG_FRAME
-#define LOG_FRAME_D(...) qDebug().noquote() << __VA_ARGS__
-#else
-#define LOG_FRAME_D(...)
-#endif
-
-#if LOG_ERROR
-#define LOG_E(...) qWarning().noquote() << __VA_ARGS__
-#else
-#define LOG_E(...)
-#endif
+// 级别未开启时参数不会被求值
+#define LOG_AT(category, level, ...) \
+    do { \
+        if (Log::isEnabled(Log::category, Log::level)) { \
+            Log::Message logMessage_(Log::category, Log::level); \
+            logMessage_.stream() << __VA_ARGS__; \
+        } \
+    } while (0)
+
+#define LOG_SERIAL_D(...) LOG_AT(Serial, Debug, __VA_ARGS__)
+#define LOG_FRAME_D(...)  LOG_AT(Frame, Debug, __VA_ARGS__)
+#define LOG_CAN_I(...)    LOG_AT(Can, Info, __VA_ARGS__)
+#define LOG_CAN_W(...)    LOG_AT(Can, Warning, __VA_ARGS__)
+#define LOG_E(...)        LOG_AT(General, Error, __VA_ARGS__)
@@ -0,0 +1,271 @@
+#include "logmodel.h"
+#include "acqclock.h"
+#include "serialprotocol.h"
+#include <QBrush>
+#include <QColor>
+#include <QDateTime>
+#include <QIODevice>
+#include <QTextStream>
+#include <cstring>
+#include <utility>
+
+// LogModel 实现
+LogModel::LogModel(int capacity, qint64 maxBytes, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_capacity(qMax(1, capacity))
+    , m_maxBytes(qMax<qint64>(1024, maxBytes))
+{
+    m_ring.resize(m_capacity);
+}
+
+LogModel::Entry &LogModel::newPending(Severity severity, RecordType type)
+{
+    // 长时间不刷新时待刷新队列也不能无限增长：超过两倍容量时丢掉较旧的一半
+    if (m_pending.size() >= m_capacity * 2) {
+        m_pending.erase(m_pending.begin(), m_pending.begin() + m_capacity);
+        m_dropped += m_capacity;
+    }
+
+    const bool wasEmpty = m_pending.isEmpty();
+    m_pending.append(Entry());
+    Entry &entry = m_pending.last();
+    entry.timestampUs = AcqClock::nowUs();
+    entry.severity = severity;
+    entry.type = type;
+    if (wasEmpty) {
+        emit pendingAvailable();
+    }
+    return entry;
+}
+
+void LogModel::append(Severity severity, const QString &text)
+{
+    newPending(severity, TextRecord).text = text;
+}
+
+void LogModel::appendArmSample(Severity severity, quint16 armId, const float *values, int count)
+{
+    Entry &entry = newPending(severity, ArmSampleRecord);
+    entry.id = armId;
+    entry.count = static_cast<quint8>(qBound(0, count, static_cast<int>(CANProtocol::JOINTS_PER_ARM)));
+    std::memcpy(entry.payload.values, values, entry.count * sizeof(float));
+}
+
+void LogModel::appendSerialFrame(Severity severity, bool isSend, const QByteArray &frame)
+{
+    Entry &entry = newPending(severity, SerialFrameRecord);
+    entry.flags = isSend ? 1 : 0;
+    entry.frame = frame;
+}
+
+void LogModel::appendCanFrame(Severity severity, bool isSend, quint16 canId, const QByteArray &data)
+{
+    Entry &entry = newPending(severity, CanFrameRecord);
+    entry.flags = isSend ? 1 : 0;
+    entry.id = canId;
+    entry.count = static_cast<quint8>(qMin(data.size(), static_cast<int>(CANProtocol::CAN_MAX_DATA_LENGTH)));
+    std::memcpy(entry.payload.bytes, data.constData(), entry.count);
+}
+
+bool LogModel::flush()
+{
+    if (m_pending.isEmpty()) return false;
+
+    // 待刷新条目本身超过容量时只保留最新的部分
+    if (m_pending.size() > m_capacity) {
+        const int excess = m_pending.size() - m_capacity;
+        m_pending.erase(m_pending.begin(), m_pending.begin() + excess);
+        m_dropped += excess;
+    }
+
+    qint64 pendingBytes = 0;
+    for (const Entry &entry : m_pending) {
+        pendingBytes += entryBytes(entry);
+    }
+
+    // 先按条数、再按内存上限计算需要丢弃的旧条目
+    int toRemove = qMax(0, m_size + m_pending.size() - m_capacity);
+    qint64 remainingBytes = m_bytes;
+    for (int i = 0; i < toRemove; ++i) {
+        remainingBytes -= entryBytes(entryAt(i));
+    }
+    while (toRemove < m_size && remainingBytes + pendingBytes > m_maxBytes) {
+        remainingBytes -= entryBytes(entryAt(toRemove));
+        ++toRemove;
+    }
+    if (toRemove > 0) {
+        removeOldest(toRemove);
+    }
+
+    beginInsertRows(QModelIndex(), m_size, m_size + m_pending.size() - 1);
+    for (Entry &entry : m_pending) {
+        m_ring[(m_head + m_size) % m_capacity] = std::move(entry);
+        ++m_size;
+    }
+    m_bytes += pendingBytes;
+    endInsertRows();
+
+    m_pending.clear();
+    return true;
+}
+
+void LogModel::removeOldest(int count)
+{
+    count = qMin(count, m_size);
+    if (count <= 0) return;
+
+    beginRemoveRows(QModelIndex(), 0, count - 1);
+    for (int i = 0; i < count; ++i) {
+        Entry &entry = m_ring[(m_head + i) % m_capacity];
+        m_bytes -= entryBytes(entry);
+        entry.text = QString(); // 释放文本内存
+        entry.frame = QByteArray();
+    }
+    m_head = (m_head + count) % m_capacity;
+    m_size -= count;
+    m_dropped += count;
+    endRemoveRows();
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    for (Entry &entry : m_ring) {
+        entry.text = QString();
+        entry.frame = QByteArray();
+    }
+    m_head = 0;
+    m_size = 0;
+    m_bytes = 0;
+    m_pending.clear();
+    endResetModel();
+}
+
+bool LogModel::exportTo(QIODevice *device) const
+{
+    if (!device || !device->isWritable()) return false;
+
+    QTextStream out(device);
+    for (int row = 0; row < m_size; ++row) {
+        out << formatEntry(entryAt(row)) << '\n';
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+QString LogModel::formatEntry(const Entry &entry)
+{
+    const QDateTime time = QDateTime::fromMSecsSinceEpoch(AcqClock::toEpochMs(entry.timestampUs));
+    QString line = time.toString("[hh:mm:ss.zzz] ");
+
+    switch (entry.type) {
+    case ArmSampleRecord: {
+        line += (entry.id == 0) ? "收到左臂数据: " : "收到右臂数据: ";
+        for (int i = 0; i < entry.count; ++i) {
+            line += QString::number(entry.payload.values[i], 'f', 2);
+            if (i < entry.count - 1) line += ", ";
+        }
+        break;
+    }
+    case SerialFrameRecord: {
+        const QByteArray &data = entry.frame;
+        line += (entry.flags & 1) ? "发送数据: " : "接收数据: ";
+        if (data.size() >= 3 &&
+            static_cast<quint8>(data.at(0)) == static_cast<quint8>(SerialProtocol::FRAME_HEADER) &&
+            static_cast<quint8>(data.at(data.size() - 1)) == static_cast<quint8>(SerialProtocol::FRAME_TAIL)) {
+            const quint8 cmd = static_cast<quint8>(data.at(1));
+            line += QString("[0x%1 %2] ")
+                        .arg(cmd, 2, 16, QLatin1Char('0')).toUpper()
+                        .arg(SerialProtocol::commandName(cmd));
+        }
+        line += QString(data.toHex(' ').toUpper());
+        break;
+    }
+    case CanFrameRecord: {
+        const QByteArray data(reinterpret_cast<const char *>(entry.payload.bytes), entry.count);
+        QString armName;
+        switch (entry.id) {
+        case CANProtocol::CAN_ID_LEFT_ARM_REQUEST:  armName = "左臂"; break;
+        case CANProtocol::CAN_ID_RIGHT_ARM_REQUEST: armName = "右臂"; break;
+        case CANProtocol::CAN_ID_BOTH_ARMS_REQUEST: armName = "双臂"; break;
+        default: break;
+        }
+        if ((entry.flags & 1) && !armName.isEmpty()) {
+            line += QString("发送%1位置请求 (ID=0x%2)").arg(armName).arg(entry.id, 2, 16, QChar('0'));
+        } else {
+            line += QString("%1CAN帧 (ID=0x%2) Data=%3")
+                        .arg((entry.flags & 1) ? "发送" : "接收")
+                        .arg(entry.id, 2, 16, QChar('0'))
+                        .arg(QString(data.toHex(' ')));
+        }
+        break;
+    }
+    case TextRecord:
+    default:
+        line += entry.text;
+        break;
+    }
+    return line;
+}
+
+LogModel::Severity LogModel::severityFromType(const QString &type)
+{
+    if (type == "error") return Error;
+    if (type == "warning") return Warning;
+    if (type == "success") return Success;
+    if (type == "response") return Response;
+    if (type == "debug") return Debug;
+    return Info;
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_size;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_size) {
+        return QVariant();
+    }
+
+    const Entry &entry = entryAt(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        // 只有可见行才会被格式化
+        return formatEntry(entry);
+    case Qt::ForegroundRole:
+        // 与原先日志的颜色标识保持一致
+        switch (entry.severity) {
+        case Error:    return QBrush(QColor("red"));
+        case Success:  return QBrush(QColor("green"));
+        case Warning:  return QBrush(QColor("orange"));
+        case Response: return QBrush(QColor("blue"));
+        default:       return QVariant();
+        }
+    case SeverityRole:
+        return static_cast<int>(entry.severity);
+    default:
+        return QVariant();
+    }
+}
+
+// LogFilterProxyModel 实现
+LogFilterProxyModel::LogFilterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+}
+
+void LogFilterProxyModel::setMinimumSeverity(LogModel::Severity severity)
+{
+    if (severity == m_minimum) return;
+    m_minimum = severity;
+    invalidateFilter();
+}
+
+bool LogFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (m_minimum == LogModel::Debug) return true;
+    const QModelIndex idx = sourceModel()->index(sourceRow, 0, sourceParent);
+    return sourceModel()->data(idx, LogModel::SeverityRole).toInt() >= static_cast<int>(m_minimum);
+}
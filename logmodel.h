@@ -0,0 +1,127 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+#include "canprotocol.h"
+
+class QIODevice;
+
+// 日志模型：固定容量环形缓冲 + 批量刷新
+// append() 只把条目放入待刷新队列，flush() 时一次性插入视图（配合 QListView 虚拟化显示），
+// 超出条数上限或内存上限时从最旧的条目开始丢弃。
+// 高频记录（臂数据、收发帧）以紧凑的二进制形式保存，只有在显示或导出时才格式化为文本。
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Severity {
+        Debug = 0,
+        Info,
+        Response,
+        Success,
+        Warning,
+        Error
+    };
+    Q_ENUM(Severity)
+
+    enum Roles {
+        SeverityRole = Qt::UserRole + 1
+    };
+
+    // 记录类型
+    enum RecordType : quint8 {
+        TextRecord = 0,     // 普通文本
+        ArmSampleRecord,    // 单臂关节数据（id: 0=左臂, 1=右臂）
+        SerialFrameRecord,  // 串口收发帧
+        CanFrameRecord      // CAN收发帧（id: CAN ID）
+    };
+
+    explicit LogModel(int capacity = 5000, qint64 maxBytes = 4 * 1024 * 1024, QObject *parent = nullptr);
+
+    // 记录一条日志（不触发视图更新）
+    void append(Severity severity, const QString &text);
+
+    // 高频记录：只拷贝原始数值，不做任何格式化
+    void appendArmSample(Severity severity, quint16 armId, const float *values, int count);
+    void appendSerialFrame(Severity severity, bool isSend, const QByteArray &frame);
+    void appendCanFrame(Severity severity, bool isSend, quint16 canId, const QByteArray &data);
+
+    // 把待刷新条目一次性插入模型；返回是否有新条目
+    bool flush();
+    bool hasPending() const { return !m_pending.isEmpty(); }
+
+    void clear();
+
+    // 以文本形式导出当前所有条目（此时才格式化）
+    bool exportTo(QIODevice *device) const;
+
+    // 已丢弃的条目数（超过容量/内存上限）
+    quint64 droppedCount() const { return m_dropped; }
+
+    // CANCommunication::logMessage 的 type 字符串 -> 级别
+    static Severity severityFromType(const QString &type);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+signals:
+    // 待刷新队列由空变为非空（每批只发一次）
+    void pendingAvailable();
+
+private:
+    struct Entry {
+        qint64 timestampUs = 0;
+        Severity severity = Info;
+        RecordType type = TextRecord;
+        quint8 count = 0;   // values/bytes 中的有效个数
+        quint8 flags = 0;   // 帧记录: 1=发送
+        quint16 id = 0;
+        union Payload {
+            float values[CANProtocol::JOINTS_PER_ARM];
+            quint8 bytes[CANProtocol::CAN_MAX_DATA_LENGTH];
+        } payload = {};
+        QByteArray frame;   // 串口帧原始字节（隐式共享，不拷贝）
+        QString text;
+    };
+
+    int m_capacity;
+    qint64 m_maxBytes;
+    QVector<Entry> m_ring;
+    int m_head = 0;   // 最旧条目在环中的位置
+    int m_size = 0;
+    qint64 m_bytes = 0;
+    quint64 m_dropped = 0;
+
+    QVector<Entry> m_pending;
+
+    const Entry &entryAt(int row) const { return m_ring[(m_head + row) % m_capacity]; }
+    static qint64 entryBytes(const Entry &entry) { return sizeof(Entry) + entry.text.size() * 2 + entry.frame.size(); }
+    static QString formatEntry(const Entry &entry);
+    Entry &newPending(Severity severity, RecordType type);
+    void removeOldest(int count);
+};
+
+// 按最低级别过滤日志
+class LogFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit LogFilterProxyModel(QObject *parent = nullptr);
+
+    void setMinimumSeverity(LogModel::Severity severity);
+    LogModel::Severity minimumSeverity() const { return m_minimum; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    LogModel::Severity m_minimum = LogModel::Debug;
+};
+
+#endif // LOGMODEL_H
@@ -1,4 +1,6 @@
 #include "mainwindow.h"
+#include "trace.h"
+#include "log.h"
 
 #include <QApplication>
 #include <QStyleFactory>
@@ -6,6 +8,7 @@
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    TRACE_THREAD_NAME("gui");
 
     // 设置应用程序样式
     QApplication::setStyle(QStyleFactory::create("Fusion"));
@@ -15,7 +18,20 @@ int main(int argc, char *argv[])
     QApplication::setOrganizationName("YourCompany");
     QApplication::setApplicationVersion("1.0.0");
 
-    MainWindow w;
-    w.show();
-    return a.exec();
+    // 调试日志：LINKER_TA_LOG 设置级别（如 frame=debug），LINKER_TA_LOG_FILE 指定文件（默认标准错误）
+    QString logError;
+    if (!Log::applyLevelSpec(qEnvironmentVariable("LINKER_TA_LOG"), &logError) ||
+        !Log::startSink(qEnvironmentVariable("LINKER_TA_LOG_FILE"), 16 * 1024 * 1024, 5, &logError)) {
+        Log::startSink();
+        LOG_E(logError);
+    }
+
+    int result;
+    {
+        MainWindow w;
+        w.show();
+        result = a.exec();
+    }
+    Log::stopSink();
+    return result;
 }
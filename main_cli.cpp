@@ -0,0 +1,154 @@
+#include "capturecli.h"
+#include "trace.h"
+#include "log.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTimer>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+
+// Ctrl+C 只置标志，由事件循环里的定时器检查后正常停止（保证输出和录制文件完整）
+static std::atomic<bool> s_interrupted{false};
+
+static void onInterrupt(int)
+{
+    s_interrupted.store(true);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    TRACE_THREAD_NAME("main");
+    QCoreApplication::setApplicationName("Linker_TA_cli");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("遥操臂无界面采集工具");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption serialOption("serial", "串口名，如 /dev/ttyUSB0 或 COM3；可重复，多个串口同时采集", "port");
+    const QCommandLineOption workersOption("serial-workers", "多串口采集的工作线程数（默认 min(串口数, CPU 核数)）", "count", "0");
+    const QCommandLineOption baudOption("baud", "串口波特率（默认 2000000）", "rate", "2000000");
+    const QCommandLineOption lowLatencyOption("low-latency", "串口使用低延迟后端（仅 Linux：直接读写 tty，支持任意波特率）");
+    const QCommandLineOption canOption("can", "CAN 通道，如 PCAN_USBBUS1", "channel");
+    const QCommandLineOption bitrateOption("bitrate", "CAN 波特率（默认 1000000）", "bps", "1000000");
+    const QCommandLineOption pollOption("poll-ms", "CAN 轮询间隔（毫秒，默认 1）", "ms", "1");
+    const QCommandLineOption armOption("arm", "CAN 轮询的臂: left / right / both（默认 both）", "arm", "both");
+    const QCommandLineOption replayOption("replay", "回放录制文件", "file");
+    const QCommandLineOption speedOption("speed", "回放速度倍数，0 为尽可能快（默认 1）", "factor", "1");
+    const QCommandLineOption outputOption({"o", "output"}, "输出文件，- 为标准输出（默认）", "file", "-");
+    const QCommandLineOption binaryOption("binary", "以二进制记录输出（默认 CSV：每行 timestamp_us,[device,]arm,值…；"
+                                                    "both 为 14 个关节角，left/right 为 7 个，left_pose/right_pose 为 "
+                                                    "x,y,z,qw,qx,qy,qz）");
+    const QCommandLineOption recordOption("record", "同时录制原始帧到文件", "file");
+    const QCommandLineOption archiveOption("archive", "同时把输出的关节角写成列式归档（按时间分块、每关节一列、差分压缩）", "file");
+    const QCommandLineOption archiveResolutionOption("archive-resolution",
+                                                     "归档量化步长（°，默认自动：未滤波且未外推融合的 CAN 为 0.1，其余 0.001）", "deg", "0");
+    const QCommandLineOption archiveExportOption("archive-export", "把列式归档导出到输出（CSV 或 --binary）", "file");
+    const QCommandLineOption archiveChannelOption("archive-channel", "导出时只输出该通道（0 起）", "index", "-1");
+    const QCommandLineOption archiveFromOption("archive-from", "导出的起始时间（相对归档开始，秒）", "seconds", "0");
+    const QCommandLineOption archiveToOption("archive-to", "导出的结束时间（相对归档开始，秒，默认到结尾）", "seconds", "0");
+    const QCommandLineOption durationOption("duration", "采集时长（秒），到时自动退出", "seconds", "0");
+    const QCommandLineOption shmOption("shm", "发布最新臂状态到共享内存（默认不发布）");
+    const QCommandLineOption shmNameOption("shm-name", QString("共享内存名（默认 %1）").arg(ArmStateShm::DEFAULT_NAME),
+                                           "name", ArmStateShm::DEFAULT_NAME);
+    const QCommandLineOption streamOption("stream", "推送臂数据到接收端（可重复）: udp:HOST:PORT 或 unix:PATH", "target");
+    const QCommandLineOption streamBudgetOption("stream-budget-us", "推送批量发送的延迟预算（微秒，默认 2000）", "us", "2000");
+    const QCommandLineOption streamBatchOption("stream-batch", "每个数据报最多样本数（默认 16，最大 64）", "samples", "16");
+    const QCommandLineOption filterOption("filter", "关节角滤波，逗号组合: none / lowpass:HZ / median:N / oneeuro:MINCUT[:BETA]（默认 none）",
+                                          "spec", "none");
+    const QCommandLineOption kinematicsOption("kinematics", "运动学参数 JSON（见 armkinematics.h），额外输出 left_pose/right_pose 末端位姿",
+                                              "file");
+    const QCommandLineOption fuseOption("fuse", "CAN 左右臂配对为双臂样本输出，缺一半时: hold（保持）/ extrapolate（外推对齐）",
+                                        "mode");
+    const QCommandLineOption traceOption("trace", "开启性能追踪，退出时写出 Chrome trace JSON 到文件", "file");
+    const QCommandLineOption logLevelsOption("log-levels", "调试日志级别，如 all=warning,frame=debug（类别: general/serial/frame/can）",
+                                             "spec");
+    const QCommandLineOption logFileOption("log-file", "调试日志写入文件（超过 16MB 轮转），- 为标准输出（默认标准错误）", "file");
+    parser.addOptions({serialOption, workersOption, baudOption, lowLatencyOption, canOption, bitrateOption, pollOption, armOption,
+                       replayOption, speedOption, outputOption, binaryOption, recordOption, durationOption,
+                       archiveOption, archiveResolutionOption, archiveExportOption, archiveChannelOption,
+                       archiveFromOption, archiveToOption,
+                       shmOption, shmNameOption, streamOption, streamBudgetOption, streamBatchOption,
+                       filterOption, kinematicsOption, fuseOption, traceOption, logLevelsOption, logFileOption});
+    parser.process(app);
+
+    CaptureCli::Options options;
+    options.serialPorts = parser.values(serialOption);
+    options.serialWorkers = parser.value(workersOption).toInt();
+    options.baudRate = parser.value(baudOption).toInt();
+    options.lowLatencySerial = parser.isSet(lowLatencyOption);
+    options.canChannel = parser.value(canOption);
+    options.canBitrate = parser.value(bitrateOption).toUInt();
+    options.pollIntervalMs = qMax(1, parser.value(pollOption).toInt());
+    const QString arm = parser.value(armOption);
+    if (arm == "left") {
+        options.canArm = CANCommunication::LeftArm;
+    } else if (arm == "right") {
+        options.canArm = CANCommunication::RightArm;
+    } else {
+        options.canArm = CANCommunication::BothArms;
+    }
+    options.replayPath = parser.value(replayOption);
+    options.replaySpeed = parser.value(speedOption).toDouble();
+    options.outputPath = parser.value(outputOption);
+    options.binaryOutput = parser.isSet(binaryOption);
+    options.recordPath = parser.value(recordOption);
+    options.archivePath = parser.value(archiveOption);
+    options.archiveResolution = parser.value(archiveResolutionOption).toDouble();
+    options.archiveExportPath = parser.value(archiveExportOption);
+    options.archiveChannel = parser.value(archiveChannelOption).toInt();
+    options.archiveFromUs = qRound64(parser.value(archiveFromOption).toDouble() * 1000000.0);
+    options.archiveToUs = qRound64(parser.value(archiveToOption).toDouble() * 1000000.0);
+    options.durationMs = qRound(parser.value(durationOption).toDouble() * 1000.0);
+    if (parser.isSet(shmOption) || parser.isSet(shmNameOption)) {
+        options.shmName = parser.value(shmNameOption);
+    }
+    options.streamTargets = parser.values(streamOption);
+    options.streamLatencyBudgetUs = parser.value(streamBudgetOption).toInt();
+    options.streamBatchSamples = parser.value(streamBatchOption).toInt();
+    options.filterSpec = parser.value(filterOption);
+    options.kinematicsPath = parser.value(kinematicsOption);
+    options.tracePath = parser.value(traceOption);
+    if (parser.isSet(fuseOption)) {
+        const QString fuse = parser.value(fuseOption);
+        if (fuse != "hold" && fuse != "extrapolate") {
+            std::fprintf(stderr, "--fuse 只支持 hold / extrapolate\n");
+            return 1;
+        }
+        options.fuseArms = true;
+        options.fusionMode = fuse == "extrapolate" ? DualArmFusion::Extrapolate : DualArmFusion::HoldLast;
+    }
+
+    // 环境变量 LINKER_TA_LOG 与命令行相同格式，命令行优先
+    QString logError;
+    if (!Log::applyLevelSpec(qEnvironmentVariable("LINKER_TA_LOG"), &logError) ||
+        !Log::applyLevelSpec(parser.value(logLevelsOption), &logError) ||
+        !Log::startSink(parser.value(logFileOption), 16 * 1024 * 1024, 5, &logError)) {
+        std::fprintf(stderr, "%s\n", logError.toLocal8Bit().constData());
+        return 1;
+    }
+
+    CaptureCli cli(options);
+    if (!cli.start()) {
+        Log::stopSink();
+        return 1;
+    }
+
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    QTimer interruptTimer;
+    QObject::connect(&interruptTimer, &QTimer::timeout, &cli, [&cli]() {
+        if (s_interrupted.load()) {
+            cli.stop();
+        }
+    });
+    interruptTimer.start(50);
+
+    const int result = app.exec();
+    Log::stopSink();
+    return result;
+}
@@ -3,29 +3,49 @@
 #include "serialprotocol.h"
 #include "cancommunication.h"
 #include "log.h"
+#include "acqclock.h"
+#include "trace.h"
+#include "logmodel.h"
+#include "armtablemodel.h"
 #include <QSerialPortInfo>
 #include <QMessageBox>
 #include <QPushButton>
 #include <QDateTime>
-#include <QTextCursor>
+#include <QScrollBar>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QFileDialog>
+#include <QFile>
 #include <QtCharts/QChartView>
 #include <QIcon>
 #include <QHeaderView>
 #include <QAbstractItemView>
 #include <QGridLayout>
+#include <QEvent>
+#include <QVBoxLayout>
 #include <QRegularExpressionValidator>
+#include <cstring>
 
 // 构造函数
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , serialPort(new QSerialPort(this))
+    , serialLink(new SerialLink(this))
+    , serialPort(serialLink->port())
     , continuousTimer(new QTimer(this))
-    , chartUpdateTimer(new QTimer(this))
-    , armUpdateTimer(new QTimer(this))
+    , displayScheduler(new DisplayScheduler(this))
     , versionTimeoutTimer(new QTimer(this))
     , versionRetryTimer(new QTimer(this))
     , calibrateTimeoutTimer(new QTimer(this))
+    , logModel(new LogModel(5000, 4 * 1024 * 1024, this))
+    , logProxyModel(new LogFilterProxyModel(this))
+    , sessionRecorder(new SessionRecorder(this))
+    , sessionReplayer(new SessionReplayer(this))
+    , armStreamPublisher(new ArmStreamPublisher(this))
+    , trajectoryStreamer(new TrajectoryStreamer(this))
+    , leftTableModel(new ArmTableModel(0, {"旋转", "右摆", "右旋转", "上摆", "右旋转", "上摆", "右摆"}, 2, this))
+    , rightTableModel(new ArmTableModel(7, {"旋转", "左摆", "左旋转", "上摆", "左旋转", "上摆", "左摆"}, 2, this))
     , canComm(nullptr)
     , currentMode(CommunicationMode::Serial)
     , leftArmPollTimer(new QTimer(this))
@@ -34,13 +54,10 @@ MainWindow::MainWindow(QWidget *parent)
     , leftArmContinuousEnabled(false)
     , rightArmContinuousEnabled(false)
     , bothArmsContinuousEnabled(false)
-    , leftArmChart(new QChart())
-    , rightArmChart(new QChart())
-    , leftAxisX(new QDateTimeAxis())
-    , leftAxisY(new QValueAxis())
-    , rightAxisX(new QDateTimeAxis())
-    , rightAxisY(new QValueAxis())
+    , leftArmHistory(MAX_HISTORY)
+    , rightArmHistory(MAX_HISTORY)
 {
+    const qint64 startUs = AcqClock::nowUs();
     ui->setupUi(this);
 
     setWindowIcon(QIcon(":/icons/app_icon.png"));
@@ -58,10 +75,21 @@ MainWindow::MainWindow(QWidget *parent)
 
     // 刷新串口列表
     onPortsRefreshed();
+
+    // 启动耗时：构造完成，以及第一次回到事件循环（窗口已显示）
+    constructionUs = AcqClock::nowUs() - startUs;
+    QTimer::singleShot(0, this, [this, startUs]() {
+        logMessage(QString("启动耗时: 窗口构造 %1 ms, 首次进入事件循环 %2 ms")
+                       .arg(constructionUs / 1000.0, 0, 'f', 1)
+                       .arg((AcqClock::nowUs() - startUs) / 1000.0, 0, 'f', 1));
+    });
 }
 
 MainWindow::~MainWindow()
 {
+    trajectoryStreamer->stop();
+    sessionRecorder->close();
+    armStreamPublisher->close();
     cleanupCANCommunication();
     delete ui;
 }
@@ -75,8 +103,8 @@ void MainWindow::initUI()
     ui->baudRateComboBox->setEditable(true); // 允许手动输入
     ui->baudRateComboBox->addItems({"115200", "256000", "921600", "1000000", "2000000", "3000000"});
     ui->baudRateComboBox->setCurrentText("2000000");
-    // 设置验证器，只允许输入数字
-    ui->baudRateComboBox->setValidator(new QIntValidator(1200, 4000000, this));
+    // 设置验证器，只允许输入数字；低延迟模式下可以使用预设之外的任意波特率
+    ui->baudRateComboBox->setValidator(new QIntValidator(1200, 12000000, this));
 
     // 初始化数据位
     ui->dataBitsComboBox->addItems({"5", "6", "7", "8"});
@@ -94,11 +122,46 @@ void MainWindow::initUI()
     ui->flowControlComboBox->addItems({"None", "Hardware", "Software"});
     ui->flowControlComboBox->setCurrentIndex(0);
 
+    // 低延迟串口（仅 Linux）
+    ui->lowLatencyCheckBox->setVisible(SerialLink::lowLatencyAvailable());
+
     // 初始化ID选择
     for (int i = 0; i < 14; ++i) {
         ui->idComboBox->addItem(QString::number(i));
     }
 
+    // 关节角滤波预设
+    ui->filterComboBox->addItem("无滤波");
+    ui->filterComboBox->addItem("低通 5Hz");
+    ui->filterComboBox->addItem("中值(5) 去毛刺");
+    ui->filterComboBox->addItem("中值(5) + 低通 5Hz");
+    ui->filterComboBox->addItem("One-Euro 自适应");
+
+    // 轨迹类型：斜坡目标取“目标位置”，正弦幅值取“正弦幅值”（围绕当前位置 ±幅值），
+    // 速度/加速度/扭矩取对应输入框
+    ui->trajectoryComboBox->addItem("斜坡: 当前关节 2秒到目标位置");
+    ui->trajectoryComboBox->addItem("正弦: 当前关节 当前位置±幅值 0.5Hz 循环");
+    ui->trajectoryComboBox->addItem(QString("正弦: 全部关节 当前位置±幅值(≤%1°) 0.5Hz 循环")
+                                        .arg(MAX_ALL_JOINT_AMPLITUDE));
+    ui->trajectoryComboBox->addItem("录制文件: 14关节 循环");
+
+    // 日志视图：只渲染可见行
+    logProxyModel->setSourceModel(logModel);
+    ui->logView->setModel(logProxyModel);
+    ui->logLevelComboBox->addItem("全部日志", static_cast<int>(LogModel::Debug));
+    ui->logLevelComboBox->addItem("信息及以上", static_cast<int>(LogModel::Info));
+    ui->logLevelComboBox->addItem("警告及以上", static_cast<int>(LogModel::Warning));
+    ui->logLevelComboBox->addItem("仅错误", static_cast<int>(LogModel::Error));
+    ui->logLevelComboBox->setCurrentIndex(0);
+
+    // 回放速度（0 表示尽可能快）
+    ui->replaySpeedComboBox->addItem("原速", 1.0);
+    ui->replaySpeedComboBox->addItem("2倍速", 2.0);
+    ui->replaySpeedComboBox->addItem("5倍速", 5.0);
+    ui->replaySpeedComboBox->addItem("10倍速", 10.0);
+    ui->replaySpeedComboBox->addItem("最快", 0.0);
+    ui->replaySpeedComboBox->setCurrentIndex(0);
+
     // 初始化CAN ID输入验证 (Hex)
     QRegularExpression hexRegex("[0-9A-Fa-f]{1,3}");
     ui->canIdEdit->setValidator(new QRegularExpressionValidator(hexRegex, this));
@@ -123,32 +186,26 @@ void MainWindow::initUI()
         grid->setHorizontalSpacing(8);
     }
 
-    ui->leftArmTable->setColumnCount(2);
-    ui->leftArmTable->setRowCount(7);
-    QStringList leftHeaders;
-    leftHeaders << "关节" << "角度(°)";
-    ui->leftArmTable->setHorizontalHeaderLabels(leftHeaders);
+    ui->leftArmTable->setModel(leftTableModel);
     ui->leftArmTable->verticalHeader()->setVisible(false);
     ui->leftArmTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     ui->leftArmTable->setSelectionMode(QAbstractItemView::NoSelection);
     ui->leftArmTable->horizontalHeader()->setStretchLastSection(true);
 
-    ui->rightArmTable->setColumnCount(2);
-    ui->rightArmTable->setRowCount(7);
-    QStringList rightHeaders;
-    rightHeaders << "关节" << "角度(°)";
-    ui->rightArmTable->setHorizontalHeaderLabels(rightHeaders);
+    ui->rightArmTable->setModel(rightTableModel);
     ui->rightArmTable->verticalHeader()->setVisible(false);
     ui->rightArmTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     ui->rightArmTable->setSelectionMode(QAbstractItemView::NoSelection);
     ui->rightArmTable->horizontalHeader()->setStretchLastSection(true);
+    watchLatencyPaint(ui->leftArmTable->viewport());
+    watchLatencyPaint(ui->rightArmTable->viewport());
 
     ui->leftArmTable->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     ui->leftArmTable->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     int leftRowHeight = ui->leftArmTable->verticalHeader()->defaultSectionSize();
     int leftHeight = ui->leftArmTable->horizontalHeader()->height()
                      + ui->leftArmTable->frameWidth() * 2
-                     + leftRowHeight * ui->leftArmTable->rowCount();
+                     + leftRowHeight * leftTableModel->rowCount();
     ui->leftArmTable->setMinimumHeight(leftHeight);
     ui->leftArmTable->setMaximumHeight(leftHeight);
 
@@ -157,7 +214,7 @@ void MainWindow::initUI()
     int rightRowHeight = ui->rightArmTable->verticalHeader()->defaultSectionSize();
     int rightHeight = ui->rightArmTable->horizontalHeader()->height()
                       + ui->rightArmTable->frameWidth() * 2
-                      + rightRowHeight * ui->rightArmTable->rowCount();
+                      + rightRowHeight * rightTableModel->rowCount();
     ui->rightArmTable->setMinimumHeight(rightHeight);
     ui->rightArmTable->setMaximumHeight(rightHeight);
 
@@ -234,8 +291,19 @@ void MainWindow::initUI()
     newLayout->addWidget(new QLabel("轮询间隔(ms):", ui->canArmControlGroup), 3, 0);
     newLayout->addWidget(ui->pollIntervalSpinBox, 3, 1, 1, 2); // 跨两列
 
+    // 双臂持续获取时左右臂配对方式
+    newLayout->addWidget(new QLabel("双臂对齐:", ui->canArmControlGroup), 4, 0);
+    fusionModeComboBox = new QComboBox(ui->canArmControlGroup);
+    fusionModeComboBox->addItem("保持上一帧", DualArmFusion::HoldLast);
+    fusionModeComboBox->addItem("线性外推对齐", DualArmFusion::Extrapolate);
+    fusionModeComboBox->setToolTip("缺少一半时的补齐方式；外推时两半也对齐到同一时刻");
+    newLayout->addWidget(fusionModeComboBox, 4, 1, 1, 2);
+    connect(fusionModeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int) {
+        armFusion.setMode(static_cast<DualArmFusion::Mode>(fusionModeComboBox->currentData().toInt()));
+    });
+
     // 添加弹簧
-    newLayout->setRowStretch(4, 1);
+    newLayout->setRowStretch(5, 1);
     
     // 设置高精度定时器
     leftArmPollTimer->setTimerType(Qt::PreciseTimer);
@@ -244,19 +312,57 @@ void MainWindow::initUI()
 
     // 允许更小的轮询间隔
     ui->pollIntervalSpinBox->setMinimum(1);
+
+    // 状态栏：显示刷新率
+    QSpinBox *frameRateSpinBox = new QSpinBox(this);
+    frameRateSpinBox->setRange(1, 120);
+    frameRateSpinBox->setValue(DEFAULT_DISPLAY_FPS);
+    frameRateSpinBox->setPrefix("刷新率: ");
+    frameRateSpinBox->setSuffix(" Hz");
+    statusBar()->addPermanentWidget(frameRateSpinBox);
+    connect(frameRateSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), displayScheduler, &DisplayScheduler::setFrameRate);
 }
 
 void MainWindow::initCharts()
 {
+    leftDecimator.setWindow(CHART_WINDOW_US);
+    rightDecimator.setWindow(CHART_WINDOW_US);
+    leftPose.decimator.setWindow(CHART_WINDOW_US);
+    rightPose.decimator.setWindow(CHART_WINDOW_US);
+
+    // 曲线页先只放空页面，第一次切换到该页时才创建图表（只看表格的会话不需要这些序列和坐标轴）；
+    // 降采样器照常接收数据，创建后立即能画出历史曲线
+    chartTab = new QWidget(ui->tabWidget);
+    new QVBoxLayout(chartTab);
+    ui->tabWidget->addTab(chartTab, "关节曲线");
+
+    // 末端位姿页（加载运动学参数后才有数据）
+    poseTab = new QWidget(ui->tabWidget);
+    new QVBoxLayout(poseTab);
+    ui->tabWidget->addTab(poseTab, "末端位姿");
+}
+
+void MainWindow::ensureJointCharts()
+{
+    if (leftArmChart) return;
+
+    leftArmChart = new QChart();
+    rightArmChart = new QChart();
+    leftAxisX = new QDateTimeAxis();
+    leftAxisY = new QValueAxis();
+    rightAxisX = new QDateTimeAxis();
+    rightAxisY = new QValueAxis();
+
     // 左臂图表
     leftArmChart->setTitle("左臂关节角度");
-    leftArmChart->setAnimationOptions(QChart::SeriesAnimations);
+    // 曲线按帧整体替换，动画只会拖慢重绘
+    leftArmChart->setAnimationOptions(QChart::NoAnimation);
     leftArmChart->legend()->setVisible(true);
     leftArmChart->legend()->setAlignment(Qt::AlignBottom);
 
     // 右臂图表
     rightArmChart->setTitle("右臂关节角度");
-    rightArmChart->setAnimationOptions(QChart::SeriesAnimations);
+    rightArmChart->setAnimationOptions(QChart::NoAnimation);
     rightArmChart->legend()->setVisible(true);
     rightArmChart->legend()->setAlignment(Qt::AlignBottom);
 
@@ -287,7 +393,7 @@ void MainWindow::initCharts()
     }
 
     // 左臂坐标轴
-    leftAxisX->setFormat("hh:mm:ss");
+    leftAxisX->setFormat("hh:mm:ss.zzz");
     leftAxisX->setTitleText("时间");
     leftAxisY->setTitleText("角度 (°)");
     leftAxisY->setRange(-180, 180);
@@ -300,7 +406,7 @@ void MainWindow::initCharts()
     }
 
     // 右臂坐标轴
-    rightAxisX->setFormat("hh:mm:ss");
+    rightAxisX->setFormat("hh:mm:ss.zzz");
     rightAxisX->setTitleText("时间");
     rightAxisY->setTitleText("角度 (°)");
     rightAxisY->setRange(-180, 180);
@@ -311,6 +417,60 @@ void MainWindow::initCharts()
         series->attachAxis(rightAxisX);
         series->attachAxis(rightAxisY);
     }
+
+    QChartView *leftView = new QChartView(leftArmChart, chartTab);
+    QChartView *rightView = new QChartView(rightArmChart, chartTab);
+    chartTab->layout()->addWidget(leftView);
+    chartTab->layout()->addWidget(rightView);
+    watchLatencyPaint(leftView->viewport());
+    watchLatencyPaint(rightView->viewport());
+}
+
+void MainWindow::ensurePoseCharts()
+{
+    if (leftPose.chart) return;
+
+    initPoseChart(leftPose, "左臂末端位姿", "左");
+    initPoseChart(rightPose, "右臂末端位姿", "右");
+    QChartView *leftView = new QChartView(leftPose.chart, poseTab);
+    QChartView *rightView = new QChartView(rightPose.chart, poseTab);
+    poseTab->layout()->addWidget(leftView);
+    poseTab->layout()->addWidget(rightView);
+    watchLatencyPaint(leftView->viewport());
+    watchLatencyPaint(rightView->viewport());
+}
+
+void MainWindow::initPoseChart(PoseChart &pose, const QString &title, const QString &prefix)
+{
+    pose.chart = new QChart();
+    pose.chart->setTitle(title);
+    pose.chart->setAnimationOptions(QChart::NoAnimation);
+    pose.chart->legend()->setVisible(true);
+    pose.chart->legend()->setAlignment(Qt::AlignBottom);
+
+    pose.axisX = new QDateTimeAxis();
+    pose.axisX->setFormat("hh:mm:ss.zzz");
+    pose.axisX->setTitleText("时间");
+    pose.positionAxis = new QValueAxis();
+    pose.positionAxis->setTitleText("位置 (mm)");
+    pose.positionAxis->setRange(-1000, 1000);
+    pose.angleAxis = new QValueAxis();
+    pose.angleAxis->setTitleText("姿态 (°)");
+    pose.angleAxis->setRange(-180, 180);
+    pose.chart->addAxis(pose.axisX, Qt::AlignBottom);
+    pose.chart->addAxis(pose.positionAxis, Qt::AlignLeft);
+    pose.chart->addAxis(pose.angleAxis, Qt::AlignRight);
+
+    // 通道顺序与 ArmHistoryEntry::pose 一致
+    const QStringList names = {"X", "Y", "Z", "横滚", "俯仰", "偏航"};
+    for (int i = 0; i < POSE_CHANNELS; ++i) {
+        QLineSeries *series = new QLineSeries();
+        series->setName(prefix + names[i]);
+        pose.chart->addSeries(series);
+        series->attachAxis(pose.axisX);
+        series->attachAxis(i < 3 ? pose.positionAxis : pose.angleAxis);
+        pose.series.append(series);
+    }
 }
 
 void MainWindow::initConnections()
@@ -318,8 +478,19 @@ void MainWindow::initConnections()
     // 串口相关
     connect(ui->refreshPortsButton, &QPushButton::clicked, this, &MainWindow::onPortsRefreshed);
     connect(ui->connectButton, &QPushButton::clicked, this, &MainWindow::onConnectClicked);
-    connect(serialPort, &QSerialPort::readyRead, this, &MainWindow::onSerialDataReceived);
+    connect(serialLink, &SerialLink::frameReceived, this, &MainWindow::handleProtocolFrame);
+    connect(serialLink, &SerialLink::invalidFrame, this, [this]() {
+        logWarning("收到校验失败帧，已丢弃");
+    });
+    connect(serialLink, &SerialLink::bytesReceived, this, [this](const QByteArray &data, qint64 rxTimestampUs) {
+        sessionRecorder->recordSerialBytes(rxTimestampUs, false, data);
+    });
     connect(serialPort, &QSerialPort::errorOccurred, this, &MainWindow::onSerialErrorOccurred);
+    connect(serialLink, &SerialLink::errorOccurred, this, [this](const QString &error) {
+        closeSerialPort();
+        clearArmDataUI(); // 断开时清空表格
+        QMessageBox::critical(this, "错误", "串口错误: " + error);
+    });
 
     // 臂控制
     connect(ui->armGetButton, &QPushButton::clicked, this, &MainWindow::onArmGetClicked);
@@ -327,23 +498,84 @@ void MainWindow::initConnections()
     // 其他命令
     connect(ui->calibrateButton, &QPushButton::clicked, this, &MainWindow::onCalibrateClicked);
     connect(ui->clearLogButton, &QPushButton::clicked, this, &MainWindow::onClearLogClicked);
+    connect(ui->logLevelComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onLogLevelChanged);
+    connect(ui->exportLogButton, &QPushButton::clicked, this, &MainWindow::onExportLogClicked);
+    connect(ui->recordButton, &QPushButton::clicked, this, &MainWindow::onRecordClicked);
+    connect(sessionRecorder, &SessionRecorder::errorOccurred, this, [this](const QString &error) {
+        logModel->append(LogModel::Error, error);
+    });
+
+    // 会话回放：原始数据重新送入与实时接收相同的解码流程
+    connect(ui->replayButton, &QPushButton::clicked, this, &MainWindow::onReplayClicked);
+    connect(sessionReplayer, &SessionReplayer::serialBytes, serialLink, &SerialLink::feed);
+    connect(sessionReplayer, &SessionReplayer::canFrame, this, [this](const CANDataFrame &frame) {
+        initCANCommunication();
+        canComm->onFrameReceived(frame);
+    });
+    connect(sessionReplayer, &SessionReplayer::finished, this, &MainWindow::onReplayFinished);
+    connect(ui->shmPublishCheckBox, &QCheckBox::toggled, this, &MainWindow::onShmPublishToggled);
+    connect(ui->streamPublishCheckBox, &QCheckBox::toggled, this, &MainWindow::onStreamPublishToggled);
+    connect(ui->traceCheckBox, &QCheckBox::toggled, this, &MainWindow::onTraceToggled);
+    connect(ui->exportTraceButton, &QPushButton::clicked, this, &MainWindow::onExportTraceClicked);
+    connect(ui->latencyOverlayCheckBox, &QCheckBox::toggled, this, &MainWindow::onLatencyOverlayToggled);
+    connect(ui->exportLatencyButton, &QPushButton::clicked, this, &MainWindow::onExportLatencyClicked);
+    connect(ui->kinematicsButton, &QPushButton::clicked, this, &MainWindow::onLoadKinematicsClicked);
+    connect(armStreamPublisher, &ArmStreamPublisher::errorOccurred, this, [this](const QString &error) {
+        logModel->append(LogModel::Error, error);
+    });
+    connect(sessionReplayer, &SessionReplayer::errorOccurred, this, [this](const QString &error) {
+        logModel->append(LogModel::Error, error);
+    });
     connect(ui->sendCustomButton, &QPushButton::clicked, this, &MainWindow::onSendCustomMessageClicked);
 
     // 扭矩设置
     connect(ui->torqueSetButton, &QPushButton::clicked, this, &MainWindow::onTorqueSetClicked);
+    connect(ui->torqueSetAllButton, &QPushButton::clicked, this, &MainWindow::onTorqueSetAllClicked);
+    connect(ui->trajectoryButton, &QPushButton::clicked, this, &MainWindow::onTrajectoryClicked);
+    connect(ui->filterComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onFilterChanged);
+    connect(trajectoryStreamer, &QThread::finished, this, &MainWindow::onTrajectoryFinished);
+    connect(trajectoryStreamer, &TrajectoryStreamer::errorOccurred, this, [this](const QString &error) {
+        logModel->append(LogModel::Error, error);
+    });
+    connect(trajectoryStreamer, &TrajectoryStreamer::frameReady, this, [this](const QByteArray &frame, qint64 deadlineUs) {
+        // 高频下发不逐帧写日志，只计入发送统计和录制；帧在界面线程写出，写出时刻的抖动单独统计
+        if (serialLink->isOpen()) {
+            serialLink->write(frame);
+            const qint64 nowUs = AcqClock::nowUs();
+            trajectoryStreamer->frameWritten(deadlineUs, nowUs);
+            txStats[SerialStream].addSample(nowUs);
+            sessionRecorder->recordSerialBytes(nowUs, true, frame);
+        }
+        trajectoryStreamer->frameConsumed();
+    });
 
     // 定时器
     connect(continuousTimer, &QTimer::timeout, this, &MainWindow::onContinuousTimer);
-    connect(chartUpdateTimer, &QTimer::timeout, this, &MainWindow::updateCharts);
-    chartUpdateTimer->start(1000); // 每秒更新一次图表
-    connect(armUpdateTimer, &QTimer::timeout, this, &MainWindow::updateUIWithArmData);
-    if (!armUpdateTimer->isActive()) {
-        armUpdateTimer->start(500); // 0.5s refresh rate
-    }
+
+    // 显示帧调度：表格、曲线、状态栏、日志统一在显示节拍中刷新
+    // 状态栏频率文字每0.5s更新一次即可，曲线重绘代价较高限制为10Hz
+    displayScheduler->setFrameRate(DEFAULT_DISPLAY_FPS);
+    displayScheduler->setMinimumInterval(DisplayScheduler::Status, 500);
+    displayScheduler->setMinimumInterval(DisplayScheduler::Charts, 100);
+    connect(displayScheduler, &DisplayScheduler::frame, this, &MainWindow::onDisplayFrame);
+    connect(logModel, &LogModel::pendingAvailable, this, [this]() {
+        displayScheduler->markDirty(DisplayScheduler::Log);
+    });
+    connect(ui->tabWidget, &QTabWidget::currentChanged, this, [this](int) {
+        QWidget *current = ui->tabWidget->currentWidget();
+        if (current == chartTab) {
+            ensureJointCharts();
+        } else if (current == poseTab) {
+            ensurePoseCharts();
+        } else {
+            return;
+        }
+        displayScheduler->markDirty(DisplayScheduler::Charts);
+    });
 
     versionTimeoutTimer->setSingleShot(true);
     connect(versionTimeoutTimer, &QTimer::timeout, [this]() {
-        logMessage("获取版本失败：超时，未收到版本响应");
+        logError("获取版本失败：超时，未收到版本响应");
         showStatusMessage("获取版本失败：版本读取超时");
     });
 
@@ -382,7 +614,7 @@ void MainWindow::initConnections()
     connect(calibrateTimeoutTimer, &QTimer::timeout, [this]() {
         calibrating = false;
         updateCalibrateButtonState();
-        logMessage("零点标定失败：超时，未收到标定响应");
+        logError("零点标定失败：超时，未收到标定响应");
         showStatusMessage("零点标定失败：标定响应超时");
     });
 }
@@ -408,7 +640,7 @@ void MainWindow::onPortsRefreshed()
         ui->connectButton->setEnabled(true);
     }
     
-    if (!serialPort->isOpen()) {
+    if (!serialLink->isOpen()) {
         ui->connectButton->setText("连接");
         ui->connectButton->setStyleSheet("background-color: red; color: white;");
     }
@@ -416,7 +648,7 @@ void MainWindow::onPortsRefreshed()
 
 void MainWindow::onConnectClicked()
 {
-    if (serialPort->isOpen()) {
+    if (serialLink->isOpen()) {
         closeSerialPort();
     } else {
         openSerialPort();
@@ -425,8 +657,8 @@ void MainWindow::onConnectClicked()
 
 void MainWindow::openSerialPort()
 {
-    if (serialPort->isOpen()) {
-        serialPort->close();
+    if (serialLink->isOpen()) {
+        serialLink->close();
     }
 
     QString portName = ui->portComboBox->currentData().toString();
@@ -475,7 +707,9 @@ void MainWindow::openSerialPort()
     default: serialPort->setFlowControl(QSerialPort::NoFlowControl); break;
     }
 
-    if (serialPort->open(QIODevice::ReadWrite)) {
+    const SerialLink::Backend backend = ui->lowLatencyCheckBox->isChecked()
+        ? SerialLink::LowLatencyBackend : SerialLink::QtBackend;
+    if (serialLink->open(backend)) {
         ui->connectButton->setText("断开");
         ui->connectButton->setStyleSheet("background-color: green; color: white;");
         ui->portComboBox->setEnabled(false);
@@ -484,10 +718,15 @@ void MainWindow::openSerialPort()
         ui->parityComboBox->setEnabled(false);
         ui->stopBitsComboBox->setEnabled(false);
         ui->flowControlComboBox->setEnabled(false);
+        ui->lowLatencyCheckBox->setEnabled(false);
         ui->refreshPortsButton->setEnabled(false);
 
-        showStatusMessage("串口已连接: " + portName);
-        logMessage("串口已连接: " + portName);
+        const QString mode = backend == SerialLink::LowLatencyBackend ? "（低延迟模式）" : "";
+        showStatusMessage("串口已连接: " + portName + mode);
+        logMessage("串口已连接: " + portName + mode);
+
+        // 新设备重新尝试多关节扭矩命令
+        multiTorqueSupported = true;
         setOperationButtonsEnabled(true);
         ui->armGetButton->setText("获取");
         ui->armGetButton->setStyleSheet("background-color: red; color: white;");
@@ -499,20 +738,21 @@ void MainWindow::openSerialPort()
             versionRetryTimer->start(1000);
         }
     } else {
-        QMessageBox::critical(this, "错误", "无法打开串口: " + serialPort->errorString());
+        QMessageBox::critical(this, "错误", "无法打开串口: " + serialLink->errorString());
     }
 }
 
 void MainWindow::closeSerialPort()
 {
-    if (serialPort->isOpen()) {
+    trajectoryStreamer->stop();
+    if (serialLink->isOpen()) {
         if (streamEnabled) {
             QByteArray cmd = SerialProtocol::buildDisableDataStreamCommand();
             writeData(cmd);
             logMessage("已发送：禁用遥操臂数据推送（串口断开前）");
         }
 
-        serialPort->close();
+        serialLink->close();
 
         ui->connectButton->setText("连接");
         ui->connectButton->setStyleSheet("background-color: red; color: white;");
@@ -522,10 +762,10 @@ void MainWindow::closeSerialPort()
         ui->parityComboBox->setEnabled(true);
         ui->stopBitsComboBox->setEnabled(true);
         ui->flowControlComboBox->setEnabled(true);
+        ui->lowLatencyCheckBox->setEnabled(true);
         ui->refreshPortsButton->setEnabled(true);
 
         continuousTimer->stop();
-        armUpdateTimer->stop();
         stopVersionTimeout();
         stopCalibrateTimeout();
         if (versionRetryTimer->isActive()) {
@@ -551,46 +791,24 @@ void MainWindow::closeSerialPort()
     }
 }
 
-void MainWindow::onSerialDataReceived()
-{
-    const QByteArray data = serialPort->readAll();
-    if (data.isEmpty()) return;
-
-    rxBuffer.append(data);
-
-    // 循环拆帧：处理粘包/拆包
-    while (true) {
-        const auto optFrame = SerialProtocol::tryExtractFrame(rxBuffer);
-        if (!optFrame.has_value()) break;
-
-        const SerialProtocol::Frame &frame = optFrame.value();
-        if (!SerialProtocol::validateFrame(frame)) {
-            logMessage("收到校验失败帧，已丢弃");
-            continue;
-        }
-        handleProtocolFrame(frame);
-    }
-}
-
-void MainWindow::handleProtocolFrame(const SerialProtocol::Frame &frame)
+void MainWindow::handleProtocolFrame(const SerialProtocol::Frame &frame, qint64 timestampUs)
 {
     // 协议说明：推送数据为 56字节 float(小端)，无响应；响应帧数据区第1字节为结果码
     if (frame.dataLength == 56) {
-        if (!acceptingStream) return;
+        if (!serialStreamActive()) return;
 
+        LatencyTracker::Stamp stamp;
+        stamp.arrivalUs = timestampUs;
+        stamp.dequeueUs = AcqClock::nowUs();
         QVector<float> armData;
         if (SerialProtocol::parseArmData(frame.data, armData) && armData.size() == 14) {
-            QByteArray raw;
-            raw.append(SerialProtocol::FRAME_HEADER);
-            raw.append(static_cast<char>(frame.cmdType));
-            raw.append(static_cast<char>(frame.dataLength));
-            raw.append(frame.data);
-            raw.append(static_cast<char>(frame.checksum));
-            raw.append(SerialProtocol::FRAME_TAIL);
-            LOG_FRAME_D("Arm push frame:" << raw.toHex(' ').toUpper());
-            processArmData(armData);
+            stamp.decodeUs = AcqClock::nowUs();
+            serialLatency.sampleDecoded(stamp);
+            // 宏关闭时参数不会被求值，不产生任何拷贝
+            LOG_FRAME_D("Arm push frame:" << SerialProtocol::serializeFrame(frame).toHex(' ').toUpper());
+            processArmData(armData, timestampUs);
         } else {
-            logMessage("推送数据解析失败（非56字节float序列）");
+            logError("推送数据解析失败（非56字节float序列）");
         }
         return;
     }
@@ -609,13 +827,13 @@ void MainWindow::handleProtocolFrame(const SerialProtocol::Frame &frame)
             logMessage(okText);
             showStatusMessage(okText);
         } else if (result == SerialProtocol::RESULT_CHECKSUM_ERROR) {
-            logMessage(failText + "（校验和错误）");
+            logError(failText + "（校验和错误）");
             showStatusMessage(failText + "（校验和错误）");
         } else if (result == SerialProtocol::RESULT_UNKNOWN_CMD) {
-            logMessage(failText + "（未知命令）");
+            logError(failText + "（未知命令）");
             showStatusMessage(failText + "（未知命令）");
         } else {
-            logMessage(failText + QString("（结果码0x%1）").arg(result, 2, 16, QLatin1Char('0')).toUpper());
+            logError(failText + QString("（结果码0x%1）").arg(result, 2, 16, QLatin1Char('0')).toUpper());
             showStatusMessage(failText);
         }
     };
@@ -628,8 +846,33 @@ void MainWindow::handleProtocolFrame(const SerialProtocol::Frame &frame)
         okFailText("零点标定成功", "零点标定失败");
         break;
     case SerialProtocol::CMD_TORQUE_CONTROL:
+        if (trajectoryStreamer->isStreaming()) {
+            trajectoryAck(result, "扭矩设置失败");
+            break;
+        }
         okFailText("扭矩设置成功", "扭矩设置失败");
         break;
+    case SerialProtocol::CMD_TORQUE_CONTROL_MULTI:
+        if (result == SerialProtocol::RESULT_UNKNOWN_CMD && multiTorqueSupported) {
+            // 旧固件：之后改为逐关节单帧发送
+            multiTorqueSupported = false;
+            logWarning("下位机不支持多关节扭矩命令，改为逐关节发送");
+            if (trajectoryStreamer->isStreaming()) {
+                // 轨迹下发中：从下一帧起改用单帧格式，设定值由轨迹继续给出
+                trajectoryStreamer->setMultiJointFrames(false);
+            } else {
+                // 按钮发出的设定值：补发本次设定值
+                writeData(SerialProtocol::buildTorqueControlCommands(lastMultiTorqueSetpoints));
+            }
+            lastMultiTorqueSetpoints.clear();
+            break;
+        }
+        if (trajectoryStreamer->isStreaming()) {
+            trajectoryAck(result, "多关节扭矩设置失败");
+            break;
+        }
+        okFailText("多关节扭矩设置成功", "多关节扭矩设置失败");
+        break;
     case SerialProtocol::CMD_ENABLE_DATA_STREAM:
         if (result == SerialProtocol::RESULT_SUCCESS) {
             streamEnabled = true;
@@ -663,16 +906,8 @@ void MainWindow::handleProtocolFrame(const SerialProtocol::Frame &frame)
         if (payload.size() == 56) {
             QVector<float> armData;
             if (SerialProtocol::parseArmData(payload, armData) && armData.size() == 14) {
-                QByteArray raw;
-                raw.append(SerialProtocol::FRAME_HEADER);
-                raw.append(static_cast<char>(frame.cmdType));
-                raw.append(static_cast<char>(frame.dataLength));
-                raw.append(frame.data);
-                raw.append(static_cast<char>(frame.checksum));
-                raw.append(SerialProtocol::FRAME_TAIL);
-                LOG_FRAME_D("Arm resp frame:" << raw.toHex(' ').toUpper());
-                processArmData(armData);
-                updateUIWithArmData();
+                LOG_FRAME_D("Arm resp frame:" << SerialProtocol::serializeFrame(frame).toHex(' ').toUpper());
+                processArmData(armData, timestampUs);
             }
         } else {
             okFailText("获取臂数据成功", "获取臂数据失败");
@@ -689,9 +924,18 @@ void MainWindow::handleProtocolFrame(const SerialProtocol::Frame &frame)
     }
 }
 
+void MainWindow::trajectoryAck(quint8 result, const QString &failText)
+{
+    // 轨迹下发时每帧都有应答：只计数，第一条失败写日志，其余在结束时汇总
+    if (trajectoryStreamer->recordAck(result == SerialProtocol::RESULT_SUCCESS)) {
+        logError(failText + QString("（轨迹下发中，结果码0x%1，后续失败只计数）")
+                                  .arg(result, 2, 16, QLatin1Char('0')).toUpper());
+    }
+}
+
 void MainWindow::ensureStreamEnabled()
 {
-    if (!serialPort->isOpen()) {
+    if (!serialLink->isOpen()) {
         QMessageBox::warning(this, "警告", "串口未连接");
         return;
     }
@@ -704,7 +948,7 @@ void MainWindow::ensureStreamEnabled()
 void MainWindow::onSerialErrorOccurred(QSerialPort::SerialPortError error)
 {
     if (error != QSerialPort::NoError && error != QSerialPort::ResourceError) {
-        logMessage("串口错误: " + serialPort->errorString());
+        logError("串口错误: " + serialPort->errorString());
         showStatusMessage("串口错误: " + serialPort->errorString());
     }
 
@@ -717,8 +961,11 @@ void MainWindow::onSerialErrorOccurred(QSerialPort::SerialPortError error)
 
 void MainWindow::writeData(const QByteArray &data)
 {
-    if (serialPort->isOpen()) {
-        serialPort->write(data);
+    if (serialLink->isOpen()) {
+        serialLink->write(data);
+        const qint64 nowUs = AcqClock::nowUs();
+        txStats[SerialStream].addSample(nowUs);
+        sessionRecorder->recordSerialBytes(nowUs, true, data);
         logHexData(data, true);
     } else {
         QMessageBox::warning(this, "警告", "串口未连接");
@@ -727,7 +974,7 @@ void MainWindow::writeData(const QByteArray &data)
 
 void MainWindow::onArmGetClicked()
 {
-    if (!serialPort->isOpen()) {
+    if (!serialLink->isOpen()) {
         QMessageBox::warning(this, "警告", "串口未连接");
         return;
     }
@@ -738,10 +985,8 @@ void MainWindow::onArmGetClicked()
         updateCalibrateButtonState(); // 数据推送开启时更新校准按钮状态
 
         // 重置统计
-        serialStartTime = QDateTime::currentMSecsSinceEpoch();
-        serialRxCount = 0;
+        resetStreamStats(SerialStream);
 
-        armUpdateTimer->start(500);
         ui->armGetButton->setText("停止");
         ui->armGetButton->setStyleSheet("background-color: green; color: white;");
         logMessage("臂数据：开始获取（接收推送数据）");
@@ -749,20 +994,12 @@ void MainWindow::onArmGetClicked()
     } else {
         QByteArray cmd = SerialProtocol::buildDisableDataStreamCommand();
         writeData(cmd);
-        armUpdateTimer->stop();
         acceptingStream = false;
         updateCalibrateButtonState(); // 数据推送关闭时更新校准按钮状态
         
-        // 计算并显示最终频率
-        qint64 duration = QDateTime::currentMSecsSinceEpoch() - serialStartTime;
-        double freq = 0;
-        if (duration > 0) {
-            freq = (double)serialRxCount * 1000.0 / duration;
-        }
-        
         ui->armGetButton->setText("获取");
         ui->armGetButton->setStyleSheet("background-color: #F44336; color: white;");
-        logMessage(QString("臂数据：已停止获取，平均接收频率: %1 Hz").arg(freq, 0, 'f', 2));
+        logMessage(QString("臂数据：已停止获取，%1").arg(formatStreamStats(SerialStream, AcqClock::nowUs())));
         showStatusMessage("臂数据获取已停止");
     }
 }
@@ -795,7 +1032,7 @@ void MainWindow::onCalibrateClicked()
 
 void MainWindow::onClearLogClicked()
 {
-    ui->logTextEdit->clear();
+    logModel->clear();
 }
 
 void MainWindow::onSendCustomMessageClicked()
@@ -862,13 +1099,197 @@ void MainWindow::onTorqueSetClicked()
     LOG_SERIAL_D("Torque command:" << cmd.toHex(' ').toUpper());
 }
 
-void MainWindow::processArmData(const QVector<float> &armData)
+void MainWindow::onTrajectoryClicked()
+{
+    if (trajectoryStreamer->isStreaming()) {
+        trajectoryStreamer->stop();
+        return;
+    }
+    if (!serialLink->isOpen()) {
+        QMessageBox::warning(this, "警告", "串口未连接");
+        return;
+    }
+
+    Trajectory trajectory;
+    if (!buildSelectedTrajectory(trajectory)) return;
+
+    TrajectoryStreamer::Options options;
+    options.rateHz = ui->trajectoryRateSpinBox->value();
+    options.speed = ui->speedSpinBox->value();
+    options.acceleration = ui->accelerationSpinBox->value();
+    options.torque = ui->torqueSpinBox->value();
+    options.multiJointFrames = multiTorqueSupported;
+    options.loop = ui->trajectoryComboBox->currentIndex() != 0;
+    options.linkBaudRate = serialPort->baudRate();
+    if (!trajectoryStreamer->startTrajectory(trajectory, options)) return;
+
+    ui->trajectoryButton->setText("停止轨迹");
+    ui->trajectoryComboBox->setEnabled(false);
+    ui->trajectoryRateSpinBox->setEnabled(false);
+    ui->trajectoryAmplitudeSpinBox->setEnabled(false);
+    const TrajectoryStreamer::Stats stats = trajectoryStreamer->stats();
+    logMessage(QString("开始轨迹下发: %1个关节, %2Hz, 每帧%3字节, 链路占用%4%")
+                   .arg(trajectory.jointCount()).arg(stats.targetRateHz, 0, 'f', 1)
+                   .arg(stats.frameBytes).arg(stats.linkUtilization * 100.0, 0, 'f', 1));
+}
+
+bool MainWindow::buildSelectedTrajectory(Trajectory &trajectory)
+{
+    const float target = ui->positionSpinBox->value();
+    const float amplitude = ui->trajectoryAmplitudeSpinBox->value();
+    const quint8 id = static_cast<quint8>(ui->idComboBox->currentText().toInt());
+
+    // 当前关节位置：使用最近收到的臂数据，没有数据时从 0 开始
+    const auto currentPosition = [this](int joint) {
+        const QVector<float> &arm = joint < 7 ? leftArmData : rightArmData;
+        const int index = joint % 7;
+        return index < arm.size() ? arm[index] : 0.0f;
+    };
+
+    switch (ui->trajectoryComboBox->currentIndex()) {
+    case 0:
+        trajectory = Trajectory::ramp({id}, {currentPosition(id)}, {target}, 2000000);
+        return true;
+    case 1:
+        trajectory = Trajectory::sinusoid({id}, {currentPosition(id)}, {amplitude}, 0.5, 2000000);
+        logMessage(QString("正弦轨迹: 关节%1 围绕 %2° 摆动 ±%3°")
+                       .arg(id).arg(currentPosition(id), 0, 'f', 2).arg(amplitude, 0, 'f', 2));
+        return true;
+    case 2: {
+        QVector<quint8> ids(14);
+        QVector<float> center(14);
+        for (int i = 0; i < 14; ++i) {
+            ids[i] = static_cast<quint8>(i);
+            center[i] = currentPosition(i);
+        }
+        const float allAmplitude = qMin(amplitude, MAX_ALL_JOINT_AMPLITUDE);
+        if (allAmplitude < amplitude) {
+            logWarning(QString("全部关节正弦幅值 %1° 超过上限，按 %2° 下发")
+                           .arg(amplitude, 0, 'f', 2).arg(allAmplitude, 0, 'f', 2));
+        }
+        trajectory = Trajectory::sinusoid(ids, center, QVector<float>(14, allAmplitude), 0.5, 2000000);
+        logMessage(QString("正弦轨迹: 全部14个关节围绕各自当前位置摆动 ±%1°").arg(allAmplitude, 0, 'f', 2));
+        return true;
+    }
+    default: {
+        const QString fileName = QFileDialog::getOpenFileName(this, "选择轨迹录制文件", QString(),
+                                                              "会话录制 (*.ltarec)");
+        if (fileName.isEmpty()) return false;
+        QString error;
+        if (!Trajectory::fromSession(fileName, trajectory, &error)) {
+            logModel->append(LogModel::Error, error);
+            return false;
+        }
+        return true;
+    }
+    }
+}
+
+void MainWindow::onTrajectoryFinished()
+{
+    ui->trajectoryButton->setText("开始轨迹");
+    ui->trajectoryComboBox->setEnabled(true);
+    ui->trajectoryRateSpinBox->setEnabled(true);
+    ui->trajectoryAmplitudeSpinBox->setEnabled(true);
+
+    const TrajectoryStreamer::Stats stats = trajectoryStreamer->stats();
+    logMessage(QString("轨迹下发结束: %1帧, 迟到 p50/p99/最大 %2/%3/%4us, 写出迟到 p50/p99/最大 %5/%6/%7us, "
+                       "错过截止 %8, 积压跳过 %9, 应答成功/失败 %10/%11")
+                   .arg(stats.frames).arg(stats.p50LatenessUs).arg(stats.p99LatenessUs).arg(stats.maxLatenessUs)
+                   .arg(stats.p50WriteLatenessUs).arg(stats.p99WriteLatenessUs).arg(stats.maxWriteLatenessUs)
+                   .arg(stats.missedDeadlines).arg(stats.skippedFrames)
+                   .arg(stats.acksOk).arg(stats.acksFailed));
+}
+
+void MainWindow::onFilterChanged(int index)
+{
+    JointFilter::JointConfig config;
+    int medianWindow = 1;
+    switch (index) {
+    case 1:
+        config.smoothing = JointFilter::LowPass;
+        config.cutoffHz = 5.0f;
+        break;
+    case 2:
+        config.median = true;
+        medianWindow = 5;
+        break;
+    case 3:
+        config.median = true;
+        medianWindow = 5;
+        config.smoothing = JointFilter::LowPass;
+        config.cutoffHz = 5.0f;
+        break;
+    case 4:
+        config.smoothing = JointFilter::OneEuro;
+        config.minCutoffHz = 1.0f;
+        config.beta = 0.05f;
+        break;
+    default:
+        break;
+    }
+
+    for (JointFilter *filter : {&leftArmFilter, &rightArmFilter}) {
+        filter->setAllJoints(config);
+        filter->setMedianWindow(medianWindow);
+        filter->reset();
+    }
+    logMessage("关节角滤波: " + ui->filterComboBox->itemText(index));
+}
+
+void MainWindow::onTorqueSetAllClicked()
+{
+    // 所有关节使用同一组参数，一帧发出
+    QVector<SerialProtocol::JointSetpoint> setpoints(ui->idComboBox->count());
+    for (int i = 0; i < setpoints.size(); ++i) {
+        setpoints[i].id = static_cast<quint8>(ui->idComboBox->itemText(i).toInt());
+        setpoints[i].position = ui->positionSpinBox->value();
+        setpoints[i].speed = ui->speedSpinBox->value();
+        setpoints[i].acceleration = ui->accelerationSpinBox->value();
+        setpoints[i].torque = ui->torqueSpinBox->value();
+    }
+
+    if (!sendTorqueSetpoints(setpoints)) {
+        QMessageBox::warning(this, "警告", "串口未连接");
+        return;
+    }
+    logMessage(QString("扭矩设置: 全部%1个关节, 位置=%2, 速度=%3, 加速度=%4, 扭矩=%5")
+                   .arg(setpoints.size()).arg(ui->positionSpinBox->value()).arg(ui->speedSpinBox->value())
+                   .arg(ui->accelerationSpinBox->value()).arg(ui->torqueSpinBox->value()));
+}
+
+bool MainWindow::sendTorqueSetpoints(const QVector<SerialProtocol::JointSetpoint> &setpoints)
+{
+    if (!serialLink->isOpen()) return false;
+    if (setpoints.isEmpty()) return true;
+
+    if (multiTorqueSupported) {
+        // 保留最近一次设定值：下位机不支持多关节命令时用单帧重发
+        lastMultiTorqueSetpoints = setpoints;
+        writeData(SerialProtocol::buildMultiTorqueControlCommand(setpoints));
+    } else {
+        writeData(SerialProtocol::buildTorqueControlCommands(setpoints));
+    }
+    return true;
+}
+
+void MainWindow::processArmData(const QVector<float> &armData, qint64 timestampUs)
 {
     if (armData.size() < 14) return;
+    TRACE_SCOPE_ARG(ArmProcess, SessionFormat::BothArms);
 
-    // 更新无线接收计数
-    if (currentMode == CommunicationMode::Serial && acceptingStream) {
-        serialRxCount++;
+    // 更新无线接收统计
+    if (currentMode == CommunicationMode::Serial && serialStreamActive()) {
+        rxStats[SerialStream].addSample(timestampUs);
+    }
+    sessionRecorder->recordArmSample(timestampUs, SessionFormat::BothArms, armData.constData(), 14);
+
+    // 滤波（录制的是原始值）
+    float filtered[14];
+    {
+        TRACE_SCOPE(ArmFilter);
+        leftArmFilter.process(timestampUs, armData.constData(), filtered);
+        rightArmFilter.process(timestampUs, armData.constData() + 7, filtered + 7);
     }
 
     // 分离左右臂数据
@@ -876,215 +1297,648 @@ void MainWindow::processArmData(const QVector<float> &armData)
     rightArmData.clear();
 
     for (int i = 0; i < 7; ++i) {
-        leftArmData.append(armData[i]);
+        leftArmData.append(filtered[i]);
     }
 
     for (int i = 7; i < 14; ++i) {
-        rightArmData.append(armData[i]);
+        rightArmData.append(filtered[i]);
     }
 
     // 记录历史数据用于图表
-    qint64 currentTime = QDateTime::currentDateTime().toMSecsSinceEpoch();
+    appendLeftHistory(leftArmData, timestampUs);
+    appendRightHistory(rightArmData, timestampUs);
+
+    publishArmSample(SessionFormat::BothArms, filtered, 14, timestampUs);
 
-    static const int MAX_HISTORY = 100;
-    if (leftArmHistory.size() >= MAX_HISTORY) {
-        leftArmHistory.removeFirst();
+    displayScheduler->markDirty(DisplayScheduler::Tables | DisplayScheduler::Charts | DisplayScheduler::Status);
+}
+
+void MainWindow::appendLeftHistory(const QVector<float> &data, qint64 timestampUs)
+{
+    appendHistory(leftArmHistory, leftDecimator, data, timestampUs, SessionFormat::LeftArm);
+}
+
+void MainWindow::appendRightHistory(const QVector<float> &data, qint64 timestampUs)
+{
+    appendHistory(rightArmHistory, rightDecimator, data, timestampUs, SessionFormat::RightArm);
+}
+
+void MainWindow::appendHistory(QContiguousCache<ArmHistoryEntry> &history, ChartDecimator &decimator,
+                               const QVector<float> &data, qint64 timestampUs, SessionFormat::ArmId arm)
+{
+    ArmHistoryEntry entry;
+    entry.timestampUs = timestampUs;
+    const int count = qMin(data.size(), static_cast<int>(CANProtocol::JOINTS_PER_ARM));
+    for (int i = 0; i < count; ++i) {
+        entry.joints[i] = data[i];
     }
-    if (rightArmHistory.size() >= MAX_HISTORY) {
-        rightArmHistory.removeFirst();
+    if (count == CANProtocol::JOINTS_PER_ARM) {
+        updatePose(arm, entry);
     }
 
-    leftArmHistory.append(leftArmData);
-    rightArmHistory.append(rightArmData);
+    // QContiguousCache 满了会自动丢弃最旧的一条，不需要整体搬移
+    history.append(entry);
+    decimator.addSample(entry.timestampUs, entry.joints);
 }
 
-void MainWindow::updateUIWithArmData()
+bool MainWindow::updatePose(SessionFormat::ArmId arm, ArmHistoryEntry &entry)
 {
-    // 仅在串口模式下检查 acceptingStream
-    if (currentMode == CommunicationMode::Serial && !acceptingStream) return;
+    const bool left = arm == SessionFormat::LeftArm;
+    const ArmKinematics &kinematics = left ? leftKinematics : rightKinematics;
+    if (!kinematics.isValid()) return false;
+
+    ArmKinematics::Pose pose;
+    {
+        TRACE_SCOPE_ARG(ForwardKinematics, arm);
+        kinematics.compute(entry.joints, pose);
+    }
+    std::memcpy(entry.pose, pose.position, sizeof(pose.position));
+    std::memcpy(entry.pose + 3, pose.rpy, sizeof(pose.rpy));
+    entry.hasPose = true;
+    (left ? leftPose : rightPose).decimator.addSample(entry.timestampUs, entry.pose);
+
+    // 推送位置 + 四元数（不进共享内存：共享内存只有 14 个关节）
+    float values[SessionFormat::POSE_VALUES];
+    std::memcpy(values, pose.position, sizeof(pose.position));
+    std::memcpy(values + 3, pose.quaternion, sizeof(pose.quaternion));
+    armStreamPublisher->publish(entry.timestampUs, left ? SessionFormat::LeftPose : SessionFormat::RightPose,
+                                values, SessionFormat::POSE_VALUES);
+    return true;
+}
 
-    // 分别更新左臂和右臂数据，不强制要求两者都有
+void MainWindow::syncDecimatorColumns()
+{
+    // 每个像素列一个桶；绘图区宽度变化时按新列数重新聚合历史数据
+    const int columns = qMax(100, static_cast<int>(leftArmChart->plotArea().width()));
+    if (columns == leftDecimator.columns()) return;
 
-    if (!leftArmData.isEmpty()) {
-        QStringList leftNames = {
-            "旋转",
-            "右摆",
-            "右旋转",
-            "上摆",
-            "右旋转",
-            "上摆",
-            "右摆"
-        };
+    leftDecimator.setColumns(columns);
+    rightDecimator.setColumns(columns);
 
-        int leftCount = qMin(leftArmData.size(), leftNames.size());
-        for (int i = 0; i < leftCount; ++i) {
-            QString label = QString("ID%1(%2)").arg(i).arg(leftNames[i]);
-            if (!ui->leftArmTable->item(i, 0)) {
-                ui->leftArmTable->setItem(i, 0, new QTableWidgetItem());
-            }
-            if (!ui->leftArmTable->item(i, 1)) {
-                ui->leftArmTable->setItem(i, 1, new QTableWidgetItem());
-            }
-            ui->leftArmTable->item(i, 0)->setText(label);
-            ui->leftArmTable->item(i, 1)->setText(QString::number(leftArmData[i], 'f', 2));
-        }
+    for (int i = leftArmHistory.firstIndex(); i <= leftArmHistory.lastIndex(); ++i) {
+        const ArmHistoryEntry &entry = leftArmHistory.at(i);
+        leftDecimator.addSample(entry.timestampUs, entry.joints);
+    }
+    for (int i = rightArmHistory.firstIndex(); i <= rightArmHistory.lastIndex(); ++i) {
+        const ArmHistoryEntry &entry = rightArmHistory.at(i);
+        rightDecimator.addSample(entry.timestampUs, entry.joints);
     }
+}
 
-    if (!rightArmData.isEmpty()) {
-        QStringList rightNames = {
-            "旋转",
-            "左摆",
-            "左旋转",
-            "上摆",
-            "左旋转",
-            "上摆",
-            "左摆"
-        };
-
-        int rightCount = qMin(rightArmData.size(), rightNames.size());
-        for (int i = 0; i < rightCount; ++i) {
-            int id = 7 + i;
-            QString label = QString("ID%1(%2)").arg(id).arg(rightNames[i]);
-            if (!ui->rightArmTable->item(i, 0)) {
-                ui->rightArmTable->setItem(i, 0, new QTableWidgetItem());
-            }
-            if (!ui->rightArmTable->item(i, 1)) {
-                ui->rightArmTable->setItem(i, 1, new QTableWidgetItem());
-            }
-            ui->rightArmTable->item(i, 0)->setText(label);
-            ui->rightArmTable->item(i, 1)->setText(QString::number(rightArmData[i], 'f', 2));
-        }
+void MainWindow::syncPoseDecimatorColumns()
+{
+    const int columns = qMax(100, static_cast<int>(leftPose.chart->plotArea().width()));
+    if (columns == leftPose.decimator.columns()) return;
+
+    leftPose.decimator.setColumns(columns);
+    rightPose.decimator.setColumns(columns);
+
+    for (int i = leftArmHistory.firstIndex(); i <= leftArmHistory.lastIndex(); ++i) {
+        const ArmHistoryEntry &entry = leftArmHistory.at(i);
+        if (entry.hasPose) leftPose.decimator.addSample(entry.timestampUs, entry.pose);
     }
+    for (int i = rightArmHistory.firstIndex(); i <= rightArmHistory.lastIndex(); ++i) {
+        const ArmHistoryEntry &entry = rightArmHistory.at(i);
+        if (entry.hasPose) rightPose.decimator.addSample(entry.timestampUs, entry.pose);
+    }
+}
 
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    double sendFreq = 0.0;
-    double recvFreq = 0.0;
-    bool hasDataTransfer = false; // 是否有数据传输
-
-    if (leftArmContinuousEnabled && leftSendStartTime > 0 && leftArmStartTime > 0) {
-        qint64 sd = now - leftSendStartTime;
-        qint64 rd = now - leftArmStartTime;
-        if (sd > 0) sendFreq = (double)leftSendCount * 1000.0 / sd;
-        if (rd > 0) recvFreq = (double)leftArmFrameCount * 1000.0 / rd;
-        hasDataTransfer = true;
-    } else if (rightArmContinuousEnabled && rightSendStartTime > 0 && rightArmStartTime > 0) {
-        qint64 sd = now - rightSendStartTime;
-        qint64 rd = now - rightArmStartTime;
-        if (sd > 0) sendFreq = (double)rightSendCount * 1000.0 / sd;
-        if (rd > 0) recvFreq = (double)rightArmFrameCount * 1000.0 / rd;
-        hasDataTransfer = true;
-    } else if (bothArmsContinuousEnabled && bothSendStartTime > 0 && bothArmsStartTime > 0) {
-        qint64 sd = now - bothSendStartTime;
-        qint64 rd = now - bothArmsStartTime;
-        if (sd > 0) sendFreq = (double)bothSendCount * 1000.0 / sd;
-        if (rd > 0) recvFreq = (double)bothArmsFrameCount * 1000.0 / rd;
-        hasDataTransfer = true;
-    } else if (currentMode == CommunicationMode::Serial && acceptingStream && serialStartTime > 0) {
-        qint64 rd = now - serialStartTime;
-        // 串口模式下如果是数据流推送，发送频率视为0（或者统计心跳包，这里暂定为0）
-        sendFreq = 0.0;
-        if (rd > 0) recvFreq = (double)serialRxCount * 1000.0 / rd;
-        hasDataTransfer = true;
-    }
-
-    // 在状态栏显示频率信息
-    if (currentMode == CommunicationMode::Serial) {
-        // 无线模式只显示接收频率
-        showStatusMessage(QString("接收频率: %1 Hz").arg(recvFreq, 0, 'f', 2));
-    } else {
-        // CAN模式显示发送和接收频率
-        showStatusMessage(QString("发送频率: %1 Hz, 接收频率: %2 Hz").arg(sendFreq, 0, 'f', 2).arg(recvFreq, 0, 'f', 2));
+bool MainWindow::updateUIWithArmData()
+{
+    // 仅在串口模式下检查数据获取开关（含基准测试注入）
+    if (currentMode == CommunicationMode::Serial && !serialStreamActive()) return false;
+
+    // 分别更新左臂和右臂数据，不强制要求两者都有；模型内部只对变化的单元格发出刷新
+    bool changed = false;
+    if (!leftArmData.isEmpty()
+        && leftTableModel->setValues(leftArmData.constData(), leftArmData.size())) {
+        changed |= ui->leftArmTable->isVisible();
+    }
+    if (!rightArmData.isEmpty()
+        && rightTableModel->setValues(rightArmData.constData(), rightArmData.size())) {
+        changed |= ui->rightArmTable->isVisible();
     }
+    return changed;
 }
 
-void MainWindow::updateCharts()
+void MainWindow::updateRateStatus()
 {
-    if (leftArmHistory.isEmpty() && rightArmHistory.isEmpty()) return;
+    // 仅在串口模式下检查数据获取开关（含基准测试注入）
+    if (currentMode == CommunicationMode::Serial && !serialStreamActive()) return;
 
-    // 清空现有数据
-    for (auto series : leftSeries) {
-        series->clear();
+    StreamId stream = StreamCount;
+    if (leftArmContinuousEnabled) {
+        stream = LeftArmStream;
+    } else if (rightArmContinuousEnabled) {
+        stream = RightArmStream;
+    } else if (bothArmsContinuousEnabled) {
+        stream = BothArmsStream;
+    } else if (currentMode == CommunicationMode::Serial && serialStreamActive()) {
+        stream = SerialStream;
+    }
+    if (stream == StreamCount) return;
+
+    // 在状态栏显示频率信息（录制中时附带丢弃计数，便于发现磁盘跟不上）
+    QString text = formatStreamStats(stream, AcqClock::nowUs());
+    if (sessionRecorder->isRecording()) {
+        text += QString(" | 录制中, 丢弃: %1").arg(sessionRecorder->droppedRecords());
+    }
+    if (stream == BothArmsStream) {
+        text += QString(" | 双臂偏差: %1us, 最大滞后: %2us, 补齐: %3/%4")
+                    .arg(lastFusionSkewUs).arg(maxFusionAgeUs)
+                    .arg(armFusion.filledCount()).arg(armFusion.pairedCount() + armFusion.filledCount());
+    }
+    if (trajectoryStreamer->isStreaming()) {
+        const TrajectoryStreamer::Stats s = trajectoryStreamer->stats();
+        text += QString(" | 轨迹: %1/%2Hz, 迟到p99 %3us, 写出p99 %4us, 错过 %5, 跳过 %6, 应答失败 %7")
+                    .arg(s.actualRateHz, 0, 'f', 0).arg(s.targetRateHz, 0, 'f', 0)
+                    .arg(s.p99LatenessUs).arg(s.p99WriteLatenessUs).arg(s.missedDeadlines)
+                    .arg(s.skippedFrames).arg(s.acksFailed);
+    }
+    if (armStreamPublisher->isOpen()) {
+        // 按接收端分别显示丢弃的样本数（队列溢出计入所有接收端）
+        const quint64 queueDropped = armStreamPublisher->queueDroppedSamples();
+        QStringList drops;
+        for (const ArmStreamPublisher::ConsumerStats &consumer : armStreamPublisher->consumerStats()) {
+            drops << QString::number(consumer.samplesDropped + queueDropped);
+        }
+        text += QString(" | 推送丢弃: %1").arg(drops.join('/'));
     }
-    for (auto series : rightSeries) {
-        series->clear();
+    showStatusMessage(text);
+}
+
+void MainWindow::resetStreamStats(StreamId stream)
+{
+    const qint64 nowUs = AcqClock::nowUs();
+    txStats[stream].reset(nowUs);
+    rxStats[stream].reset(nowUs);
+    if (stream == BothArmsStream) {
+        armFusion.reset();
+        lastFusionSkewUs = 0;
+        maxFusionAgeUs = 0;
     }
+}
 
-    // 添加新数据
-    qint64 currentTime = QDateTime::currentDateTime().toMSecsSinceEpoch();
-    int historySize = qMax(leftArmHistory.size(), rightArmHistory.size());
+QString MainWindow::formatStreamStats(StreamId stream, qint64 nowUs) const
+{
+    const StreamStats::Snapshot rx = rxStats[stream].snapshot(nowUs);
+    QString text;
+    if (stream == SerialStream) {
+        // 无线模式为下位机主动推送，只显示接收
+        text = QString("接收频率: %1 Hz").arg(rx.windowRateHz, 0, 'f', 2);
+    } else {
+        const StreamStats::Snapshot tx = txStats[stream].snapshot(nowUs);
+        text = QString("发送频率: %1 Hz, 接收频率: %2 Hz")
+                   .arg(tx.windowRateHz, 0, 'f', 2)
+                   .arg(rx.windowRateHz, 0, 'f', 2);
+    }
+    text += QString(" (平均 %1 Hz, 间隔 p50/p99/最大: %2/%3/%4 ms, 间隙: %5)")
+                .arg(rx.meanRateHz, 0, 'f', 2)
+                .arg(rx.p50IntervalUs / 1000.0, 0, 'f', 2)
+                .arg(rx.p99IntervalUs / 1000.0, 0, 'f', 2)
+                .arg(rx.maxIntervalUs / 1000.0, 0, 'f', 2)
+                .arg(rx.gapCount);
+    return text;
+}
 
-    for (int i = 0; i < historySize; ++i) {
-        qint64 time = currentTime - (historySize - i) * 1000; // 假设每秒一个数据点
+bool MainWindow::updateCharts()
+{
+    if (!leftArmChart || (leftArmHistory.isEmpty() && rightArmHistory.isEmpty())) return false;
 
-        // 左臂数据
-        if (i < leftArmHistory.size()) {
-            const QVector<float> &leftData = leftArmHistory[i];
-            for (int j = 0; j < qMin(leftSeries.size(), leftData.size()); ++j) {
-                leftSeries[j]->append(time, leftData[j]);
-            }
-        }
+    syncDecimatorColumns();
 
-        // 右臂数据
-        if (i < rightArmHistory.size()) {
-            const QVector<float> &rightData = rightArmHistory[i];
-            for (int j = 0; j < qMin(rightSeries.size(), rightData.size()); ++j) {
-                rightSeries[j]->append(time, rightData[j]);
+    // 降采样后的点整体替换到曲线中，点数只与列数有关；x 由采集时间换算为墙上时间
+    auto fillSeries = [&](const ChartDecimator &decimator, const QVector<QLineSeries*> &seriesList) {
+        for (int j = 0; j < seriesList.size(); ++j) {
+            decimator.points(j, chartPointBuffer);
+            for (QPointF &p : chartPointBuffer) {
+                p.setX(AcqClock::toEpochMs(static_cast<qint64>(p.x())));
             }
+            seriesList[j]->replace(chartPointBuffer);
         }
-    }
+    };
+    fillSeries(leftDecimator, leftSeries);
+    fillSeries(rightDecimator, rightSeries);
 
-    // 更新X轴范围
-    qint64 minTime = currentTime - historySize * 1000;
-    qint64 maxTime = currentTime;
+    // X轴为滚动时间窗口，数据中断或抖动会直接体现在曲线上
+    qint64 maxTime = AcqClock::toEpochMs(AcqClock::nowUs());
+    qint64 minTime = maxTime - CHART_WINDOW_US / 1000;
     leftAxisX->setRange(QDateTime::fromMSecsSinceEpoch(minTime),
                         QDateTime::fromMSecsSinceEpoch(maxTime));
     rightAxisX->setRange(QDateTime::fromMSecsSinceEpoch(minTime),
                          QDateTime::fromMSecsSinceEpoch(maxTime));
+    return true;
+}
+
+bool MainWindow::updatePoseCharts()
+{
+    if (!leftPose.chart || (leftPose.decimator.isEmpty() && rightPose.decimator.isEmpty())) return false;
+
+    syncPoseDecimatorColumns();
+
+    const qint64 maxTime = AcqClock::toEpochMs(AcqClock::nowUs());
+    const qint64 minTime = maxTime - CHART_WINDOW_US / 1000;
+    for (PoseChart *pose : {&leftPose, &rightPose}) {
+        // 位置轴按窗口内的范围自动缩放（工作空间因臂型而异）
+        float low = 0.0f;
+        float high = 0.0f;
+        bool any = false;
+        for (int j = 0; j < POSE_CHANNELS; ++j) {
+            pose->decimator.points(j, chartPointBuffer);
+            for (QPointF &p : chartPointBuffer) {
+                p.setX(AcqClock::toEpochMs(static_cast<qint64>(p.x())));
+                if (j < 3) {
+                    const float y = static_cast<float>(p.y());
+                    low = any ? qMin(low, y) : y;
+                    high = any ? qMax(high, y) : y;
+                    any = true;
+                }
+            }
+            pose->series[j]->replace(chartPointBuffer);
+        }
+        if (any) {
+            const float margin = qMax(10.0f, (high - low) * 0.05f);
+            pose->positionAxis->setRange(low - margin, high + margin);
+        }
+        pose->axisX->setRange(QDateTime::fromMSecsSinceEpoch(minTime),
+                              QDateTime::fromMSecsSinceEpoch(maxTime));
+    }
+    return true;
 }
 
 void MainWindow::logMessage(const QString &message)
 {
-    QString timestamp = getCurrentTimeString();
-    ui->logTextEdit->append(timestamp + " " + message);
+    // 只进入待刷新队列，由 flushLog 批量显示
+    logModel->append(LogModel::Info, message);
+}
 
-    // 自动滚动到底部
-    QTextCursor cursor = ui->logTextEdit->textCursor();
-    cursor.movePosition(QTextCursor::End);
-    ui->logTextEdit->setTextCursor(cursor);
+void MainWindow::logWarning(const QString &message)
+{
+    logModel->append(LogModel::Warning, message);
 }
 
-void MainWindow::logHexData(const QByteArray &data, bool isSend)
+void MainWindow::logError(const QString &message)
+{
+    logModel->append(LogModel::Error, message);
+}
+
+void MainWindow::flushLog()
+{
+    if (!logModel->hasPending()) return;
+
+    // 用户正在查看历史日志时不强制滚动到底部
+    QScrollBar *bar = ui->logView->verticalScrollBar();
+    const bool atBottom = bar->value() >= bar->maximum();
+    if (logModel->flush() && atBottom) {
+        ui->logView->scrollToBottom();
+    }
+}
+
+void MainWindow::onDisplayFrame(DisplayScheduler::Subsystems dirty)
+{
+    TRACE_SCOPE_ARG(DisplayFrame, static_cast<int>(dirty));
+    bool drawn = false;
+    if (dirty & DisplayScheduler::Tables) {
+        TRACE_SCOPE(TableRender);
+        drawn |= updateUIWithArmData();
+    }
+    // 曲线页不可见时不重绘，切换到曲线页时再补一帧
+    if ((dirty & DisplayScheduler::Charts) && ui->tabWidget->currentWidget() == chartTab) {
+        TRACE_SCOPE(ChartRender);
+        drawn |= updateCharts();
+    }
+    if ((dirty & DisplayScheduler::Charts) && ui->tabWidget->currentWidget() == poseTab) {
+        TRACE_SCOPE(ChartRender);
+        drawn |= updatePoseCharts();
+    }
+    if (drawn) {
+        // 可见内容已更新：显示延迟在视口真正绘制之后记录（见 eventFilter）
+        latencyPaintPending = true;
+    }
+    if (dirty & DisplayScheduler::Status) {
+        updateRateStatus();
+        updateLatencyOverlay();
+    }
+    if (dirty & DisplayScheduler::Log) {
+        flushLog();
+    }
+}
+
+void MainWindow::watchLatencyPaint(QWidget *viewport)
+{
+    viewport->installEventFilter(this);
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    // 表格/曲线视口收到绘制事件：同一次刷新的绘制和刷屏在本轮事件处理内同步完成，
+    // 零延时定时器在其之后运行，此时记录的显示延迟包含绘制开销
+    if (event->type() == QEvent::Paint && latencyPaintPending && !latencyStampQueued) {
+        latencyPaintPending = false;
+        latencyStampQueued = true;
+        QTimer::singleShot(0, this, [this]() {
+            latencyStampQueued = false;
+            const qint64 nowUs = AcqClock::nowUs();
+            serialLatency.rendered(nowUs);
+            canLatency.rendered(nowUs);
+        });
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::onExportLogClicked()
+{
+    const QString path = QFileDialog::getSaveFileName(this, "导出日志",
+        QString("log_%1.txt").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        "文本文件 (*.txt)");
+    if (path.isEmpty()) return;
+
+    logModel->flush();
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || !logModel->exportTo(&file)) {
+        QMessageBox::warning(this, "警告", "导出日志失败: " + file.errorString());
+        return;
+    }
+    showStatusMessage("日志已导出: " + path);
+}
+
+void MainWindow::onRecordClicked()
+{
+    if (sessionRecorder->isRecording()) {
+        sessionRecorder->close();
+        ui->recordButton->setText("开始录制");
+        logMessage(QString("录制已停止: %1 (记录 %2 条, %3 KB, 丢弃 %4 条)")
+                       .arg(sessionRecorder->fileName())
+                       .arg(sessionRecorder->recordsWritten())
+                       .arg(sessionRecorder->bytesWritten() / 1024)
+                       .arg(sessionRecorder->droppedRecords()));
+        return;
+    }
+
+    const QString path = QFileDialog::getSaveFileName(this, "录制会话",
+        QString("session_%1.ltarec").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        "会话录制 (*.ltarec)");
+    if (path.isEmpty()) return;
+
+    if (sessionRecorder->open(path)) {
+        ui->recordButton->setText("停止录制");
+        logModel->append(LogModel::Success, "开始录制: " + path);
+    }
+}
+
+void MainWindow::onReplayClicked()
+{
+    if (sessionReplayer->isActive()) {
+        sessionReplayer->stop();
+        onReplayFinished();
+        return;
+    }
+
+    const QString path = QFileDialog::getOpenFileName(this, "回放会话", QString(), "会话录制 (*.ltarec)");
+    if (path.isEmpty()) return;
+    if (!sessionReplayer->open(path)) return;
+
+    // 回放期间按数据推送处理串口帧
+    acceptingStreamBeforeReplay = acceptingStream;
+    acceptingStream = true;
+    serialLink->clearBuffer();
+    resetStreamStats(SerialStream);
+
+    const double speed = ui->replaySpeedComboBox->currentData().toDouble();
+    sessionReplayer->start(speed);
+    ui->replayButton->setText("停止回放");
+    logMessage(QString("开始回放: %1 (%2)").arg(path, ui->replaySpeedComboBox->currentText()));
+}
+
+void MainWindow::injectSerialBytes(const QByteArray &data, qint64 timestampUs)
+{
+    // 与回放相同按数据推送处理串口帧，但不改动实时数据获取开关
+    injectingStream = true;
+    serialLink->feed(data, timestampUs);
+}
+
+void MainWindow::injectCanFrame(const CANDataFrame &frame)
+{
+    initCANCommunication();
+    canComm->onFrameReceived(frame);
+}
+
+void MainWindow::onReplayFinished()
+{
+    acceptingStream = acceptingStreamBeforeReplay;
+    serialLink->clearBuffer();
+    ui->replayButton->setText("回放");
+    logMessage(QString("回放结束: 共回放 %1 条记录").arg(sessionReplayer->replayedRecords()));
+    sessionReplayer->close();
+}
+
+void MainWindow::onTraceToggled(bool enabled)
+{
+    if (enabled) {
+        // 每次开启重新开始记录
+        Trace::clear();
+    }
+    Trace::setEnabled(enabled);
+    logMessage(enabled ? "性能追踪已开启" : "性能追踪已关闭");
+}
+
+void MainWindow::onExportTraceClicked()
+{
+    const QString path = QFileDialog::getSaveFileName(this, "导出追踪",
+        QString("trace_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        "Chrome trace (*.json)");
+    if (path.isEmpty()) return;
+
+    QString error;
+    if (!Trace::writeChromeTrace(path, &error)) {
+        QMessageBox::warning(this, "警告", "导出追踪失败: " + error);
+        return;
+    }
+    showStatusMessage("追踪已导出: " + path);
+}
+
+void MainWindow::recordCanLatency(qint64 arrivalUs)
+{
+    LatencyTracker::Stamp stamp;
+    stamp.arrivalUs = arrivalUs;
+    stamp.dequeueUs = canComm ? canComm->lastDequeueUs() : arrivalUs;
+    stamp.decodeUs = AcqClock::nowUs();
+    canLatency.sampleDecoded(stamp);
+}
+
+void MainWindow::updateLatencyOverlay()
+{
+    if (!latencyOverlay || !latencyOverlay->isVisible()) return;
+
+    QStringList lines;
+    lines << "延迟 p50/p99/最大";
+    if (serialLatency.histogram(LatencyTracker::Total).count() > 0) {
+        lines << "串口  " + serialLatency.summary();
+    }
+    if (canLatency.histogram(LatencyTracker::Total).count() > 0) {
+        lines << "CAN  " + canLatency.summary();
+    }
+    latencyOverlay->setText(lines.join('\n'));
+    latencyOverlay->adjustSize();
+    // 叠加在标签页右上角，窗口缩放后下一次刷新时跟随
+    latencyOverlay->move(ui->tabWidget->width() - latencyOverlay->width() - 8, 28);
+    latencyOverlay->raise();
+}
+
+void MainWindow::onLatencyOverlayToggled(bool enabled)
+{
+    if (!latencyOverlay) {
+        latencyOverlay = new QLabel(ui->tabWidget);
+        latencyOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+        latencyOverlay->setStyleSheet("QLabel { background-color: rgba(0, 0, 0, 160); color: #FFFFFF; "
+                                      "font-family: monospace; padding: 4px; border-radius: 4px; }");
+    }
+    if (enabled) {
+        // 每次打开重新统计
+        serialLatency.reset();
+        canLatency.reset();
+    }
+    latencyOverlay->setVisible(enabled);
+    updateLatencyOverlay();
+}
+
+void MainWindow::onExportLatencyClicked()
+{
+    const QString path = QFileDialog::getSaveFileName(this, "导出延迟",
+        QString("latency_%1.csv").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        "CSV 文件 (*.csv)");
+    if (path.isEmpty()) return;
+
+    const struct {
+        const char *name;
+        const LatencyTracker *tracker;
+    } paths[] = {{"serial", &serialLatency}, {"can", &canLatency}};
+
+    // 先写各阶段摘要，再写非空的直方图桶
+    QByteArray out("path,stage,count,min_us,p50_us,p90_us,p99_us,max_us,mean_us\n");
+    for (const auto &p : paths) {
+        for (int s = 0; s < LatencyTracker::StageCount; ++s) {
+            const LatencyHistogram &h = p.tracker->histogram(static_cast<LatencyTracker::Stage>(s));
+            out.append(QString("%1,%2,%3,%4,%5,%6,%7,%8,%9\n")
+                           .arg(p.name).arg(LatencyTracker::stageName(static_cast<LatencyTracker::Stage>(s)))
+                           .arg(h.count()).arg(h.minUs()).arg(h.percentileUs(0.5)).arg(h.percentileUs(0.9))
+                           .arg(h.percentileUs(0.99)).arg(h.maxUs()).arg(h.meanUs(), 0, 'f', 1).toUtf8());
+        }
+    }
+    out.append("\npath,stage,bucket_upper_us,count\n");
+    for (const auto &p : paths) {
+        for (int s = 0; s < LatencyTracker::StageCount; ++s) {
+            const LatencyHistogram &h = p.tracker->histogram(static_cast<LatencyTracker::Stage>(s));
+            for (int b = 0; b < LatencyHistogram::BUCKET_COUNT; ++b) {
+                if (h.bucketCount(b) == 0) continue;
+                out.append(QString("%1,%2,%3,%4\n").arg(p.name)
+                               .arg(LatencyTracker::stageName(static_cast<LatencyTracker::Stage>(s)))
+                               .arg(LatencyHistogram::bucketUpperUs(b)).arg(h.bucketCount(b)).toUtf8());
+            }
+        }
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || file.write(out) != out.size()) {
+        QMessageBox::warning(this, "警告", "导出延迟失败: " + file.errorString());
+        return;
+    }
+    showStatusMessage("延迟已导出: " + path);
+}
+
+void MainWindow::onLoadKinematicsClicked()
+{
+    const QString path = QFileDialog::getOpenFileName(this, "加载运动学参数", QString(), "JSON 文件 (*.json)");
+    if (path.isEmpty()) return;
+
+    ArmKinematics::Config left;
+    ArmKinematics::Config right;
+    QString error;
+    if (!ArmKinematics::loadFile(path, left, right, &error)
+        || !leftKinematics.setConfig(left, &error) || !rightKinematics.setConfig(right, &error)) {
+        leftKinematics.clear();
+        rightKinematics.clear();
+        QMessageBox::warning(this, "警告", "加载运动学参数失败: " + error);
+        return;
+    }
+
+    // 旧参数算出的位姿不再有效，从新样本开始重新绘制
+    for (QContiguousCache<ArmHistoryEntry> *history : {&leftArmHistory, &rightArmHistory}) {
+        for (int i = history->firstIndex(); i <= history->lastIndex(); ++i) {
+            (*history)[i].hasPose = false;
+        }
+    }
+    leftPose.decimator.clear();
+    rightPose.decimator.clear();
+    logMessage("已加载运动学参数: " + path);
+}
+
+void MainWindow::onShmPublishToggled(bool enabled)
+{
+    if (!enabled) {
+        armStatePublisher.close();
+        logMessage("共享内存发布已关闭");
+        return;
+    }
+    if (!armStatePublisher.open(ArmStateShm::DEFAULT_NAME)) {
+        logModel->append(LogModel::Error, QString("共享内存发布失败: %1")
+                                              .arg(QString::fromStdString(armStatePublisher.errorString())));
+        ui->shmPublishCheckBox->setChecked(false);
+        return;
+    }
+    latestValidMask = 0;
+    logMessage(QString("共享内存发布已开启: %1").arg(ArmStateShm::DEFAULT_NAME));
+}
+
+void MainWindow::onStreamPublishToggled(bool enabled)
 {
-    QString direction = isSend ? "发送" : "接收";
-    QString hexString = data.toHex(' ').toUpper();
-    QString prefix = direction + "数据: ";
-
-    if (data.size() >= 3 &&
-        static_cast<quint8>(data.at(0)) == static_cast<quint8>(SerialProtocol::FRAME_HEADER) &&
-        static_cast<quint8>(data.at(data.size() - 1)) == static_cast<quint8>(SerialProtocol::FRAME_TAIL)) {
-        quint8 cmd = static_cast<quint8>(data.at(1));
-        QString cmdName;
-        switch (cmd) {
-        case SerialProtocol::CMD_GET_ARM_DATA: cmdName = "GET_ARM_DATA"; break;
-        case SerialProtocol::CMD_GET_VERSION: cmdName = "获取版本号"; break;
-        case SerialProtocol::CMD_ENABLE_DATA_STREAM: cmdName = "开启摇操臂数据推送"; break;
-        case SerialProtocol::CMD_DISABLE_DATA_STREAM: cmdName = "禁止摇操臂数据推送"; break;
-        case SerialProtocol::CMD_CALIBRATE: cmdName = "零点标定"; break;
-        case SerialProtocol::CMD_TORQUE_CONTROL: cmdName = "扭矩设置"; break;
-        case SerialProtocol::CMD_SET_PARAMS: cmdName = "SET_PARAMS"; break;
-        default: cmdName = "UNKNOWN"; break;
+    if (!enabled) {
+        if (armStreamPublisher->isOpen()) {
+            armStreamPublisher->close();
+            logMessage(QString("数据推送已关闭: 共 %1 个样本").arg(armStreamPublisher->publishedSamples()));
         }
-        prefix += QString("[0x%1 %2] ")
-                      .arg(cmd, 2, 16, QLatin1Char('0')).toUpper()
-                      .arg(cmdName);
+        ui->streamTargetEdit->setEnabled(true);
+        return;
     }
+    const QStringList targets = ui->streamTargetEdit->text().split(',');
+    if (!armStreamPublisher->open(targets)) {
+        ui->streamPublishCheckBox->setChecked(false);
+        return;
+    }
+    ui->streamTargetEdit->setEnabled(false);
+    logMessage(QString("数据推送已开启: %1").arg(targets.join(", ")));
+}
 
-    logMessage(prefix + hexString);
+void MainWindow::publishArmSample(quint16 armId, const float *values, int count, qint64 timestampUs)
+{
+    armStreamPublisher->publish(timestampUs, armId, values, count);
+
+    if (!armStatePublisher.isOpen()) return;
+
+    // 共享内存中保存合并后的14关节状态：CAN模式下左右臂分别到达
+    int firstJoint = 0;
+    quint32 validBits = ArmStateShm::LeftArmValid | ArmStateShm::RightArmValid;
+    if (armId == SessionFormat::LeftArm) {
+        validBits = ArmStateShm::LeftArmValid;
+    } else if (armId == SessionFormat::RightArm) {
+        firstJoint = 7;
+        validBits = ArmStateShm::RightArmValid;
+    }
+    std::memcpy(latestJoints + firstJoint, values, count * sizeof(float));
+    latestValidMask |= validBits;
+    armStatePublisher.publish(timestampUs, latestJoints, latestValidMask);
 }
 
-QString MainWindow::getCurrentTimeString()
+void MainWindow::onLogLevelChanged(int index)
+{
+    const auto severity = static_cast<LogModel::Severity>(ui->logLevelComboBox->itemData(index).toInt());
+    logProxyModel->setMinimumSeverity(severity);
+}
+
+void MainWindow::logHexData(const QByteArray &data, bool isSend)
 {
-    return QDateTime::currentDateTime().toString("[hh:mm:ss.zzz]");
+    // 只记录原始字节，十六进制文本在显示/导出时才生成
+    logModel->appendSerialFrame(LogModel::Info, isSend, data);
 }
 
 QString MainWindow::parseVersionNumber(const QByteArray &versionBytes)
@@ -1134,12 +1988,13 @@ void MainWindow::setOperationButtonsEnabled(bool enabled)
     ui->calibrateButton->setEnabled(enabled);
     ui->sendCustomButton->setEnabled(enabled);
     ui->torqueSetButton->setEnabled(enabled);
+    ui->torqueSetAllButton->setEnabled(enabled);
 }
 
 void MainWindow::sendVersionRequest()
 {
     if (currentMode == CommunicationMode::Serial) {
-        if (serialPort->isOpen()) {
+        if (serialLink->isOpen()) {
             QByteArray cmd = SerialProtocol::buildGetVersionCommand();
             writeData(cmd);
             logMessage("已发送：自动读取版本号 (串口)");
@@ -1208,6 +2063,21 @@ void MainWindow::initCANCommunication()
         connect(canComm, &CANCommunication::leftArmDataReceived, this, &MainWindow::onCANLeftArmDataReceived);
         connect(canComm, &CANCommunication::rightArmDataReceived, this, &MainWindow::onCANRightArmDataReceived);
         connect(canComm, &CANCommunication::logMessage, this, &MainWindow::onCANLogMessage);
+        connect(canComm, &CANCommunication::frameSent, this, [this](const CANDataFrame &frame) {
+            const qint64 nowUs = AcqClock::nowUs();
+            sessionRecorder->recordCanFrame(nowUs, true, frame.id, frame.data);
+            // 发送统计按请求类型区分（单次和持续请求都计入）；其他命令已有文本日志
+            switch (frame.id) {
+            case CANProtocol::CAN_ID_LEFT_ARM_REQUEST:  txStats[LeftArmStream].addSample(nowUs); break;
+            case CANProtocol::CAN_ID_RIGHT_ARM_REQUEST: txStats[RightArmStream].addSample(nowUs); break;
+            case CANProtocol::CAN_ID_BOTH_ARMS_REQUEST: txStats[BothArmsStream].addSample(nowUs); break;
+            default: return;
+            }
+            logModel->appendCanFrame(LogModel::Info, true, frame.id, frame.data);
+        });
+        connect(canComm, &CANCommunication::frameReceived, this, [this](const CANDataFrame &frame) {
+            sessionRecorder->recordCanFrame(frame.timestampUs, false, frame.id, frame.data);
+        });
         connect(canComm, &CANCommunication::errorOccurred, this, &MainWindow::onCANErrorOccurred);
         connect(canComm, &CANCommunication::calibrationResultReceived, [this](bool success) {
             stopCalibrateTimeout();
@@ -1217,7 +2087,7 @@ void MainWindow::initCANCommunication()
                 logMessage("零点标定成功 (CAN)");
                 showStatusMessage("零点标定成功 (CAN)");
             } else {
-                logMessage("零点标定失败 (CAN)");
+                logError("零点标定失败 (CAN)");
                 showStatusMessage("零点标定失败 (CAN)");
             }
         });
@@ -1259,7 +2129,7 @@ void MainWindow::onCommunicationModeChanged(int index)
     }
 
     // 断开现有连接
-    if (currentMode == CommunicationMode::Serial && serialPort->isOpen()) {
+    if (currentMode == CommunicationMode::Serial && serialLink->isOpen()) {
         closeSerialPort();
     } else if (currentMode == CommunicationMode::CAN && canComm && canComm->isConnected()) {
         canComm->disconnect();
@@ -1308,13 +2178,14 @@ void MainWindow::updateUIForCommunicationMode(CommunicationMode mode)
 
 void MainWindow::enableSerialControls(bool enabled)
 {
-    ui->portComboBox->setEnabled(enabled && !serialPort->isOpen());
-    ui->baudRateComboBox->setEnabled(enabled && !serialPort->isOpen());
-    ui->dataBitsComboBox->setEnabled(enabled && !serialPort->isOpen());
-    ui->parityComboBox->setEnabled(enabled && !serialPort->isOpen());
-    ui->stopBitsComboBox->setEnabled(enabled && !serialPort->isOpen());
-    ui->flowControlComboBox->setEnabled(enabled && !serialPort->isOpen());
-    ui->refreshPortsButton->setEnabled(enabled && !serialPort->isOpen());
+    ui->portComboBox->setEnabled(enabled && !serialLink->isOpen());
+    ui->baudRateComboBox->setEnabled(enabled && !serialLink->isOpen());
+    ui->dataBitsComboBox->setEnabled(enabled && !serialLink->isOpen());
+    ui->parityComboBox->setEnabled(enabled && !serialLink->isOpen());
+    ui->stopBitsComboBox->setEnabled(enabled && !serialLink->isOpen());
+    ui->flowControlComboBox->setEnabled(enabled && !serialLink->isOpen());
+    ui->lowLatencyCheckBox->setEnabled(enabled && !serialLink->isOpen());
+    ui->refreshPortsButton->setEnabled(enabled && !serialLink->isOpen());
 }
 
 void MainWindow::enableCANControls(bool enabled)
@@ -1406,13 +2277,7 @@ void MainWindow::onCANLeftArmContinuousClicked()
         ui->canLeftArmContinuousButton->setStyleSheet("QPushButton { background-color: #2196F3; color: white; border-radius: 4px; padding: 6px; font-weight: bold; } QPushButton:pressed { background-color: #1976D2; } QPushButton:disabled { background-color: #E0E0E0; color: #A0A0A0; }");
         ui->canLeftArmSingleButton->setEnabled(true);
         
-        // 计算并显示频率
-        qint64 duration = QDateTime::currentMSecsSinceEpoch() - leftArmStartTime;
-        double freq = 0;
-        if (duration > 0) {
-            freq = (double)leftArmFrameCount * 1000.0 / duration;
-        }
-        logMessage(QString("左臂持续获取已停止, 平均频率: %1 Hz").arg(freq, 0, 'f', 2));
+        logMessage(QString("左臂持续获取已停止, %1").arg(formatStreamStats(LeftArmStream, AcqClock::nowUs())));
         updateCalibrateButtonState();
     } else {
         // 启动
@@ -1425,10 +2290,7 @@ void MainWindow::onCANLeftArmContinuousClicked()
         ui->canLeftArmSingleButton->setEnabled(false);
         
         // 重置统计
-        leftArmStartTime = QDateTime::currentMSecsSinceEpoch();
-        leftArmFrameCount = 0;
-        leftSendStartTime = leftArmStartTime;
-        leftSendCount = 0;
+        resetStreamStats(LeftArmStream);
 
         logMessage(QString("左臂持续获取已启动 (间隔: %1ms)").arg(interval));
         updateCalibrateButtonState();
@@ -1439,7 +2301,6 @@ void MainWindow::onCANLeftArmPollTimeout()
 {
     if (canComm && canComm->isConnected()) {
         canComm->sendRequest(CANCommunication::LeftArm);
-        leftSendCount++;
     }
 }
 
@@ -1469,13 +2330,7 @@ void MainWindow::onCANRightArmContinuousClicked()
         ui->canRightArmContinuousButton->setStyleSheet("QPushButton { background-color: #2196F3; color: white; border-radius: 4px; padding: 6px; font-weight: bold; } QPushButton:pressed { background-color: #1976D2; } QPushButton:disabled { background-color: #E0E0E0; color: #A0A0A0; }");
         ui->canRightArmSingleButton->setEnabled(true);
         
-        // 计算并显示频率
-        qint64 duration = QDateTime::currentMSecsSinceEpoch() - rightArmStartTime;
-        double freq = 0;
-        if (duration > 0) {
-            freq = (double)rightArmFrameCount * 1000.0 / duration;
-        }
-        logMessage(QString("右臂持续获取已停止, 平均频率: %1 Hz").arg(freq, 0, 'f', 2));
+        logMessage(QString("右臂持续获取已停止, %1").arg(formatStreamStats(RightArmStream, AcqClock::nowUs())));
         updateCalibrateButtonState();
     } else {
         // 启动
@@ -1488,10 +2343,7 @@ void MainWindow::onCANRightArmContinuousClicked()
         ui->canRightArmSingleButton->setEnabled(false);
         
         // 重置统计
-        rightArmStartTime = QDateTime::currentMSecsSinceEpoch();
-        rightArmFrameCount = 0;
-        rightSendStartTime = rightArmStartTime;
-        rightSendCount = 0;
+        resetStreamStats(RightArmStream);
 
         logMessage(QString("右臂持续获取已启动 (间隔: %1ms)").arg(interval));
         updateCalibrateButtonState();
@@ -1502,7 +2354,6 @@ void MainWindow::onCANRightArmPollTimeout()
 {
     if (canComm && canComm->isConnected()) {
         canComm->sendRequest(CANCommunication::RightArm);
-        rightSendCount++;
     }
 }
 
@@ -1534,13 +2385,7 @@ void MainWindow::onCANBothArmsContinuousClicked()
             canBothArmsSingleButton->setEnabled(true);
         }
         
-        // 计算并显示频率
-        qint64 duration = QDateTime::currentMSecsSinceEpoch() - bothArmsStartTime;
-        double freq = 0;
-        if (duration > 0) {
-            freq = (double)bothArmsFrameCount * 1000.0 / duration;
-        }
-        logMessage(QString("双臂持续获取已停止, 平均频率: %1 Hz").arg(freq, 0, 'f', 2));
+        logMessage(QString("双臂持续获取已停止, %1").arg(formatStreamStats(BothArmsStream, AcqClock::nowUs())));
         updateCalibrateButtonState();
     } else {
         // 启动
@@ -1555,10 +2400,7 @@ void MainWindow::onCANBothArmsContinuousClicked()
         }
         
         // 重置统计
-        bothArmsStartTime = QDateTime::currentMSecsSinceEpoch();
-        bothArmsFrameCount = 0;
-        bothSendStartTime = bothArmsStartTime;
-        bothSendCount = 0;
+        resetStreamStats(BothArmsStream);
 
         logMessage(QString("双臂持续获取已启动 (间隔: %1ms)").arg(interval));
         updateCalibrateButtonState();
@@ -1568,16 +2410,57 @@ void MainWindow::onCANBothArmsContinuousClicked()
 void MainWindow::onCANBothArmsPollTimeout()
 {
     if (canComm && canComm->isConnected()) {
+        // 新周期开始：上一周期只到了一半时先补齐输出
+        DualArmFusion::Sample fused;
+        if (armFusion.beginCycle(AcqClock::nowUs(), fused)) {
+            handleFusedArmSample(fused);
+        }
         canComm->sendRequest(CANCommunication::BothArms);
-        bothSendCount++;
     }
 }
 
+void MainWindow::handleFusedArmSample(const DualArmFusion::Sample &sample)
+{
+    // 只使用有效的一半：另一半还没到过（补齐值为 0）或已超时时不写入历史、不推送，表格保留原值
+    const bool leftValid = sample.validMask & DualArmFusion::LeftArmBit;
+    const bool rightValid = sample.validMask & DualArmFusion::RightArmBit;
+    if (!leftValid && !rightValid) return;
+
+    if (leftValid) {
+        leftArmData.clear();
+        for (int i = 0; i < 7; ++i) {
+            leftArmData.append(sample.joints[i]);
+        }
+        appendLeftHistory(leftArmData, sample.timestampUs);
+    }
+    if (rightValid) {
+        rightArmData.clear();
+        for (int i = 0; i < 7; ++i) {
+            rightArmData.append(sample.joints[7 + i]);
+        }
+        appendRightHistory(rightArmData, sample.timestampUs);
+    }
+    if (leftValid && rightValid) {
+        publishArmSample(SessionFormat::BothArms, sample.joints, 14, sample.timestampUs);
+    } else if (leftValid) {
+        publishArmSample(SessionFormat::LeftArm, sample.joints, 7, sample.timestampUs);
+    } else {
+        publishArmSample(SessionFormat::RightArm, sample.joints + 7, 7, sample.timestampUs);
+    }
+
+    displayScheduler->markDirty(DisplayScheduler::Tables | DisplayScheduler::Charts | DisplayScheduler::Status);
+
+    // 双臂统计按融合后的帧计
+    rxStats[BothArmsStream].addSample(sample.timestampUs);
+    lastFusionSkewUs = sample.skewUs;
+    maxFusionAgeUs = qMax(maxFusionAgeUs, sample.ageUs);
+}
+
 void MainWindow::clearArmDataUI()
 {
     // 清空表格内容
-    ui->leftArmTable->clearContents();
-    ui->rightArmTable->clearContents();
+    leftTableModel->clearValues();
+    rightTableModel->clearValues();
     
     // 清空数据缓存
     leftArmData.clear();
@@ -1618,132 +2501,102 @@ void MainWindow::stopCANPolling()
     }
 }
 
-void MainWindow::onCANLeftArmDataReceived(const QVector<float> &data)
+void MainWindow::onCANLeftArmDataReceived(const QVector<float> &data, qint64 timestampUs)
 {
     if (data.size() != 7) {
-        logMessage(QString("左臽数据格式错误: 期望7个关节, 收到%1个").arg(data.size()));
+        logError(QString("左臂数据格式错误: 期望7个关节, 收到%1个").arg(data.size()));
         return;
     }
 
-    // 更新左臂数据
-    leftArmData.clear();
-    for (int i = 0; i < 7; ++i) {
-        leftArmData.append(data[i]);
+    TRACE_SCOPE_ARG(ArmProcess, SessionFormat::LeftArm);
+    recordCanLatency(timestampUs);
+    float filtered[7];
+    {
+        TRACE_SCOPE(ArmFilter);
+        leftArmFilter.process(timestampUs, data.constData(), filtered);
     }
+    rxStats[LeftArmStream].addSample(timestampUs);
 
-    // 记录历史数据
-    qint64 currentTime = QDateTime::currentDateTime().toMSecsSinceEpoch();
-    static const int MAX_HISTORY = 100;
-    if (leftArmHistory.size() >= MAX_HISTORY) {
-        leftArmHistory.removeFirst();
-    }
-    leftArmHistory.append(leftArmData);
+    // 记录原始数值，显示时再格式化
+    logModel->appendArmSample(LogModel::Info, 0, data.constData(), data.size());
+    sessionRecorder->recordArmSample(timestampUs, SessionFormat::LeftArm, data.constData(), data.size());
 
-    // 更新UI
-    // 单次获取时立即更新表格，持续获取时由定时器更新避免频闪
-    if (!leftArmContinuousEnabled && !rightArmContinuousEnabled && !bothArmsContinuousEnabled) {
-        updateUIWithArmData();
+    // 双臂持续获取：与右臂配对后整体更新
+    if (bothArmsContinuousEnabled) {
+        TRACE_SCOPE_ARG(ArmFusion, SessionFormat::LeftArm);
+        DualArmFusion::Sample fused;
+        if (armFusion.addLeft(timestampUs, filtered, fused)) {
+            handleFusedArmSample(fused);
+        }
+        return;
     }
 
-    // 持续模式时立即更新图表
-    if (leftArmContinuousEnabled || rightArmContinuousEnabled) {
-        updateCharts();
+    // 更新左臂数据（滤波后）
+    leftArmData.clear();
+    for (int i = 0; i < 7; ++i) {
+        leftArmData.append(filtered[i]);
     }
 
-    if (leftArmContinuousEnabled) {
-        leftArmFrameCount++;
-    } else if (bothArmsContinuousEnabled) {
-        bothArmsFrameCount++;
-    }
+    // 记录历史数据
+    appendLeftHistory(leftArmData, timestampUs);
+    publishArmSample(SessionFormat::LeftArm, filtered, 7, timestampUs);
 
-    // 格式化完整日志
-    QString logStr = "收到左臂数据: ";
-    for (int i = 0; i < data.size(); ++i) {
-        logStr += QString::number(data[i], 'f', 2);
-        if (i < data.size() - 1) logStr += ", ";
-    }
-    logMessage(logStr);
+    // 更新UI：只标记，由显示帧统一刷新
+    displayScheduler->markDirty(DisplayScheduler::Tables | DisplayScheduler::Charts | DisplayScheduler::Status);
 }
 
-void MainWindow::onCANRightArmDataReceived(const QVector<float> &data)
+void MainWindow::onCANRightArmDataReceived(const QVector<float> &data, qint64 timestampUs)
 {
     if (data.size() != 7) {
-        logMessage(QString("右臂数据格式错误: 期望7个关节, 收到%1个").arg(data.size()));
+        logError(QString("右臂数据格式错误: 期望7个关节, 收到%1个").arg(data.size()));
         return;
     }
 
-    // 更新右臂数据
-    rightArmData.clear();
-    for (int i = 0; i < 7; ++i) {
-        rightArmData.append(data[i]);
+    TRACE_SCOPE_ARG(ArmProcess, SessionFormat::RightArm);
+    recordCanLatency(timestampUs);
+    float filtered[7];
+    {
+        TRACE_SCOPE(ArmFilter);
+        rightArmFilter.process(timestampUs, data.constData(), filtered);
     }
+    rxStats[RightArmStream].addSample(timestampUs);
 
-    // 记录历史数据
-    qint64 currentTime = QDateTime::currentDateTime().toMSecsSinceEpoch();
-    static const int MAX_HISTORY = 100;
-    if (rightArmHistory.size() >= MAX_HISTORY) {
-        rightArmHistory.removeFirst();
-    }
-    rightArmHistory.append(rightArmData);
+    // 记录原始数值，显示时再格式化
+    logModel->appendArmSample(LogModel::Info, 1, data.constData(), data.size());
+    sessionRecorder->recordArmSample(timestampUs, SessionFormat::RightArm, data.constData(), data.size());
 
-    // 更新UI
-    // 单次获取时立即更新表格，持续获取时由定时器更新避免频闪
-    if (!leftArmContinuousEnabled && !rightArmContinuousEnabled && !bothArmsContinuousEnabled) {
-        updateUIWithArmData();
+    // 双臂持续获取：与左臂配对后整体更新
+    if (bothArmsContinuousEnabled) {
+        TRACE_SCOPE_ARG(ArmFusion, SessionFormat::RightArm);
+        DualArmFusion::Sample fused;
+        if (armFusion.addRight(timestampUs, filtered, fused)) {
+            handleFusedArmSample(fused);
+        }
+        return;
     }
 
-    // 持续模式时立即更新图表
-    if (leftArmContinuousEnabled || rightArmContinuousEnabled) {
-        updateCharts();
+    // 更新右臂数据（滤波后）
+    rightArmData.clear();
+    for (int i = 0; i < 7; ++i) {
+        rightArmData.append(filtered[i]);
     }
 
-    if (rightArmContinuousEnabled) {
-        rightArmFrameCount++;
-    } else if (rightArmContinuousEnabled) {
-        rightArmFrameCount++;
-    } else if (bothArmsContinuousEnabled) {
-        // 双臂模式下也要统计右臂接收（通常左右臂一起回，这里做个冗余或者按需统计，
-        // 前面 updateUIWithArmData 是统一计算频率，这里可以不加，
-        // 但为了日志或者其他逻辑一致性，保持现状或仅在独立模式统计）
-        // 注意：bothArmsFrameCount 在左臂回调里加了，这里不需要再加，否则频率会翻倍
-    }
+    // 记录历史数据
+    appendRightHistory(rightArmData, timestampUs);
+    publishArmSample(SessionFormat::RightArm, filtered, 7, timestampUs);
 
-    // 格式化完整日志
-    QString logStr = "收到右臂数据: ";
-    for (int i = 0; i < data.size(); ++i) {
-        logStr += QString::number(data[i], 'f', 2);
-        if (i < data.size() - 1) logStr += ", ";
-    }
-    logMessage(logStr);
+    // 更新UI：只标记，由显示帧统一刷新
+    displayScheduler->markDirty(DisplayScheduler::Tables | DisplayScheduler::Charts | DisplayScheduler::Status);
 }
 
 void MainWindow::onCANLogMessage(const QString &message, const QString &type)
 {
-    // 根据类型添加颜色标识
-    QString color;
-    if (type == "error") {
-        color = "red";
-    } else if (type == "success") {
-        color = "green";
-    } else if (type == "warning") {
-        color = "orange";
-    } else if (type == "response") {
-        color = "blue";
-    } else {
-        logMessage(message);
-        return;
-    }
-
-    QString timestamp = getCurrentTimeString();
-    ui->logTextEdit->append(QString("<span style='color:%1'>%2 %3</span>").arg(color).arg(timestamp).arg(message));
-
-    QTextCursor cursor = ui->logTextEdit->textCursor();
-    cursor.movePosition(QTextCursor::End);
-    ui->logTextEdit->setTextCursor(cursor);
+    // 根据类型确定级别（颜色由日志模型按级别显示）
+    logModel->append(LogModel::severityFromType(type), message);
 }
 
 void MainWindow::onCANErrorOccurred(const QString &error)
 {
-    logMessage("CAN错误: " + error);
+    logError("CAN错误: " + error);
     showStatusMessage("CAN错误: " + error);
 }
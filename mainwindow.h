@@ -4,6 +4,7 @@
 #include <QMainWindow>
 #include <QSerialPort>
 #include <QTimer>
+#include <QContiguousCache>
 
 #include <QtCharts/QChart>
 #include <QtCharts/QLineSeries>
@@ -11,14 +12,32 @@
 #include <QtCharts/QDateTimeAxis>
 
 #include "serialprotocol.h"
+#include "chartdecimator.h"
+#include "armsample.h"
+#include "displayscheduler.h"
+#include "streamstats.h"
+#include "sessionrecorder.h"
+#include "sessionreplayer.h"
+#include "seriallink.h"
+#include "armstateshm.h"
+#include "armstreampublisher.h"
+#include "trajectorystreamer.h"
+#include "jointfilter.h"
+#include "dualarmfusion.h"
+#include "latencytracker.h"
+#include "armkinematics.h"
 
 #define APP_VERSION "1.0.0"
 
 // 前向声明
 class CANCommunication;
+class LogModel;
+class LogFilterProxyModel;
+class ArmTableModel;
 class QPushButton;
 class QLabel;
 class QSpinBox;
+class QComboBox;
 
 namespace Ui {
 class MainWindow;
@@ -40,11 +59,24 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // 整臂扭矩设定：多个关节打包进同一帧（每帧最多 15 个），一次写出；串口未连接时返回 false
+    // 下位机回复未知命令后自动改为逐关节单帧发送
+    bool sendTorqueSetpoints(const QVector<SerialProtocol::JointSetpoint> &setpoints);
+
+    // 把原始数据直接送入与实时接收相同的解码流程（入口与会话回放相同），供离屏吞吐量测试使用
+    void injectSerialBytes(const QByteArray &data, qint64 timestampUs);
+    void injectCanFrame(const CANDataFrame &frame);
+
+    // 构造函数耗时（微秒）
+    qint64 constructionTimeUs() const { return constructionUs; }
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
     // 串口相关
     void onConnectClicked();
     void onPortsRefreshed();
-    void onSerialDataReceived();
     void onSerialErrorOccurred(QSerialPort::SerialPortError error);
 
     // 臂控制
@@ -57,10 +89,17 @@ private slots:
 
     // 扭矩设置
     void onTorqueSetClicked();
+    void onTorqueSetAllClicked();
+    void onTrajectoryClicked();
+    void onTrajectoryFinished();
+    void onFilterChanged(int index);
 
     // 定时器
     void onContinuousTimer();
-    void updateCharts();
+    bool updateCharts();
+
+    // 显示帧：集中刷新本帧内变化的子系统
+    void onDisplayFrame(DisplayScheduler::Subsystems dirty);
 
     // 通信模式相关
     void onCommunicationModeChanged(int index);
@@ -81,24 +120,72 @@ private slots:
 
     // CAN相关事件
     void onCANStatusChanged(int status);
-    void onCANLeftArmDataReceived(const QVector<float> &data);
-    void onCANRightArmDataReceived(const QVector<float> &data);
+    void onCANLeftArmDataReceived(const QVector<float> &data, qint64 timestampUs);
+    void onCANRightArmDataReceived(const QVector<float> &data, qint64 timestampUs);
     void onCANLogMessage(const QString &message, const QString &type);
     void onCANErrorOccurred(const QString &error);
 
+    // 日志
+    void flushLog();
+    void onLogLevelChanged(int index);
+    void onExportLogClicked();
+    void onRecordClicked();
+    void onReplayClicked();
+    void onReplayFinished();
+    void onShmPublishToggled(bool enabled);
+    void onStreamPublishToggled(bool enabled);
+    void onTraceToggled(bool enabled);
+    void onExportTraceClicked();
+    void onLatencyOverlayToggled(bool enabled);
+    void onExportLatencyClicked();
+    void onLoadKinematicsClicked();
+
 private:
     Ui::MainWindow *ui;
-    QSerialPort *serialPort;
+    SerialLink *serialLink;
+    QSerialPort *serialPort; // serialLink 内部的串口，用于配置参数
     QTimer *continuousTimer;
-    QTimer *chartUpdateTimer;
-    QTimer *armUpdateTimer;
+    DisplayScheduler *displayScheduler;
     QTimer *versionTimeoutTimer;
     QTimer *versionRetryTimer;
     QTimer *calibrateTimeoutTimer;
 
+    // 日志（环形模型 + 虚拟化视图，按帧批量刷新）
+    LogModel *logModel;
+    LogFilterProxyModel *logProxyModel;
+    SessionRecorder *sessionRecorder;
+    SessionReplayer *sessionReplayer;
+    bool acceptingStreamBeforeReplay = false;
+
+    // 数据推送（UDP / Unix 数据报，批量发送）
+    ArmStreamPublisher *armStreamPublisher;
+
+    // 轨迹下发（独立定时线程生成帧，在本线程写出）
+    TrajectoryStreamer *trajectoryStreamer;
+
+    // 关节角滤波（每臂 7 个关节；解码之后、显示和发布之前）
+    JointFilter leftArmFilter{7};
+    JointFilter rightArmFilter{7};
+
+    // 正运动学（滤波之后；加载参数后才计算），结果写入历史样本并推送
+    ArmKinematics leftKinematics;
+    ArmKinematics rightKinematics;
+
+    // 共享内存发布最新的14关节状态（CAN模式下左右臂分别到达，合并后发布）
+    ArmStateShm::Publisher armStatePublisher;
+    float latestJoints[ArmStateShm::JOINT_COUNT] = {};
+    quint32 latestValidMask = 0;
+
+    // 关节表格模型（只刷新变化的单元格）
+    ArmTableModel *leftTableModel;
+    ArmTableModel *rightTableModel;
+    static constexpr int DEFAULT_DISPLAY_FPS = 30;
+
     // CAN通信
     CANCommunication *canComm;
     CommunicationMode currentMode;
+    bool multiTorqueSupported = true;
+    QVector<SerialProtocol::JointSetpoint> lastMultiTorqueSetpoints;
     QTimer *leftArmPollTimer;
     QTimer *rightArmPollTimer;
     QTimer *bothArmsPollTimer;
@@ -106,55 +193,94 @@ private:
     bool rightArmContinuousEnabled;
     bool bothArmsContinuousEnabled;
 
-    // 频率统计
-    qint64 leftArmStartTime = 0;
-    int leftArmFrameCount = 0;
-    qint64 rightArmStartTime = 0;
-    int rightArmFrameCount = 0;
-    qint64 bothArmsStartTime = 0;
-    int bothArmsFrameCount = 0;
-    qint64 leftSendStartTime = 0;
-    int leftSendCount = 0;
-    qint64 rightSendStartTime = 0;
-    int rightSendCount = 0;
-    qint64 bothSendStartTime = 0;
-    int bothSendCount = 0;
-    
-    // 无线模式频率统计
-    qint64 serialStartTime = 0;
-    int serialRxCount = 0;
+    // 频率/抖动统计：每路数据流的发送和接收各一份
+    enum StreamId {
+        SerialStream = 0,
+        LeftArmStream,
+        RightArmStream,
+        BothArmsStream,
+        StreamCount
+    };
+    StreamStats txStats[StreamCount];
+    StreamStats rxStats[StreamCount];
+    // 端到端延迟（串口和 CAN 分开统计）
+    LatencyTracker serialLatency;
+    LatencyTracker canLatency;
+    QLabel *latencyOverlay = nullptr;
+    // 显示帧更新了可见内容，等待表格/曲线视口真正绘制后再记录显示延迟
+    bool latencyPaintPending = false;
+    bool latencyStampQueued = false;
+    void watchLatencyPaint(QWidget *viewport);
+    void recordCanLatency(qint64 arrivalUs);
+    void updateLatencyOverlay();
+
+    // 双臂持续获取：左右臂按请求周期配对成一帧
+    DualArmFusion armFusion;
+    qint64 lastFusionSkewUs = 0;
+    qint64 maxFusionAgeUs = 0;
+    void handleFusedArmSample(const DualArmFusion::Sample &sample);
     
     // 动态添加的按钮
     QPushButton *canBothArmsSingleButton = nullptr;
     QPushButton *canBothArmsContinuousButton = nullptr;
+    QComboBox *fusionModeComboBox = nullptr;
 
-    QByteArray rxBuffer;
     bool streamEnabled = false;
     bool acceptingStream = false; // 臂数据获取开关（停止后不再更新UI，但仍可继续读串口）
+    bool injectingStream = false; // injectSerialBytes() 注入的数据按推送处理，不改动 acceptingStream
+    bool serialStreamActive() const { return acceptingStream || injectingStream; }
     int versionRequestCount = 0;
     bool versionReceived = false;
     bool calibrating = false; // 校准状态标志，true表示正在等待校准响应
+    qint64 constructionUs = 0;
 
     // 数据存储
+    // 历史数据上限：1kHz 下约60秒；曲线按时间窗口滚动显示
+    static constexpr int MAX_HISTORY = 60000;
+    static constexpr qint64 CHART_WINDOW_US = 60LL * 1000 * 1000;
     QVector<float> leftArmData;
     QVector<float> rightArmData;
-    QVector<QVector<float>> leftArmHistory;
-    QVector<QVector<float>> rightArmHistory;
+    QContiguousCache<ArmHistoryEntry> leftArmHistory;
+    QContiguousCache<ArmHistoryEntry> rightArmHistory;
+
+    // 历史数据 -> 曲线之间的降采样
+    ChartDecimator leftDecimator;
+    ChartDecimator rightDecimator;
+    QVector<QPointF> chartPointBuffer;
 
     // 图表
-    QChart *leftArmChart;
-    QChart *rightArmChart;
+    // 第一次显示曲线页时才创建（ensureJointCharts），之前均为空
+    QChart *leftArmChart = nullptr;
+    QChart *rightArmChart = nullptr;
     QVector<QLineSeries*> leftSeries;
     QVector<QLineSeries*> rightSeries;
     // 左右臂分别使用独立的坐标轴，避免一个 axis 被两个 QChart 拥有导致段错误
-    QDateTimeAxis *leftAxisX;
-    QValueAxis *leftAxisY;
-    QDateTimeAxis *rightAxisX;
-    QValueAxis *rightAxisY;
+    QDateTimeAxis *leftAxisX = nullptr;
+    QValueAxis *leftAxisY = nullptr;
+    QDateTimeAxis *rightAxisX = nullptr;
+    QValueAxis *rightAxisY = nullptr;
+    QWidget *chartTab = nullptr;
+
+    // 末端位姿曲线：位置（mm）和姿态（°）各用一个纵轴
+    struct PoseChart {
+        QChart *chart = nullptr;
+        QVector<QLineSeries*> series;
+        QDateTimeAxis *axisX = nullptr;
+        QValueAxis *positionAxis = nullptr;
+        QValueAxis *angleAxis = nullptr;
+        ChartDecimator decimator{POSE_CHANNELS};
+    };
+    PoseChart leftPose;
+    PoseChart rightPose;
+    QWidget *poseTab = nullptr;
 
     // 初始化函数
     void initUI();
     void initCharts();
+    void initPoseChart(PoseChart &pose, const QString &title, const QString &prefix);
+    // 曲线页第一次显示时创建图表，已创建时直接返回
+    void ensureJointCharts();
+    void ensurePoseCharts();
     void initConnections();
 
     // 串口操作
@@ -163,19 +289,43 @@ private:
     void writeData(const QByteArray &data);
 
     // 数据解析
-    void processArmData(const QVector<float> &data);
-    void updateUIWithArmData();
-    void handleProtocolFrame(const SerialProtocol::Frame &frame);
+    void processArmData(const QVector<float> &data, qint64 timestampUs);
+    void appendLeftHistory(const QVector<float> &data, qint64 timestampUs);
+    void appendRightHistory(const QVector<float> &data, qint64 timestampUs);
+    void appendHistory(QContiguousCache<ArmHistoryEntry> &history, ChartDecimator &decimator,
+                       const QVector<float> &data, qint64 timestampUs, SessionFormat::ArmId arm);
+    // 计算末端位姿写入 entry 并推送；未加载参数时返回 false
+    bool updatePose(SessionFormat::ArmId arm, ArmHistoryEntry &entry);
+    void syncDecimatorColumns();
+    void syncPoseDecimatorColumns();
+    bool updatePoseCharts();
+    // 返回是否有可见的表格单元格变化
+    bool updateUIWithArmData();
+    void updateRateStatus();
+    void resetStreamStats(StreamId stream);
+    QString formatStreamStats(StreamId stream, qint64 nowUs) const;
+    // 把一个臂样本交给共享内存和数据推送（armId 取 SessionFormat::ArmId）
+    void publishArmSample(quint16 armId, const float *values, int count, qint64 timestampUs);
+    // 按轨迹下拉框的选择生成轨迹；取消或失败时返回 false
+    bool buildSelectedTrajectory(Trajectory &trajectory);
+    // 全部关节正弦轨迹的最大幅值（°），避免 14 个关节同时大幅摆动
+    static constexpr float MAX_ALL_JOINT_AMPLITUDE = 15.0f;
+    void handleProtocolFrame(const SerialProtocol::Frame &frame, qint64 timestampUs);
+    // 轨迹下发期间的扭矩应答（计数，不逐帧显示）
+    void trajectoryAck(quint8 result, const QString &failText);
+
     void ensureStreamEnabled();
 
     // 日志记录
     void logMessage(const QString &message);
+    // 警告/错误级别：按级别筛选日志时不会被隐藏
+    void logWarning(const QString &message);
+    void logError(const QString &message);
     void logHexData(const QByteArray &data, bool isSend = false);
 
     // 工具函数
     void setOperationButtonsEnabled(bool enabled);
     void sendVersionRequest();
-    QString getCurrentTimeString();
     void showStatusMessage(const QString &message, int timeout = 5000);
     void startVersionTimeout();
     void stopVersionTimeout();
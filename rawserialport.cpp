@@ -0,0 +1,312 @@
+#include "rawserialport.h"
+#include "acqclock.h"
+#include "log.h"
+#include "trace.h"
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_LINUX
+// termios2 / BOTHER 只在内核头文件里，不能与 <termios.h> 同时包含
+#include <asm/termbits.h>
+#include <linux/serial.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+RawSerialPort::RawSerialPort(QObject *parent)
+    : QThread(parent)
+{
+}
+
+RawSerialPort::~RawSerialPort()
+{
+    close();
+}
+
+bool RawSerialPort::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef Q_OS_LINUX
+
+bool RawSerialPort::open(const Settings &settings)
+{
+    close();
+    m_errorString.clear();
+    m_lowLatency = false;
+    m_readErrno.store(0);
+    m_stopping.store(false);
+
+    const QString devicePath = settings.portName.startsWith('/') ? settings.portName : "/dev/" + settings.portName;
+    m_fd = ::open(QFile::encodeName(devicePath).constData(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (m_fd < 0) {
+        m_errorString = QString("无法打开 %1: %2").arg(devicePath, QString::fromLocal8Bit(std::strerror(errno)));
+        return false;
+    }
+    // 与 QSerialPort 一样独占打开
+    ::ioctl(m_fd, TIOCEXCL);
+
+    if (!configure(settings)) {
+        closeFds();
+        return false;
+    }
+    enableLowLatency(devicePath);
+    // 丢弃打开前驱动里积压的数据
+    ::ioctl(m_fd, TCFLSH, TCIOFLUSH);
+
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = m_fd;
+    bool ok = m_epollFd >= 0 && m_wakeFd >= 0 && ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_fd, &event) == 0;
+    event.data.fd = m_wakeFd;
+    ok = ok && ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event) == 0;
+    if (!ok) {
+        m_errorString = QString("epoll 初始化失败: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        closeFds();
+        return false;
+    }
+
+    start(QThread::TimeCriticalPriority);
+    return true;
+}
+
+bool RawSerialPort::configure(const Settings &settings)
+{
+    if (settings.baudRate <= 0) {
+        m_errorString = QString("无效的波特率: %1").arg(settings.baudRate);
+        return false;
+    }
+    if (settings.stopBits == QSerialPort::OneAndHalfStop) {
+        m_errorString = "不支持 1.5 停止位";
+        return false;
+    }
+
+    struct termios2 tio;
+    if (::ioctl(m_fd, TCGETS2, &tio) < 0) {
+        m_errorString = QString("读取串口参数失败: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        return false;
+    }
+
+    // 原始模式：不做任何字符转换、回显和行缓冲
+    tio.c_iflag = 0;
+    tio.c_oflag = 0;
+    tio.c_lflag = 0;
+    tio.c_cflag &= ~(CBAUD | CIBAUD | CSIZE | CSTOPB | PARENB | PARODD | CMSPAR | CRTSCTS);
+    tio.c_cflag |= CREAD | CLOCAL | BOTHER | (BOTHER << IBSHIFT);
+    tio.c_ispeed = static_cast<speed_t>(settings.baudRate);
+    tio.c_ospeed = static_cast<speed_t>(settings.baudRate);
+
+    switch (settings.dataBits) {
+    case QSerialPort::Data5: tio.c_cflag |= CS5; break;
+    case QSerialPort::Data6: tio.c_cflag |= CS6; break;
+    case QSerialPort::Data7: tio.c_cflag |= CS7; break;
+    default: tio.c_cflag |= CS8; break;
+    }
+    switch (settings.parity) {
+    case QSerialPort::EvenParity: tio.c_cflag |= PARENB; break;
+    case QSerialPort::OddParity: tio.c_cflag |= PARENB | PARODD; break;
+    case QSerialPort::SpaceParity: tio.c_cflag |= PARENB | CMSPAR; break;
+    case QSerialPort::MarkParity: tio.c_cflag |= PARENB | CMSPAR | PARODD; break;
+    default: break;
+    }
+    if (settings.parity != QSerialPort::NoParity) tio.c_iflag |= INPCK;
+    if (settings.stopBits == QSerialPort::TwoStop) tio.c_cflag |= CSTOPB;
+    if (settings.flowControl == QSerialPort::HardwareControl) tio.c_cflag |= CRTSCTS;
+    if (settings.flowControl == QSerialPort::SoftwareControl) tio.c_iflag |= IXON | IXOFF;
+
+    // n_tty 在 VTIME=0 时按 VMIN 判断可读：VMIN=1 即收到第一个字节就唤醒 epoll
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+
+    if (::ioctl(m_fd, TCSETS2, &tio) < 0) {
+        m_errorString = QString("设置串口参数失败（波特率 %1）: %2")
+                            .arg(settings.baudRate).arg(QString::fromLocal8Bit(std::strerror(errno)));
+        return false;
+    }
+
+    // 驱动可能把波特率取整到最接近的可用值，偏差过大时提示
+    if (::ioctl(m_fd, TCGETS2, &tio) == 0 && tio.c_ospeed != static_cast<speed_t>(settings.baudRate)) {
+        LOG_AT(Serial, Warning, "串口实际波特率" << tio.c_ospeed << "与设置值" << settings.baudRate << "不同");
+    }
+    return true;
+}
+
+void RawSerialPort::enableLowLatency(const QString &devicePath)
+{
+    // 驱动不支持时忽略（如 CDC-ACM、部分虚拟串口）
+    struct serial_struct serial;
+    if (::ioctl(m_fd, TIOCGSERIAL, &serial) == 0) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        m_lowLatency = ::ioctl(m_fd, TIOCSSERIAL, &serial) == 0;
+    }
+
+    // USB 串口芯片的接收缓冲默认要等 latency_timer（FTDI 为 16ms）或凑满包才上报
+    const QString timerPath = QString("/sys/class/tty/%1/device/latency_timer")
+                                  .arg(QFileInfo(QFileInfo(devicePath).canonicalFilePath()).fileName());
+    QFile timer(timerPath);
+    if (timer.exists() && timer.open(QIODevice::WriteOnly)) {
+        timer.write("1");
+    } else if (timer.exists()) {
+        LOG_AT(Serial, Warning, "无法设置" << timerPath << ":" << timer.errorString());
+    }
+}
+
+void RawSerialPort::close()
+{
+    if (isRunning()) {
+        m_stopping.store(true);
+        const quint64 one = 1;
+        const ssize_t n = ::write(m_wakeFd, &one, sizeof(one));
+        Q_UNUSED(n);
+        wait();
+    }
+    if (m_fd >= 0) {
+        // 等待已写入的数据发送完（tcdrain）
+        ::ioctl(m_fd, TCSBRK, 1);
+    }
+    closeFds();
+}
+
+void RawSerialPort::closeFds()
+{
+    if (m_epollFd >= 0) ::close(m_epollFd);
+    if (m_wakeFd >= 0) ::close(m_wakeFd);
+    if (m_fd >= 0) ::close(m_fd);
+    m_epollFd = m_wakeFd = m_fd = -1;
+}
+
+qint64 RawSerialPort::read(char *data, qint64 maxSize)
+{
+    const ssize_t n = ::read(m_fd, data, static_cast<size_t>(maxSize));
+    if (n >= 0) return n;
+    if (errno == EAGAIN || errno == EINTR) return 0;
+    m_readErrno.store(errno);
+    return -1;
+}
+
+qint64 RawSerialPort::write(const char *data, qint64 size)
+{
+    if (m_fd < 0) return -1;
+
+    qint64 written = 0;
+    const qint64 deadlineUs = AcqClock::nowUs() + WRITE_TIMEOUT_MS * 1000;
+    while (written < size) {
+        const ssize_t n = ::write(m_fd, data + written, static_cast<size_t>(size - written));
+        if (n > 0) {
+            written += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN) return -1;
+
+        // 发送缓冲满：等可写
+        const qint64 remainingMs = (deadlineUs - AcqClock::nowUs()) / 1000;
+        if (remainingMs <= 0) break;
+        pollfd pfd = {m_fd, POLLOUT, 0};
+        ::poll(&pfd, 1, static_cast<int>(remainingMs));
+    }
+    return written;
+}
+
+void RawSerialPort::run()
+{
+    TRACE_THREAD_NAME("serial-rx");
+
+    QString error;
+    epoll_event events[2];
+    while (!m_stopping.load()) {
+        const int count = ::epoll_wait(m_epollFd, events, 2, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            error = QString("epoll 等待失败: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+            break;
+        }
+        // 唤醒后立即打时间戳，作为本批数据中各帧的采集时间
+        const qint64 rxTimestampUs = AcqClock::nowUs();
+
+        bool readable = false;
+        bool hangup = false;
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd != m_fd) continue;
+            readable = events[i].events & EPOLLIN;
+            hangup = events[i].events & (EPOLLHUP | EPOLLERR);
+        }
+        if (m_stopping.load()) break;
+
+        if (readable && m_readyRead) m_readyRead(rxTimestampUs);
+
+        const int readErrno = m_readErrno.load();
+        if (readErrno != 0) {
+            error = QString("串口读取失败: %1").arg(QString::fromLocal8Bit(std::strerror(readErrno)));
+            break;
+        }
+        // 拔出设备时通常 EPOLLIN | EPOLLHUP 同时到达，先把剩余数据读完再报告
+        if (hangup) {
+            error = "串口已断开";
+            break;
+        }
+    }
+
+    if (!error.isEmpty()) emit errorOccurred(error);
+}
+
+#else
+
+bool RawSerialPort::open(const Settings &settings)
+{
+    Q_UNUSED(settings);
+    m_errorString = "低延迟串口仅支持 Linux";
+    return false;
+}
+
+void RawSerialPort::close()
+{
+}
+
+void RawSerialPort::closeFds()
+{
+}
+
+bool RawSerialPort::configure(const Settings &settings)
+{
+    Q_UNUSED(settings);
+    return false;
+}
+
+void RawSerialPort::enableLowLatency(const QString &devicePath)
+{
+    Q_UNUSED(devicePath);
+}
+
+qint64 RawSerialPort::read(char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+qint64 RawSerialPort::write(const char *data, qint64 size)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+    return -1;
+}
+
+void RawSerialPort::run()
+{
+}
+
+#endif
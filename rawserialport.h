@@ -0,0 +1,79 @@
+#ifndef RAWSERIALPORT_H
+#define RAWSERIALPORT_H
+
+#include <QThread>
+#include <QSerialPort>
+#include <QString>
+#include <atomic>
+#include <functional>
+
+// Linux 低延迟串口：直接操作 tty 文件描述符，绕过 QSerialPort 的事件循环和内部缓冲。
+// - 打开时设置 ASYNC_LOW_LATENCY，USB 串口（FTDI 等）同时把 latency_timer 调到 1ms
+// - VMIN=1 / VTIME=0：收到一个字节 epoll 就返回，不等凑够数据
+// - 用 termios2 + BOTHER 设置波特率，支持任意整数波特率
+// - 读线程用 epoll 等待数据，醒来后立即打时间戳并在读线程中调用 readyRead 回调，回调里用 read() 取数据
+// 其他平台上 open() 直接失败。
+class RawSerialPort : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Settings {
+        QString portName;           // 如 ttyUSB0 或 /dev/ttyUSB0
+        qint32 baudRate = 2000000;
+        QSerialPort::DataBits dataBits = QSerialPort::Data8;
+        QSerialPort::Parity parity = QSerialPort::NoParity;
+        QSerialPort::StopBits stopBits = QSerialPort::OneStop;
+        QSerialPort::FlowControl flowControl = QSerialPort::NoFlowControl;
+    };
+
+    // 参数为 epoll 返回时刻（AcqClock 微秒）
+    using ReadyReadHandler = std::function<void(qint64 rxTimestampUs)>;
+
+    explicit RawSerialPort(QObject *parent = nullptr);
+    ~RawSerialPort();
+
+    static bool isSupported();
+
+    // 回调在读线程中执行；必须在 open() 之前设置
+    void setReadyReadHandler(ReadyReadHandler handler) { m_readyRead = std::move(handler); }
+
+    // 打开串口并启动读线程；失败时返回 false，原因见 errorString()
+    bool open(const Settings &settings);
+    // 停止读线程，等待发送完成后关闭
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+    QString errorString() const { return m_errorString; }
+    // 驱动是否接受了 ASYNC_LOW_LATENCY
+    bool lowLatencyEnabled() const { return m_lowLatency; }
+
+    // 非阻塞读，只在 readyRead 回调中调用；返回读到的字节数，没有数据返回 0，出错返回 -1
+    qint64 read(char *data, qint64 maxSize);
+    // 写出全部数据（发送缓冲满时最多等待 WRITE_TIMEOUT_MS），由打开串口的线程调用；返回写出的字节数，出错返回 -1
+    qint64 write(const char *data, qint64 size);
+
+signals:
+    // 读线程检测到设备断开或读错误，随后读线程退出；使用方应调用 close()
+    void errorOccurred(const QString &error);
+
+protected:
+    void run() override;
+
+private:
+    static constexpr int WRITE_TIMEOUT_MS = 1000;
+
+    bool configure(const Settings &settings);
+    void enableLowLatency(const QString &devicePath);
+    void closeFds();
+
+    int m_fd = -1;
+    int m_epollFd = -1;
+    int m_wakeFd = -1;              // eventfd：close() 时唤醒读线程退出
+    std::atomic<bool> m_stopping{false};
+    std::atomic<int> m_readErrno{0}; // read() 出错时记录，读线程据此退出
+    ReadyReadHandler m_readyRead;
+    QString m_errorString;
+    bool m_lowLatency = false;
+};
+
+#endif // RAWSERIALPORT_H
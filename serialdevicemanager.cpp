@@ -0,0 +1,280 @@
+#include "serialdevicemanager.h"
+#include "acqclock.h"
+#include "sessionrecorder.h"
+#include "trace.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <atomic>
+
+// 单个设备：创建后移动到所属工作线程，open/close/write 都在该线程中执行
+class SerialDeviceManager::Device : public QObject
+{
+public:
+    Device(int index, const DeviceConfig &config, int worker, SerialDeviceManager *manager)
+        : index(index), config(config), worker(worker), m_manager(manager)
+    {
+    }
+
+    bool open(QString *error);
+    void close();
+    void write(const QByteArray &data);
+    DeviceStatus status() const;
+
+    const int index;
+    const DeviceConfig config;
+    const int worker;
+    SessionRecorder *recorder = nullptr;   // 由管理器创建和释放；只在本设备线程中写入
+
+private:
+    SerialDeviceManager *m_manager;
+    SerialLink *m_link = nullptr;
+    std::atomic<bool> m_open{false};
+
+    // 统计：设备线程写，status() 在其他线程读
+    mutable QMutex m_statsMutex;
+    StreamStats m_sampleStats;
+    quint64 m_rxBytes = 0;
+    quint64 m_frames = 0;
+    quint64 m_invalidFrames = 0;
+
+    void onFrame(const SerialProtocol::Frame &frame, qint64 timestampUs);
+};
+
+bool SerialDeviceManager::Device::open(QString *error)
+{
+    m_link = new SerialLink(this);
+    QSerialPort *port = m_link->port();
+    port->setPortName(config.portName);
+    port->setBaudRate(config.baudRate);
+    port->setDataBits(QSerialPort::Data8);
+    port->setParity(QSerialPort::NoParity);
+    port->setStopBits(QSerialPort::OneStop);
+    port->setFlowControl(QSerialPort::NoFlowControl);
+    if (!m_link->open(config.backend)) {
+        *error = QString("无法打开串口 %1: %2").arg(config.portName, m_link->errorString());
+        delete m_link;
+        m_link = nullptr;
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_statsMutex);
+        m_sampleStats.reset(AcqClock::nowUs());
+    }
+    connect(m_link, &SerialLink::frameReceived, this, [this](const SerialProtocol::Frame &frame, qint64 timestampUs) {
+        onFrame(frame, timestampUs);
+    });
+    connect(m_link, &SerialLink::invalidFrame, this, [this]() {
+        QMutexLocker locker(&m_statsMutex);
+        ++m_invalidFrames;
+    });
+    connect(m_link, &SerialLink::bytesReceived, this, [this](const QByteArray &data, qint64 rxTimestampUs) {
+        {
+            QMutexLocker locker(&m_statsMutex);
+            m_rxBytes += data.size();
+        }
+        if (recorder) recorder->recordSerialBytes(rxTimestampUs, false, data);
+    });
+    connect(m_link, &SerialLink::bytesSent, this, [this](const QByteArray &data, qint64 txTimestampUs) {
+        if (recorder) recorder->recordSerialBytes(txTimestampUs, true, data);
+    });
+    connect(port, &QSerialPort::errorOccurred, this, [this](QSerialPort::SerialPortError portError) {
+        if (portError == QSerialPort::NoError || !m_link) return;
+        emit m_manager->deviceError(index, m_link->port()->errorString());
+        if (portError == QSerialPort::ResourceError) close();
+    });
+    connect(m_link, &SerialLink::errorOccurred, this, [this](const QString &linkError) {
+        emit m_manager->deviceError(index, linkError);
+        close();
+    });
+
+    m_open.store(true);
+    if (config.enableStream) {
+        m_link->write(SerialProtocol::buildEnableDataStreamCommand());
+    }
+    return true;
+}
+
+void SerialDeviceManager::Device::close()
+{
+    if (!m_link) return;
+    if (m_link->isOpen() && config.enableStream) {
+        m_link->write(SerialProtocol::buildDisableDataStreamCommand());
+    }
+    m_link->close();
+    // 可能在串口自身的信号中调用，延后释放
+    m_link->deleteLater();
+    m_link = nullptr;
+    m_open.store(false);
+}
+
+void SerialDeviceManager::Device::write(const QByteArray &data)
+{
+    if (m_link) m_link->write(data);
+}
+
+void SerialDeviceManager::Device::onFrame(const SerialProtocol::Frame &frame, qint64 timestampUs)
+{
+    {
+        QMutexLocker locker(&m_statsMutex);
+        ++m_frames;
+    }
+    // 56 字节为推送数据，其余为命令响应
+    if (frame.dataLength != 56) {
+        emit m_manager->frameReceived(index, frame, timestampUs);
+        return;
+    }
+
+    TRACE_SCOPE_ARG(ArmProcess, index);
+    QVector<float> armData;
+    if (!SerialProtocol::parseArmData(frame.data, armData) || armData.size() != 14) return;
+    {
+        QMutexLocker locker(&m_statsMutex);
+        m_sampleStats.addSample(timestampUs);
+    }
+    if (recorder) {
+        recorder->recordArmSample(timestampUs, SessionFormat::BothArms, armData.constData(), armData.size());
+    }
+    emit m_manager->armSampleReceived(index, armData, timestampUs);
+}
+
+SerialDeviceManager::DeviceStatus SerialDeviceManager::Device::status() const
+{
+    DeviceStatus status;
+    status.name = config.name.isEmpty() ? config.portName : config.name;
+    status.portName = config.portName;
+    status.worker = worker;
+    status.open = m_open.load();
+    {
+        QMutexLocker locker(&m_statsMutex);
+        status.samples = m_sampleStats.snapshot(AcqClock::nowUs());
+        status.rxBytes = m_rxBytes;
+        status.frames = m_frames;
+        status.invalidFrames = m_invalidFrames;
+    }
+    if (recorder) {
+        status.recordedRecords = recorder->recordsWritten();
+        status.droppedRecords = recorder->droppedRecords();
+    }
+    return status;
+}
+
+SerialDeviceManager::SerialDeviceManager(QObject *parent)
+    : QObject(parent)
+{
+}
+
+SerialDeviceManager::~SerialDeviceManager()
+{
+    stop();
+}
+
+int SerialDeviceManager::addDevice(const DeviceConfig &config)
+{
+    m_configs.append(config);
+    return m_configs.size() - 1;
+}
+
+QString SerialDeviceManager::deviceName(int device) const
+{
+    if (device < 0 || device >= m_configs.size()) return QString();
+    const DeviceConfig &config = m_configs[device];
+    return config.name.isEmpty() ? config.portName : config.name;
+}
+
+bool SerialDeviceManager::start(QString *error)
+{
+    stop();
+    if (m_configs.isEmpty()) {
+        if (error) *error = "未添加串口设备";
+        return false;
+    }
+
+    const int requested = m_requestedWorkers > 0 ? m_requestedWorkers : QThread::idealThreadCount();
+    const int workers = qBound(1, requested, m_configs.size());
+    for (int i = 0; i < workers; ++i) {
+        QThread *thread = new QThread(this);
+        thread->setObjectName(QString("serial-pool-%1").arg(i));
+        // 直接连接：在新线程中执行
+        connect(thread, &QThread::started, [] { TRACE_THREAD_NAME("serial-pool"); });
+        thread->start(QThread::HighPriority);
+        m_workers.append(thread);
+    }
+
+    for (int i = 0; i < m_configs.size(); ++i) {
+        const DeviceConfig &config = m_configs[i];
+        // 轮流分配，设备始终留在同一个线程
+        Device *device = new Device(i, config, i % workers, this);
+        device->moveToThread(m_workers[device->worker]);
+        m_devices.append(device);
+
+        if (!config.recordPath.isEmpty()) {
+            device->recorder = new SessionRecorder(this);
+            connect(device->recorder, &SessionRecorder::errorOccurred, this, [this, i](const QString &recordError) {
+                emit deviceError(i, recordError);
+            });
+            if (!device->recorder->open(config.recordPath)) {
+                if (error) *error = QString("无法录制 %1 到 %2").arg(deviceName(i), config.recordPath);
+                stop();
+                return false;
+            }
+        }
+
+        bool ok = false;
+        QString openError;
+        QMetaObject::invokeMethod(device, [device, &ok, &openError] {
+            ok = device->open(&openError);
+        }, Qt::BlockingQueuedConnection);
+        if (!ok) {
+            if (error) *error = openError;
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void SerialDeviceManager::stop()
+{
+    if (m_workers.isEmpty()) return;
+
+    for (Device *device : m_devices) {
+        QMetaObject::invokeMethod(device, [device] { device->close(); }, Qt::BlockingQueuedConnection);
+    }
+    // 线程结束时会处理延后释放的 SerialLink
+    for (QThread *thread : m_workers) {
+        thread->quit();
+        thread->wait();
+    }
+    m_finalStatus.clear();
+    for (Device *device : m_devices) {
+        if (device->recorder) {
+            device->recorder->close();
+        }
+        m_finalStatus.append(device->status());
+        delete device->recorder;
+        delete device;
+    }
+    m_devices.clear();
+    qDeleteAll(m_workers);
+    m_workers.clear();
+}
+
+SerialDeviceManager::DeviceStatus SerialDeviceManager::status(int device) const
+{
+    if (device >= 0 && device < m_devices.size()) return m_devices[device]->status();
+    if (device >= 0 && device < m_finalStatus.size()) return m_finalStatus[device];
+
+    DeviceStatus status;
+    status.name = deviceName(device);
+    if (device >= 0 && device < m_configs.size()) status.portName = m_configs[device].portName;
+    return status;
+}
+
+void SerialDeviceManager::write(int device, const QByteArray &data)
+{
+    if (device < 0 || device >= m_devices.size()) return;
+    Device *target = m_devices[device];
+    QMetaObject::invokeMethod(target, [target, data] { target->write(data); }, Qt::QueuedConnection);
+}
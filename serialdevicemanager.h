@@ -0,0 +1,85 @@
+#ifndef SERIALDEVICEMANAGER_H
+#define SERIALDEVICEMANAGER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include "seriallink.h"
+#include "streamstats.h"
+
+class QThread;
+
+// 多设备串口采集：同一进程同时打开 N 个串口（每台无线遥操臂一个），
+// 每个设备有自己的 SerialLink（拆帧缓冲区）、接收统计和录制文件。
+// 设备按顺序轮流分配到一个小线程池（默认 min(设备数, CPU 核数) 个线程），分配后固定不变；
+// 串口收发、拆帧、解码和录制都在该设备所在的线程中完成，解码后的样本通过信号排队发到接收方线程。
+// addDevice / start / stop 只能在创建管理器的线程中调用。
+class SerialDeviceManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct DeviceConfig {
+        QString name;                   // 显示名，空时使用串口名
+        QString portName;
+        qint32 baudRate = 2000000;
+        SerialLink::Backend backend = SerialLink::QtBackend;
+        QString recordPath;             // 非空时把该设备的原始帧和臂数据录制到此文件
+        bool enableStream = true;       // 打开后发送启用数据推送命令，停止前发送禁用命令
+    };
+
+    struct DeviceStatus {
+        QString name;
+        QString portName;
+        int worker = -1;                // 所在工作线程
+        bool open = false;
+        StreamStats::Snapshot samples;  // 臂数据样本的频率/间隔统计
+        quint64 rxBytes = 0;
+        quint64 frames = 0;             // 通过校验的帧
+        quint64 invalidFrames = 0;
+        quint64 recordedRecords = 0;
+        quint64 droppedRecords = 0;
+    };
+
+    explicit SerialDeviceManager(QObject *parent = nullptr);
+    ~SerialDeviceManager();
+
+    // 工作线程数，<= 0 为自动；start() 之前设置
+    void setWorkerCount(int count) { m_requestedWorkers = count; }
+    int workerCount() const { return m_workers.size(); }
+
+    // 添加设备（start() 之前），返回设备序号
+    int addDevice(const DeviceConfig &config);
+    int deviceCount() const { return m_configs.size(); }
+    QString deviceName(int device) const;
+
+    // 打开所有设备；任一设备失败时关闭已打开的设备并返回 false，原因写入 error
+    bool start(QString *error = nullptr);
+    // 关闭所有设备、结束录制并停止工作线程
+    void stop();
+    bool isRunning() const { return !m_workers.isEmpty(); }
+
+    // 运行中任意线程可调用；stop() 之后返回停止时的最终统计
+    DeviceStatus status(int device) const;
+    // 在设备所在线程中发送（不等待）
+    void write(int device, const QByteArray &data);
+
+signals:
+    // 14 个关节的推送数据（从设备所在线程发出）
+    void armSampleReceived(int device, const QVector<float> &joints, qint64 timestampUs);
+    // 推送数据以外的帧（命令响应）
+    void frameReceived(int device, const SerialProtocol::Frame &frame, qint64 timestampUs);
+    // 打开后的串口错误；设备断开时该设备随即关闭，其他设备不受影响
+    void deviceError(int device, const QString &error);
+
+private:
+    class Device;
+
+    int m_requestedWorkers = 0;
+    QVector<DeviceConfig> m_configs;
+    QVector<QThread *> m_workers;
+    QVector<Device *> m_devices;
+    QVector<DeviceStatus> m_finalStatus;
+};
+
+#endif // SERIALDEVICEMANAGER_H
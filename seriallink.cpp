@@ -0,0 +1,144 @@
+#include "seriallink.h"
+#include "acqclock.h"
+#include "rawserialport.h"
+#include "trace.h"
+#include <QMutexLocker>
+
+SerialLink::SerialLink(QObject *parent)
+    : QObject(parent)
+    , m_port(new QSerialPort(this))
+    , m_raw(new RawSerialPort(this))
+{
+    // 低延迟后端从读线程发出帧信号
+    qRegisterMetaType<SerialProtocol::Frame>("SerialProtocol::Frame");
+
+    connect(m_port, &QSerialPort::readyRead, this, &SerialLink::onReadyRead);
+    m_raw->setReadyReadHandler([this](qint64 rxTimestampUs) { onRawReadyRead(rxTimestampUs); });
+    connect(m_raw, &RawSerialPort::errorOccurred, this, &SerialLink::errorOccurred);
+}
+
+SerialLink::~SerialLink()
+{
+    m_raw->close();
+}
+
+bool SerialLink::lowLatencyAvailable()
+{
+    return RawSerialPort::isSupported();
+}
+
+bool SerialLink::open(Backend backend)
+{
+    close();
+    m_backend = backend;
+    clearBuffer();
+
+    if (backend == QtBackend) {
+        return m_port->open(QIODevice::ReadWrite);
+    }
+
+    RawSerialPort::Settings settings;
+    settings.portName = m_port->portName();
+    settings.baudRate = m_port->baudRate();
+    settings.dataBits = m_port->dataBits();
+    settings.parity = m_port->parity();
+    settings.stopBits = m_port->stopBits();
+    settings.flowControl = m_port->flowControl();
+    return m_raw->open(settings);
+}
+
+void SerialLink::close()
+{
+    if (m_port->isOpen()) {
+        m_port->flush();
+        m_port->close();
+    }
+    m_raw->close();
+}
+
+bool SerialLink::isOpen() const
+{
+    return m_port->isOpen() || m_raw->isOpen();
+}
+
+QString SerialLink::errorString() const
+{
+    return m_backend == LowLatencyBackend ? m_raw->errorString() : m_port->errorString();
+}
+
+bool SerialLink::write(const QByteArray &data)
+{
+    if (m_raw->isOpen()) {
+        if (m_raw->write(data.constData(), data.size()) != data.size()) return false;
+    } else if (m_port->isOpen()) {
+        m_port->write(data);
+    } else {
+        return false;
+    }
+    emit bytesSent(data, AcqClock::nowUs());
+    return true;
+}
+
+void SerialLink::clearBuffer()
+{
+    QMutexLocker locker(&m_bufferMutex);
+    m_rxBuffer.clear();
+}
+
+void SerialLink::onReadyRead()
+{
+    const QByteArray data = m_port->readAll();
+    if (data.isEmpty()) return;
+    TRACE_SCOPE_ARG(SerialRead, data.size());
+
+    // 串口无硬件时间戳，以本次读到数据的时刻作为其中各帧的采集时间
+    const qint64 rxTimestampUs = AcqClock::nowUs();
+    emit bytesReceived(data, rxTimestampUs);
+
+    feed(data, rxTimestampUs);
+}
+
+void SerialLink::onRawReadyRead(qint64 rxTimestampUs)
+{
+    // 读线程：直接读到拆帧缓冲区末尾，省去 readAll() 的中间缓冲
+    QMutexLocker locker(&m_bufferMutex);
+    while (true) {
+        const int used = m_rxBuffer.size();
+        m_rxBuffer.resize(used + RAW_READ_CHUNK);
+        const qint64 n = m_raw->read(m_rxBuffer.data() + used, RAW_READ_CHUNK);
+        m_rxBuffer.resize(used + static_cast<int>(qMax<qint64>(0, n)));
+        if (n <= 0) break;
+
+        TRACE_SCOPE_ARG(SerialRead, n);
+        emit bytesReceived(m_rxBuffer.mid(used), rxTimestampUs);
+        extractFrames(rxTimestampUs);
+        if (n < RAW_READ_CHUNK) break;
+    }
+}
+
+void SerialLink::feed(const QByteArray &data, qint64 rxTimestampUs)
+{
+    QMutexLocker locker(&m_bufferMutex);
+    m_rxBuffer.append(data);
+    extractFrames(rxTimestampUs);
+}
+
+void SerialLink::extractFrames(qint64 rxTimestampUs)
+{
+    TRACE_SCOPE_NAMED(trace, FrameExtract);
+
+    // 循环拆帧：处理粘包/拆包
+    int frames = 0;
+    while (true) {
+        const auto optFrame = SerialProtocol::tryExtractFrame(m_rxBuffer);
+        if (!optFrame.has_value()) break;
+        TRACE_SET_ARG(trace, ++frames);
+
+        const SerialProtocol::Frame &frame = optFrame.value();
+        if (!SerialProtocol::validateFrame(frame)) {
+            emit invalidFrame(frame);
+            continue;
+        }
+        emit frameReceived(frame, rxTimestampUs);
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef SERIALLINK_H
+#define SERIALLINK_H
+
+#include <QObject>
+#include <QSerialPort>
+#include <QByteArray>
+#include <QMutex>
+#include <atomic>
+#include "serialprotocol.h"
+
+class RawSerialPort;
+
+// 串口链路：串口收发 + 拆帧（粘包/拆包重组）
+// 每次读到数据时以该时刻作为采集时间戳；串口参数由使用方通过 port() 配置。
+// 不依赖任何界面模块，GUI 和命令行工具共用。
+//
+// 两种后端：
+//   QtBackend          QSerialPort，数据在所属线程的事件循环中处理
+//   LowLatencyBackend  Linux 原始 tty（见 rawserialport.h），读线程直接读进拆帧缓冲区并拆帧，
+//                      各信号从读线程发出（跨线程连接自动排队）
+class SerialLink : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Backend {
+        QtBackend = 0,
+        LowLatencyBackend
+    };
+
+    explicit SerialLink(QObject *parent = nullptr);
+    ~SerialLink();
+
+    QSerialPort *port() const { return m_port; }
+    static bool lowLatencyAvailable();
+
+    // 按 port() 上配置的参数打开串口；失败时返回 false，原因见 errorString()
+    bool open(Backend backend = QtBackend);
+    // 等待数据发送完后关闭
+    void close();
+    bool isOpen() const;
+    Backend backend() const { return m_backend; }
+    QString errorString() const;
+
+    // 发送数据（带发送时间戳信号）；串口未打开时返回 false
+    bool write(const QByteArray &data);
+
+    // 送入一段原始字节进行拆帧（串口读到的数据和会话回放都走这里）
+    void feed(const QByteArray &data, qint64 rxTimestampUs);
+    void clearBuffer();
+
+signals:
+    // 原始字节（用于录制）
+    void bytesReceived(const QByteArray &data, qint64 rxTimestampUs);
+    void bytesSent(const QByteArray &data, qint64 txTimestampUs);
+    // 通过校验的完整帧
+    void frameReceived(const SerialProtocol::Frame &frame, qint64 timestampUs);
+    // 校验失败的帧（已丢弃）
+    void invalidFrame(const SerialProtocol::Frame &frame);
+    // 低延迟后端检测到设备断开或读错误（QtBackend 的错误仍由 port() 的 errorOccurred 发出）
+    void errorOccurred(const QString &error);
+
+private slots:
+    void onReadyRead();
+
+private:
+    // 低延迟后端每次 read() 的最大字节数
+    static constexpr int RAW_READ_CHUNK = 4096;
+
+    QSerialPort *m_port;
+    RawSerialPort *m_raw;
+    Backend m_backend = QtBackend;
+    // 低延迟后端下读线程和回放（界面线程）都会访问拆帧缓冲区
+    QMutex m_bufferMutex;
+    QByteArray m_rxBuffer;
+
+    void onRawReadyRead(qint64 rxTimestampUs);
+    // 从 m_rxBuffer 中拆出所有完整帧；调用方持有 m_bufferMutex
+    void extractFrames(qint64 rxTimestampUs);
+};
+
+Q_DECLARE_METATYPE(SerialProtocol::Frame)
+
+#endif // SERIALLINK_H
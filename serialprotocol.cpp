@@ -1,4 +1,5 @@
 #include "serialprotocol.h"
+#include "trace.h"
 #include <QDebug>
 
 QByteArray SerialProtocol::buildCommandFrame(CommandType cmdType, const QByteArray &data)
@@ -95,13 +96,41 @@ std::optional<SerialProtocol::Frame> SerialProtocol::tryExtractFrame(QByteArray
 bool SerialProtocol::validateFrame(const Frame &frame)
 {
     // 长度限制（文档0x00-0x80）
-    if (frame.dataLength > 0x80) return false;
+    if (frame.dataLength > MAX_DATA_LENGTH) return false;
     if (frame.data.size() != frame.dataLength) return false;
 
     const char calc = calculateChecksum(frame.cmdType, frame.dataLength, frame.data);
     return static_cast<quint8>(calc) == frame.checksum;
 }
 
+QByteArray SerialProtocol::serializeFrame(const Frame &frame)
+{
+    QByteArray raw;
+    raw.reserve(5 + frame.data.size());
+    raw.append(FRAME_HEADER);
+    raw.append(static_cast<char>(frame.cmdType));
+    raw.append(static_cast<char>(frame.dataLength));
+    raw.append(frame.data);
+    raw.append(static_cast<char>(frame.checksum));
+    raw.append(FRAME_TAIL);
+    return raw;
+}
+
+QString SerialProtocol::commandName(quint8 cmdType)
+{
+    switch (cmdType) {
+    case CMD_GET_ARM_DATA: return "GET_ARM_DATA";
+    case CMD_GET_VERSION: return "获取版本号";
+    case CMD_ENABLE_DATA_STREAM: return "开启摇操臂数据推送";
+    case CMD_DISABLE_DATA_STREAM: return "禁止摇操臂数据推送";
+    case CMD_CALIBRATE: return "零点标定";
+    case CMD_TORQUE_CONTROL: return "扭矩设置";
+    case CMD_TORQUE_CONTROL_MULTI: return "多关节扭矩设置";
+    case CMD_SET_PARAMS: return "SET_PARAMS";
+    default: return "UNKNOWN";
+    }
+}
+
 QByteArray SerialProtocol::buildCalibrateCommand()
 {
     return buildCommandFrame(CMD_CALIBRATE);
@@ -127,37 +156,86 @@ QByteArray SerialProtocol::buildGetArmDataCommand()
     return buildCommandFrame(CMD_GET_ARM_DATA);
 }
 
-QByteArray SerialProtocol::buildTorqueControlCommand(quint8 id, float speed, float acceleration, float torque, float position)
+void SerialProtocol::appendJointSetpoint(QByteArray &data, const JointSetpoint &setpoint)
 {
-    QByteArray data;
-
     // ID (1字节)
-    data.append(static_cast<char>(id));
-    
+    data.append(static_cast<char>(setpoint.id));
+
     // Position (2字节, int16小端, 假设无缩放或需要根据协议确认缩放)
-    qint16 posInt = static_cast<qint16>(position);
+    qint16 posInt = static_cast<qint16>(setpoint.position);
     data.append(static_cast<char>(posInt & 0xFF));
     data.append(static_cast<char>((posInt >> 8) & 0xFF));
 
     // Speed (2字节, int16小端)
-    qint16 speedInt = static_cast<qint16>(speed);
+    qint16 speedInt = static_cast<qint16>(setpoint.speed);
     data.append(static_cast<char>(speedInt & 0xFF));
     data.append(static_cast<char>((speedInt >> 8) & 0xFF));
 
     // Acceleration (1字节, uint8)
-    quint8 accInt = static_cast<quint8>(acceleration);
+    quint8 accInt = static_cast<quint8>(setpoint.acceleration);
     data.append(static_cast<char>(accInt));
 
     // Torque (2字节, int16小端)
-    qint16 torqueInt = static_cast<qint16>(torque);
+    qint16 torqueInt = static_cast<qint16>(setpoint.torque);
     data.append(static_cast<char>(torqueInt & 0xFF));
     data.append(static_cast<char>((torqueInt >> 8) & 0xFF));
+}
+
+QByteArray SerialProtocol::buildTorqueControlCommand(quint8 id, float speed, float acceleration, float torque, float position)
+{
+    JointSetpoint setpoint;
+    setpoint.id = id;
+    setpoint.position = position;
+    setpoint.speed = speed;
+    setpoint.acceleration = acceleration;
+    setpoint.torque = torque;
 
+    QByteArray data;
+    data.reserve(JOINT_SETPOINT_SIZE);
+    appendJointSetpoint(data, setpoint);
     return buildCommandFrame(CMD_TORQUE_CONTROL, data);
 }
 
+QByteArray SerialProtocol::buildMultiTorqueControlCommand(const QVector<JointSetpoint> &setpoints)
+{
+    QByteArray frames;
+    const int frameCount = (setpoints.size() + MAX_SETPOINTS_PER_FRAME - 1) / MAX_SETPOINTS_PER_FRAME;
+    frames.reserve(frameCount * (5 + MAX_DATA_LENGTH));
+
+    QByteArray data;
+    data.reserve(MAX_DATA_LENGTH);
+    for (int offset = 0; offset < setpoints.size(); offset += MAX_SETPOINTS_PER_FRAME) {
+        const int count = qMin(MAX_SETPOINTS_PER_FRAME, setpoints.size() - offset);
+
+        // 数量 (1字节) + 每个关节 8 字节，编码与单关节命令相同
+        data.clear();
+        data.append(static_cast<char>(count));
+        for (int i = 0; i < count; ++i) {
+            appendJointSetpoint(data, setpoints[offset + i]);
+        }
+        frames.append(buildCommandFrame(CMD_TORQUE_CONTROL_MULTI, data));
+    }
+    return frames;
+}
+
+QByteArray SerialProtocol::buildTorqueControlCommands(const QVector<JointSetpoint> &setpoints)
+{
+    QByteArray frames;
+    frames.reserve(setpoints.size() * (5 + JOINT_SETPOINT_SIZE));
+
+    QByteArray data;
+    data.reserve(JOINT_SETPOINT_SIZE);
+    for (const JointSetpoint &setpoint : setpoints) {
+        data.clear();
+        appendJointSetpoint(data, setpoint);
+        frames.append(buildCommandFrame(CMD_TORQUE_CONTROL, data));
+    }
+    return frames;
+}
+
 bool SerialProtocol::parseArmData(const QByteArray &data, QVector<float> &armData)
 {
+    TRACE_SCOPE_ARG(ArmDecode, data.size());
     if (data.size() < 56) { // 14个float * 4字节
         return false;
     }
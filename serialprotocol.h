@@ -2,6 +2,7 @@
 #define SERIALPROTOCOL_H
 
 #include <QByteArray>
+#include <QString>
 #include <QVector>
 #include <optional>
 
@@ -16,6 +17,7 @@ public:
         CMD_DISABLE_DATA_STREAM = 0x16, // 禁用数据流
         CMD_CALIBRATE = 0x17,          // 标定
         CMD_TORQUE_CONTROL = 0x30,     // 扭矩控制
+        CMD_TORQUE_CONTROL_MULTI = 0x31, // 多关节扭矩控制（一帧携带多个关节）
         CMD_SET_PARAMS = 0x21          // 参数设置（占位）
     };
 
@@ -30,6 +32,19 @@ public:
     // 帧结构
     static const char FRAME_HEADER = 0xAA;
     static const char FRAME_TAIL = 0x55;
+    static constexpr int MAX_DATA_LENGTH = 0x80;
+
+    // 单个关节的扭矩控制设定值（线上 8 字节：ID + 位置 + 速度 + 加速度 + 扭矩）
+    struct JointSetpoint {
+        quint8 id = 0;
+        float position = 0.0f;
+        float speed = 0.0f;
+        float acceleration = 0.0f;
+        float torque = 0.0f;
+    };
+    static constexpr int JOINT_SETPOINT_SIZE = 8;
+    // 多关节帧数据区：数量(1) + N * 8，受 MAX_DATA_LENGTH 限制，一帧最多 15 个关节
+    static constexpr int MAX_SETPOINTS_PER_FRAME = (MAX_DATA_LENGTH - 1) / JOINT_SETPOINT_SIZE;
 
     // 构建命令帧
     static QByteArray buildCommandFrame(CommandType cmdType, const QByteArray &data = QByteArray());
@@ -48,6 +63,12 @@ public:
     // 校验一帧（头/尾/长度/校验和）
     static bool validateFrame(const Frame &frame);
 
+    // 把解析后的帧还原为线上字节（用于日志/调试输出）
+    static QByteArray serializeFrame(const Frame &frame);
+
+    // 命令码的显示名称
+    static QString commandName(quint8 cmdType);
+
     // 计算校验和
     static char calculateChecksum(quint8 cmdType, quint8 dataLength, const QByteArray &data);
 
@@ -59,12 +80,19 @@ public:
     static QByteArray buildGetArmDataCommand();
 
     static QByteArray buildTorqueControlCommand(quint8 id, float speed, float acceleration, float torque, float position);
+    // 整臂设定值：每 MAX_SETPOINTS_PER_FRAME 个关节打包成一帧，返回所有帧拼接后的字节（可一次写出）
+    static QByteArray buildMultiTorqueControlCommand(const QVector<JointSetpoint> &setpoints);
+    // 逐关节单帧（下位机不支持多关节命令时使用），同样返回拼接后的字节
+    static QByteArray buildTorqueControlCommands(const QVector<JointSetpoint> &setpoints);
     static QByteArray buildSetParamsCommand(quint8 id, float speed, float acceleration, float torque, float target);
 
     static bool parseArmData(const QByteArray &data, QVector<float> &armData);
 
     static QByteArray floatToBytes(float value);
     static float bytesToFloat(const QByteArray &bytes, int offset = 0);
+
+private:
+    static void appendJointSetpoint(QByteArray &data, const JointSetpoint &setpoint);
 };
 
 #endif // SERIALPROTOCOL_H
@@ -0,0 +1,70 @@
+#ifndef SESSIONFORMAT_H
+#define SESSIONFORMAT_H
+
+#include <QtGlobal>
+
+// 会话录制文件格式（小端，只追加）
+// 文件头 FileHeader，之后是连续的记录：RecordHeader + payload（payload 后补齐到 8 字节边界）
+namespace SessionFormat {
+
+constexpr char MAGIC[8] = {'L', 'T', 'A', 'S', 'E', 'S', 'S', '1'};
+// 版本 2 增加末端位姿记录（ArmId LeftPose/RightPose，不是关节角）。
+// 版本 1 的文件是版本 2 的子集，读取端接受 MIN_READ_VERSION ~ VERSION；只认识关节角的读取端应按 id 跳过位姿记录
+constexpr quint32 VERSION = 2;
+constexpr quint32 MIN_READ_VERSION = 1;
+
+struct FileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;     // sizeof(FileHeader)，便于以后扩展
+    qint64 startEpochMs;    // 录制开始的墙上时间
+    qint64 startTimestampUs; // 录制开始的 AcqClock 时间
+};
+static_assert(sizeof(FileHeader) == 32, "FileHeader layout");
+
+enum RecordType : quint8 {
+    SerialBytes = 1,  // 串口原始字节（接收时为一次读到的数据块，可能含半帧）
+    CanFrame    = 2,  // CAN 帧，id 为 CAN ID
+    ArmSample   = 3   // 解码后的臂数据，id 见 ArmId
+};
+
+enum RecordFlags : quint8 {
+    FlagSend = 0x01   // 发送方向（否则为接收）
+};
+
+enum ArmId : quint16 {
+    LeftArm = 0,    // 7 个关节（°）
+    RightArm = 1,   // 7 个关节（°）
+    BothArms = 2,   // 14 个关节（°）
+    LeftPose = 3,   // 末端位姿（armkinematics.h）：x, y, z（mm）, qw, qx, qy, qz；版本 2 起
+    RightPose = 4
+};
+
+constexpr int POSE_VALUES = 7;
+
+// 多设备采集（serialdevicemanager.h）输出的臂数据记录：id 高 8 位为设备序号，低 8 位为 ArmId。
+// 设备 0 与单设备的 id 相同；每个设备各自的录制文件仍使用普通 ArmId
+constexpr int DEVICE_SHIFT = 8;
+constexpr quint16 deviceArmId(int device, ArmId arm)
+{
+    return static_cast<quint16>((device << DEVICE_SHIFT) | arm);
+}
+
+struct RecordHeader {
+    qint64 timestampUs;  // AcqClock 微秒
+    quint8 type;
+    quint8 flags;
+    quint16 id;
+    quint32 size;        // payload 字节数（不含补齐）
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader layout");
+
+// 记录总长度（含补齐）；按 64 位计算，损坏文件中接近 4GB 的 size 不会回绕成很小的值
+constexpr quint64 recordSize(quint32 payloadSize)
+{
+    return sizeof(RecordHeader) + ((static_cast<quint64>(payloadSize) + 7u) & ~static_cast<quint64>(7u));
+}
+
+} // namespace SessionFormat
+
+#endif // SESSIONFORMAT_H
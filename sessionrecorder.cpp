@@ -0,0 +1,258 @@
+#include "sessionrecorder.h"
+#include "acqclock.h"
+#include "trace.h"
+#include <QFile>
+#include <cstring>
+
+// BlockQueue 实现
+bool SessionRecorder::BlockQueue::push(int block)
+{
+    const int tail = m_tail.load(std::memory_order_relaxed);
+    const int next = (tail + 1) % (BLOCK_COUNT + 1);
+    if (next == m_head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    m_slots[tail] = block;
+    m_tail.store(next, std::memory_order_release);
+    return true;
+}
+
+bool SessionRecorder::BlockQueue::pop(int &block)
+{
+    const int head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    block = m_slots[head];
+    m_head.store((head + 1) % (BLOCK_COUNT + 1), std::memory_order_release);
+    return true;
+}
+
+// SessionRecorder 实现
+SessionRecorder::SessionRecorder(QObject *parent)
+    : QThread(parent)
+{
+    // 所有块一次性分配，录制过程中不再分配内存
+    m_blocks.resize(BLOCK_COUNT);
+    for (Block &block : m_blocks) {
+        block.data = QByteArray(BLOCK_SIZE, Qt::Uninitialized);
+    }
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    close();
+}
+
+bool SessionRecorder::open(const QString &fileName)
+{
+    if (m_recording) {
+        close();
+    }
+
+    m_file = new QFile(fileName);
+    if (!m_file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        emit errorOccurred(QString("无法创建录制文件: %1").arg(m_file->errorString()));
+        delete m_file;
+        m_file = nullptr;
+        return false;
+    }
+
+    SessionFormat::FileHeader header;
+    std::memcpy(header.magic, SessionFormat::MAGIC, sizeof(header.magic));
+    header.version = SessionFormat::VERSION;
+    header.headerSize = sizeof(SessionFormat::FileHeader);
+    header.startTimestampUs = AcqClock::nowUs();
+    header.startEpochMs = AcqClock::toEpochMs(header.startTimestampUs);
+    if (m_file->write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        emit errorOccurred(QString("写入录制文件失败: %1").arg(m_file->errorString()));
+        m_file->close();
+        delete m_file;
+        m_file = nullptr;
+        return false;
+    }
+
+    // 重置块队列：全部块归还空闲队列
+    int block;
+    while (m_freeBlocks.pop(block)) {}
+    while (m_fullBlocks.pop(block)) {}
+    for (int i = 0; i < BLOCK_COUNT; ++i) {
+        m_blocks[i].used = 0;
+        m_blocks[i].records = 0;
+        m_freeBlocks.push(i);
+    }
+    m_current.store(-1);
+    m_fullSignal.acquire(m_fullSignal.available());
+
+    m_recordsWritten.store(0, std::memory_order_relaxed);
+    m_bytesWritten.store(sizeof(header), std::memory_order_relaxed);
+    m_droppedRecords.store(0, std::memory_order_relaxed);
+
+    m_fileName = fileName;
+    m_stopping.store(false);
+    m_recording = true;
+    start();
+    return true;
+}
+
+void SessionRecorder::close()
+{
+    if (!m_recording) return;
+
+    submitBlock(m_current.exchange(-1, std::memory_order_acquire));
+    m_stopping.store(true);
+    m_fullSignal.release();
+    wait();
+
+    m_file->close();
+    delete m_file;
+    m_file = nullptr;
+    m_recording = false;
+}
+
+void SessionRecorder::submitBlock(int index)
+{
+    if (index < 0) return;
+    if (m_blocks[index].used > 0) {
+        // 满队列容量等于块总数，这里不会失败
+        m_fullBlocks.push(index);
+        m_fullSignal.release();
+    } else {
+        m_freeBlocks.push(index);
+    }
+}
+
+void SessionRecorder::append(qint64 timestampUs, quint8 type, quint8 flags, quint16 id, const void *payload, quint32 size)
+{
+    if (!m_recording) return;
+
+    const int recordBytes = static_cast<int>(SessionFormat::recordSize(size));
+    // 取出当前块独占；写线程若已在超时时取走，这里得到 -1，改用新块
+    int current = m_current.exchange(-1, std::memory_order_acquire);
+    if (current >= 0 && m_blocks[current].used + recordBytes > BLOCK_SIZE) {
+        submitBlock(current);
+        current = -1;
+    }
+    if (current < 0) {
+        if (!m_freeBlocks.pop(current)) {
+            // 写线程跟不上：丢弃本条记录
+            m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_blocks[current].used = 0;
+        m_blocks[current].records = 0;
+        m_currentStartUs = timestampUs;
+    }
+
+    Block &block = m_blocks[current];
+    char *dst = block.data.data() + block.used;
+
+    SessionFormat::RecordHeader header;
+    header.timestampUs = timestampUs;
+    header.type = type;
+    header.flags = flags;
+    header.id = id;
+    header.size = size;
+    std::memcpy(dst, &header, sizeof(header));
+    if (size > 0) {
+        std::memcpy(dst + sizeof(header), payload, size);
+    }
+    // 补齐字节清零，保证文件内容确定
+    const int padding = recordBytes - static_cast<int>(sizeof(header)) - static_cast<int>(size);
+    if (padding > 0) {
+        std::memset(dst + sizeof(header) + size, 0, padding);
+    }
+    block.used += recordBytes;
+    ++block.records;
+
+    if (timestampUs - m_currentStartUs >= FLUSH_INTERVAL_US) {
+        submitBlock(current);
+    } else {
+        m_current.store(current, std::memory_order_release);
+    }
+}
+
+void SessionRecorder::recordSerialBytes(qint64 timestampUs, bool isSend, const QByteArray &data)
+{
+    // 超过一个块的数据分段记录
+    const quint8 flags = isSend ? SessionFormat::FlagSend : 0;
+    for (int offset = 0; offset < data.size(); offset += MAX_PAYLOAD) {
+        const int size = qMin(MAX_PAYLOAD, data.size() - offset);
+        append(timestampUs, SessionFormat::SerialBytes, flags, 0, data.constData() + offset, size);
+    }
+}
+
+void SessionRecorder::recordCanFrame(qint64 timestampUs, bool isSend, quint16 canId, const QByteArray &data)
+{
+    append(timestampUs, SessionFormat::CanFrame, isSend ? SessionFormat::FlagSend : 0, canId,
+           data.constData(), static_cast<quint32>(qMin(data.size(), 8)));
+}
+
+void SessionRecorder::recordArmSample(qint64 timestampUs, quint16 armId, const float *values, int count)
+{
+    append(timestampUs, SessionFormat::ArmSample, 0, armId, values, static_cast<quint32>(count * sizeof(float)));
+}
+
+// 写线程调用：写出一个块并归还空闲队列
+void SessionRecorder::writeBlock(int index, bool &failed)
+{
+    Block &block = m_blocks[index];
+    TRACE_SCOPE_ARG(RecorderWrite, block.used);
+    if (!failed) {
+        if (m_file->write(block.data.constData(), block.used) == block.used) {
+            m_bytesWritten.fetch_add(block.used, std::memory_order_relaxed);
+            m_recordsWritten.fetch_add(block.records, std::memory_order_relaxed);
+        } else {
+            // 写入失败后不再尝试，之后的记录全部计入丢弃
+            failed = true;
+            emit errorOccurred(QString("写入录制文件失败: %1").arg(m_file->errorString()));
+        }
+    }
+    if (failed) {
+        m_droppedRecords.fetch_add(block.records, std::memory_order_relaxed);
+    }
+    m_freeBlocks.push(index);
+}
+
+void SessionRecorder::run()
+{
+    TRACE_THREAD_NAME("recorder");
+    bool failed = false;
+    while (true) {
+        const bool signalled = m_fullSignal.tryAcquire(1, FLUSH_INTERVAL_US / 1000);
+        // 先读停止标志再取队列：停止前提交的块一定能在本轮取到
+        const bool stopping = m_stopping.load();
+
+        int index;
+        while (m_fullBlocks.pop(index)) {
+            writeBlock(index, failed);
+        }
+
+        // 等待超时说明一个刷新间隔内没有块提交（数据停了或很稀疏）：
+        // 取走采集线程未写满的当前块并刷到文件，进程之后崩溃也不丢这段记录。
+        // 先取当前块再清一次满队列：上面清队列之后采集线程可能又提交了一块并换上新块，
+        // 提交的块比取到的块旧，必须先写
+        if (!signalled && !stopping) {
+            const int partial = m_current.exchange(-1, std::memory_order_acquire);
+            while (m_fullBlocks.pop(index)) {
+                writeBlock(index, failed);
+            }
+            index = partial;
+            if (index >= 0) {
+                if (m_blocks[index].used > 0) {
+                    writeBlock(index, failed);
+                    if (!failed) {
+                        m_file->flush();
+                    }
+                } else {
+                    m_freeBlocks.push(index);
+                }
+            }
+        }
+
+        if (stopping) break;
+    }
+    if (!failed) {
+        m_file->flush();
+    }
+}
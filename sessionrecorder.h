@@ -0,0 +1,98 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QThread>
+#include <QSemaphore>
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <atomic>
+#include "sessionformat.h"
+
+class QFile;
+
+// 会话录制：把收发的原始帧和解码后的臂数据写入二进制文件（格式见 sessionformat.h）
+// 采集线程只把记录拷贝进预分配的内存块，写满（或超过刷新间隔）后通过无锁队列交给写线程；
+// 没有空闲块时直接丢弃记录并计数，采集路径永远不会等待磁盘。
+// 数据停止时写线程在等待超时后取走未写满的当前块，最后的记录不会一直留在内存里。
+// record*() 只能由同一个线程调用（单生产者），通常为数据到达的 GUI 线程。
+class SessionRecorder : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit SessionRecorder(QObject *parent = nullptr);
+    ~SessionRecorder();
+
+    // 打开文件并启动写线程；失败时发出 errorOccurred 并返回 false
+    bool open(const QString &fileName);
+    // 提交剩余数据并等待写线程结束
+    void close();
+    bool isRecording() const { return m_recording; }
+    QString fileName() const { return m_fileName; }
+
+    // 采集线程调用
+    void recordSerialBytes(qint64 timestampUs, bool isSend, const QByteArray &data);
+    void recordCanFrame(qint64 timestampUs, bool isSend, quint16 canId, const QByteArray &data);
+    void recordArmSample(qint64 timestampUs, quint16 armId, const float *values, int count);
+
+    // 统计（任意线程可读）
+    quint64 recordsWritten() const { return m_recordsWritten.load(std::memory_order_relaxed); }
+    quint64 bytesWritten() const { return m_bytesWritten.load(std::memory_order_relaxed); }
+    quint64 droppedRecords() const { return m_droppedRecords.load(std::memory_order_relaxed); }
+
+signals:
+    void errorOccurred(const QString &error);
+
+protected:
+    void run() override;
+
+private:
+    static constexpr int BLOCK_COUNT = 64;
+    static constexpr int BLOCK_SIZE = 64 * 1024;
+    static constexpr qint64 FLUSH_INTERVAL_US = 100000; // 数据较少时最多积攒 100ms 再交给写线程
+    static constexpr int MAX_PAYLOAD = BLOCK_SIZE - static_cast<int>(sizeof(SessionFormat::RecordHeader));
+
+    // 单生产者单消费者环形队列，元素为块下标
+    class BlockQueue {
+    public:
+        bool push(int block);
+        bool pop(int &block);
+    private:
+        int m_slots[BLOCK_COUNT + 1] = {};
+        std::atomic<int> m_head{0}; // 消费者位置
+        std::atomic<int> m_tail{0}; // 生产者位置
+    };
+
+    struct Block {
+        QByteArray data;     // 预分配 BLOCK_SIZE
+        int used = 0;
+        quint32 records = 0;
+    };
+
+    QString m_fileName;
+    bool m_recording = false;
+    std::atomic<bool> m_stopping{false};
+
+    QVector<Block> m_blocks;
+    BlockQueue m_freeBlocks;   // 写线程 -> 采集线程
+    BlockQueue m_fullBlocks;   // 采集线程 -> 写线程
+    QSemaphore m_fullSignal;
+
+    // 采集线程当前正在填充的块（-1 为无）；append() 期间由采集线程取出独占，
+    // 写线程在等待超时时用 exchange 取走，两边不会同时持有同一块
+    std::atomic<int> m_current{-1};
+    qint64 m_currentStartUs = 0;
+
+    std::atomic<quint64> m_recordsWritten{0};
+    std::atomic<quint64> m_bytesWritten{0};
+    std::atomic<quint64> m_droppedRecords{0};
+
+    QFile *m_file = nullptr;
+
+    void append(qint64 timestampUs, quint8 type, quint8 flags, quint16 id, const void *payload, quint32 size);
+    void submitBlock(int index);
+    void writeBlock(int index, bool &failed);
+};
+
+#endif // SESSIONRECORDER_H
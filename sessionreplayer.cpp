@@ -0,0 +1,168 @@
+#include "sessionreplayer.h"
+#include "sessionformat.h"
+#include "acqclock.h"
+#include <cstring>
+
+SessionReplayer::SessionReplayer(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &SessionReplayer::onTick);
+}
+
+SessionReplayer::~SessionReplayer()
+{
+    close();
+}
+
+bool SessionReplayer::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        emit errorOccurred(QString("无法打开录制文件: %1").arg(m_file.errorString()));
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(SessionFormat::FileHeader))) {
+        emit errorOccurred("录制文件格式错误: 文件过短");
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        emit errorOccurred(QString("无法映射录制文件: %1").arg(m_file.errorString()));
+        close();
+        return false;
+    }
+
+    SessionFormat::FileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (std::memcmp(header.magic, SessionFormat::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version < SessionFormat::MIN_READ_VERSION || header.version > SessionFormat::VERSION ||
+        header.headerSize < sizeof(SessionFormat::FileHeader) || static_cast<qint64>(header.headerSize) > m_size) {
+        emit errorOccurred("录制文件格式错误: 文件头无效或版本不支持");
+        close();
+        return false;
+    }
+
+    m_firstRecordOffset = header.headerSize;
+    m_offset = m_firstRecordOffset;
+    m_firstTimestampUs = header.startTimestampUs;
+
+    // 以第一条记录的时间为回放起点（录制开始到第一条数据之间的空闲不回放）
+    if (m_offset + static_cast<qint64>(sizeof(SessionFormat::RecordHeader)) <= m_size) {
+        SessionFormat::RecordHeader first;
+        std::memcpy(&first, m_data + m_offset, sizeof(first));
+        m_firstTimestampUs = first.timestampUs;
+    }
+    return true;
+}
+
+void SessionReplayer::close()
+{
+    stop();
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+    m_offset = 0;
+}
+
+void SessionReplayer::start(double speed)
+{
+    if (!m_data) return;
+
+    m_speed = speed;
+    m_offset = m_firstRecordOffset;
+    m_replayed = 0;
+    m_startNowUs = AcqClock::nowUs();
+    m_clock.start();
+    m_timer->start(0);
+}
+
+void SessionReplayer::stop()
+{
+    m_timer->stop();
+}
+
+void SessionReplayer::dispatch(quint8 type, quint8 flags, quint16 id, const uchar *payload, quint32 size, qint64 timestampUs)
+{
+    if (flags & SessionFormat::FlagSend) return;
+
+    switch (type) {
+    case SessionFormat::SerialBytes:
+        emit serialBytes(QByteArray::fromRawData(reinterpret_cast<const char *>(payload), static_cast<int>(size)), timestampUs);
+        ++m_replayed;
+        break;
+    case SessionFormat::CanFrame:
+        emit canFrame(CANDataFrame(id, QByteArray(reinterpret_cast<const char *>(payload), static_cast<int>(qMin<quint32>(size, 8))), timestampUs));
+        ++m_replayed;
+        break;
+    default:
+        break;
+    }
+}
+
+void SessionReplayer::onTick()
+{
+    const bool asFastAsPossible = m_speed <= 0.0;
+    const qint64 tickStartNs = m_clock.nsecsElapsed();
+    const qint64 elapsedUs = tickStartNs / 1000;
+    qint64 nextDueUs = -1;
+    int processed = 0;
+
+    while (m_offset + static_cast<qint64>(sizeof(SessionFormat::RecordHeader)) <= m_size) {
+        SessionFormat::RecordHeader header;
+        std::memcpy(&header, m_data + m_offset, sizeof(header));
+        // 录制中途被打断时最后一条记录可能不完整；size 来自文件，先检查再计算补齐后的长度
+        if (header.size > m_size - m_offset - static_cast<qint64>(sizeof(header))) {
+            break;
+        }
+        const qint64 recordBytes = static_cast<qint64>(SessionFormat::recordSize(header.size));
+        if (m_offset + recordBytes > m_size) {
+            break;
+        }
+
+        qint64 timestampUs;
+        if (asFastAsPossible) {
+            timestampUs = AcqClock::nowUs();
+        } else {
+            const qint64 dueUs = static_cast<qint64>((header.timestampUs - m_firstTimestampUs) / m_speed);
+            if (dueUs > elapsedUs) {
+                nextDueUs = dueUs;
+                break;
+            }
+            timestampUs = m_startNowUs + dueUs;
+        }
+
+        dispatch(header.type, header.flags, header.id,
+                 m_data + m_offset + sizeof(header), header.size, timestampUs);
+        m_offset += recordBytes;
+
+        // 每处理一批检查一次时间片，避免长时间阻塞事件循环
+        if (asFastAsPossible && (++processed & 0xFF) == 0 &&
+            m_clock.nsecsElapsed() - tickStartNs > AFAP_SLICE_NS) {
+            m_timer->start(0);
+            return;
+        }
+    }
+
+    if (nextDueUs >= 0) {
+        // 等到下一条记录的时间；较长的空闲分段等待，停止回放时能及时响应
+        const qint64 waitMs = (nextDueUs - m_clock.nsecsElapsed() / 1000) / 1000;
+        m_timer->start(static_cast<int>(qBound<qint64>(0, waitMs, 50)));
+        return;
+    }
+
+    emit finished();
+}
@@ -0,0 +1,67 @@
+#ifndef SESSIONREPLAYER_H
+#define SESSIONREPLAYER_H
+
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "canprotocol.h"
+
+// 会话回放：把录制文件（见 sessionformat.h）映射到内存，按原始节奏、N 倍速或尽可能快地
+// 把接收方向的原始数据重新送入解码流程（串口拆帧 / CAN 分片重组 / 界面）。
+// 文件通过 QFile::map 映射，只有读到的页才会被载入，不会预先拷贝整个文件。
+// 发送方向的记录和已解码的臂数据不回放，由解码流程重新生成。
+class SessionReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionReplayer(QObject *parent = nullptr);
+    ~SessionReplayer();
+
+    // 映射并校验文件；失败时发出 errorOccurred 并返回 false
+    bool open(const QString &fileName);
+    void close();
+
+    // speed: 1.0 = 原速，N = N 倍速，<= 0 = 尽可能快
+    void start(double speed);
+    void stop();
+    bool isActive() const { return m_timer->isActive(); }
+
+    quint64 replayedRecords() const { return m_replayed; }
+    // 已回放到的位置（文件字节偏移）和文件大小
+    qint64 position() const { return m_offset; }
+    qint64 size() const { return m_size; }
+
+signals:
+    // timestampUs 为回放时重新映射到当前时钟的采集时间
+    // data 直接引用映射内存，只在槽函数执行期间有效
+    void serialBytes(const QByteArray &data, qint64 timestampUs);
+    void canFrame(const CANDataFrame &frame);
+    void finished();
+    void errorOccurred(const QString &error);
+
+private slots:
+    void onTick();
+
+private:
+    // 尽可能快模式下每次最多占用事件循环的时间，保证界面仍可响应
+    static constexpr qint64 AFAP_SLICE_NS = 5000000;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    qint64 m_firstRecordOffset = 0;
+    qint64 m_offset = 0;
+    qint64 m_firstTimestampUs = 0;
+
+    double m_speed = 1.0;
+    qint64 m_startNowUs = 0;
+    QElapsedTimer m_clock;
+    QTimer *m_timer;
+    quint64 m_replayed = 0;
+
+    void dispatch(quint8 type, quint8 flags, quint16 id, const uchar *payload, quint32 size, qint64 timestampUs);
+};
+
+#endif // SESSIONREPLAYER_H
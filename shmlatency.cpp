@@ -0,0 +1,127 @@
+// 共享内存臂状态延迟测试
+// 用法:
+//   Linker_TA_shm_latency [--name /linker_ta_arm_state] [--seconds 10]
+//       读取正在运行的采集程序发布的状态，统计 发布->读到 与 采集->读到 的延迟
+//   Linker_TA_shm_latency --self [--rate 1000] [--seconds 10]
+//       进程内起一个发布线程（不需要硬件），测量 seqlock 本身的延迟和读冲突次数
+#include "armstateshm.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void printPercentiles(const char *label, std::vector<int64_t> &values)
+{
+    if (values.empty()) {
+        std::printf("%s: no samples\n", label);
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    const auto at = [&](double p) {
+        const size_t idx = std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5));
+        return static_cast<long long>(values[idx]);
+    };
+    std::printf("%s (us): n=%zu min=%lld p50=%lld p99=%lld p99.9=%lld max=%lld\n",
+                label, values.size(), static_cast<long long>(values.front()),
+                at(0.50), at(0.99), at(0.999), static_cast<long long>(values.back()));
+}
+
+int main(int argc, char *argv[])
+{
+    std::string name = ArmStateShm::DEFAULT_NAME;
+    bool self = false;
+    int rateHz = 1000;
+    double seconds = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--name" && i + 1 < argc) {
+            name = argv[++i];
+        } else if (arg == "--self") {
+            self = true;
+        } else if (arg == "--rate" && i + 1 < argc) {
+            rateHz = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--name NAME] [--seconds S] [--self [--rate HZ]]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // 自测模式：使用独立的段名，避免与正在运行的采集程序冲突
+    ArmStateShm::Publisher publisher;
+    std::atomic<bool> running{true};
+    std::thread writer;
+    if (self) {
+        name += "_selftest";
+        if (!publisher.open(name.c_str())) {
+            std::fprintf(stderr, "publisher: %s\n", publisher.errorString().c_str());
+            return 1;
+        }
+        writer = std::thread([&]() {
+            float joints[ArmStateShm::JOINT_COUNT] = {};
+            const int64_t periodUs = 1000000 / rateHz;
+            int64_t next = ArmStateShm::nowUs();
+            while (running.load(std::memory_order_relaxed)) {
+                next += periodUs;
+                // 离截止时间较远时先睡眠，最后 200us 忙等
+                const int64_t remaining = next - ArmStateShm::nowUs();
+                if (remaining > 200) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(remaining - 200));
+                }
+                while (ArmStateShm::nowUs() < next) {}
+                for (int j = 0; j < ArmStateShm::JOINT_COUNT; ++j) joints[j] += 0.01f;
+                publisher.publish(ArmStateShm::nowUs(), joints,
+                                  ArmStateShm::LeftArmValid | ArmStateShm::RightArmValid);
+            }
+        });
+    }
+
+    ArmStateShm::Reader reader;
+    if (!reader.open(name.c_str())) {
+        std::fprintf(stderr, "reader: %s\n", reader.errorString().c_str());
+        running = false;
+        if (writer.joinable()) writer.join();
+        return 1;
+    }
+
+    std::vector<int64_t> publishLatency;
+    std::vector<int64_t> sampleLatency;
+    publishLatency.reserve(static_cast<size_t>(seconds * 20000));
+    sampleLatency.reserve(publishLatency.capacity());
+
+    uint64_t lastSequence = 0;
+    uint64_t missed = 0;
+    uint64_t retries = 0;
+    const int64_t endUs = ArmStateShm::nowUs() + static_cast<int64_t>(seconds * 1e6);
+    ArmStateShm::State state;
+    while (ArmStateShm::nowUs() < endUs) {
+        if (reader.sequence() == lastSequence) continue;
+
+        while (!reader.tryRead(state)) {
+            ++retries;
+        }
+        const int64_t now = ArmStateShm::nowUs();
+        if (lastSequence != 0 && state.sequence > lastSequence + 1) {
+            missed += state.sequence - lastSequence - 1;
+        }
+        lastSequence = state.sequence;
+        publishLatency.push_back(now - state.publishUs);
+        sampleLatency.push_back(now - state.timestampUs);
+    }
+
+    running = false;
+    if (writer.joinable()) writer.join();
+
+    printPercentiles("publish -> read", publishLatency);
+    printPercentiles("sample  -> read", sampleLatency);
+    std::printf("missed updates: %llu, read retries: %llu\n",
+                static_cast<unsigned long long>(missed), static_cast<unsigned long long>(retries));
+    return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef SIMDVEC_H
+#define SIMDVEC_H
+
+#include <QtGlobal>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMDVEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// 4 通道浮点向量：SSE2 或标量实现，滤波和运动学的逐通道算法只写一遍。
+// load/store/loadMask 要求 16 字节对齐（标量实现不要求）。
+namespace SimdVec {
+
+#ifdef SIMDVEC_SSE2
+struct Vec {
+    __m128 v;
+};
+inline Vec load(const float *p) { return {_mm_load_ps(p)}; }
+inline Vec loadMask(const quint32 *p) { return {_mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i *>(p)))}; }
+inline void store(float *p, Vec a) { _mm_store_ps(p, a.v); }
+inline Vec splat(float x) { return {_mm_set1_ps(x)}; }
+inline Vec operator+(Vec a, Vec b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {_mm_div_ps(a.v, b.v)}; }
+inline Vec vmin(Vec a, Vec b) { return {_mm_min_ps(a.v, b.v)}; }
+inline Vec vmax(Vec a, Vec b) { return {_mm_max_ps(a.v, b.v)}; }
+inline Vec vabs(Vec a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+// mask 为全 1 的通道取 a，否则取 b
+inline Vec select(Vec mask, Vec a, Vec b) { return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))}; }
+#else
+struct Vec {
+    float v[4];
+};
+inline Vec load(const float *p) { Vec r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+inline Vec loadMask(const quint32 *p) { Vec r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+inline void store(float *p, Vec a) { std::memcpy(p, a.v, sizeof(a.v)); }
+inline Vec splat(float x) { return {{x, x, x, x}}; }
+#define SIMDVEC_BINARY(NAME, EXPR) \
+    inline Vec NAME(Vec a, Vec b) { Vec r; for (int i = 0; i < 4; ++i) { const float x = a.v[i], y = b.v[i]; r.v[i] = (EXPR); } return r; }
+SIMDVEC_BINARY(operator+, x + y)
+SIMDVEC_BINARY(operator-, x - y)
+SIMDVEC_BINARY(operator*, x * y)
+SIMDVEC_BINARY(operator/, x / y)
+SIMDVEC_BINARY(vmin, y < x ? y : x)
+SIMDVEC_BINARY(vmax, y > x ? y : x)
+#undef SIMDVEC_BINARY
+inline Vec vabs(Vec a) { for (float &x : a.v) x = x < 0.0f ? -x : x; return a; }
+inline Vec select(Vec mask, Vec a, Vec b)
+{
+    Vec r;
+    for (int i = 0; i < 4; ++i) {
+        quint32 m;
+        std::memcpy(&m, &mask.v[i], sizeof(m));
+        r.v[i] = m ? a.v[i] : b.v[i];
+    }
+    return r;
+}
+#endif
+
+} // namespace SimdVec
+
+#endif // SIMDVEC_H
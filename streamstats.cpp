@@ -0,0 +1,105 @@
+#include "streamstats.h"
+
+StreamStats::StreamStats(qint64 windowUs, double ewmaAlpha, double gapFactor)
+    : m_windowUs(qMax<qint64>(1000, windowUs))
+    , m_alpha(qBound(0.001, ewmaAlpha, 1.0))
+    , m_gapFactor(qMax(1.0, gapFactor))
+{
+}
+
+void StreamStats::reset(qint64 startUs)
+{
+    m_startUs = startUs;
+    m_lastUs = -1;
+    m_count = 0;
+    m_gapCount = 0;
+    m_ewmaIntervalUs = 0.0;
+    m_current = 0;
+    m_segmentStartUs = startUs;
+    clearSegment(0);
+    clearSegment(1);
+}
+
+void StreamStats::clearSegment(int segment)
+{
+    m_segmentCount[segment] = 0;
+    m_intervals[segment].reset();
+}
+
+void StreamStats::rotate(qint64 timestampUs)
+{
+    const qint64 elapsed = timestampUs - m_segmentStartUs;
+    if (elapsed < m_windowUs) return;
+
+    if (elapsed >= 2 * m_windowUs) {
+        // 中断超过两个窗口：旧数据全部作废
+        clearSegment(0);
+        clearSegment(1);
+        m_segmentStartUs = timestampUs;
+        return;
+    }
+
+    m_current ^= 1;
+    clearSegment(m_current);
+    m_segmentStartUs += m_windowUs;
+}
+
+void StreamStats::addSample(qint64 timestampUs)
+{
+    rotate(timestampUs);
+    ++m_segmentCount[m_current];
+    ++m_count;
+
+    if (m_lastUs >= 0) {
+        // 时间戳回退（时钟重新对齐）时按0间隔处理
+        const qint64 interval = qMax<qint64>(0, timestampUs - m_lastUs);
+
+        // 前几个间隔用来建立 EWMA 基线，之后才判定间隙
+        if (m_count > 8 && interval > m_gapFactor * m_ewmaIntervalUs) {
+            ++m_gapCount;
+        }
+        m_ewmaIntervalUs = (m_count == 2) ? interval
+                                          : m_alpha * interval + (1.0 - m_alpha) * m_ewmaIntervalUs;
+
+        m_intervals[m_current].add(interval);
+    }
+    m_lastUs = qMax(m_lastUs, timestampUs);
+}
+
+StreamStats::Snapshot StreamStats::snapshot(qint64 nowUs) const
+{
+    Snapshot s;
+    s.count = m_count;
+    s.gapCount = m_gapCount;
+
+    const qint64 total = nowUs - m_startUs;
+    if (total > 0) {
+        s.meanRateHz = m_count * 1e6 / total;
+    }
+
+    // 流中断时以“距上一个样本的时间”为间隔，频率随之下降
+    if (m_count >= 2) {
+        const double interval = qMax(m_ewmaIntervalUs, static_cast<double>(nowUs - m_lastUs));
+        s.ewmaRateHz = 1e6 / qMax(1.0, interval);
+    }
+
+    const int previous = m_current ^ 1;
+    const double frac = static_cast<double>(nowUs - m_segmentStartUs) / m_windowUs;
+    const double windowSeconds = m_windowUs / 1e6;
+    if (frac < 1.0) {
+        s.windowRateHz = (m_segmentCount[previous] * (1.0 - qMax(0.0, frac)) + m_segmentCount[m_current]) / windowSeconds;
+    } else if (frac < 2.0) {
+        // 当前段已结束但还没有新样本触发切换
+        s.windowRateHz = m_segmentCount[m_current] * (2.0 - frac) / windowSeconds;
+    }
+
+    // 合并两段直方图求分位数
+    LatencyHistogram intervals = m_intervals[0];
+    intervals.merge(m_intervals[1]);
+    if (intervals.count() > 0) {
+        s.p50IntervalUs = intervals.percentileUs(0.5);
+        s.p99IntervalUs = intervals.percentileUs(0.99);
+        s.maxIntervalUs = intervals.maxUs();
+    }
+    return s;
+}
@@ -0,0 +1,61 @@
+#ifndef STREAMSTATS_H
+#define STREAMSTATS_H
+
+#include <QtGlobal>
+#include "latencyhistogram.h"
+
+// 单路数据流的频率/抖动统计（每个样本 O(1) 更新）
+// - 指数加权频率（EWMA）：对到达间隔做指数平均，反映最近的瞬时频率
+// - 滑动窗口频率：当前窗口与上一窗口按时间比例加权
+// - 到达间隔分布：对数分桶直方图（LatencyHistogram），给出 p50/p99/最大值，覆盖最近 1~2 个窗口
+// - 间隙计数：到达间隔超过 EWMA 间隔若干倍时记为一次间隙（丢帧/卡顿）
+// 所有时间均为 AcqClock 微秒。
+class StreamStats
+{
+public:
+    struct Snapshot {
+        quint64 count = 0;          // 自 reset 以来的样本数
+        double meanRateHz = 0.0;    // 自 reset 以来的平均频率
+        double ewmaRateHz = 0.0;
+        double windowRateHz = 0.0;
+        qint64 p50IntervalUs = 0;
+        qint64 p99IntervalUs = 0;
+        qint64 maxIntervalUs = 0;
+        quint64 gapCount = 0;
+    };
+
+    explicit StreamStats(qint64 windowUs = 1000000, double ewmaAlpha = 0.1, double gapFactor = 3.0);
+
+    // 清空统计，startUs 作为平均频率的起点
+    void reset(qint64 startUs);
+
+    // 记录一个样本（发送或接收时刻）
+    void addSample(qint64 timestampUs);
+
+    // 计算当前统计值；nowUs 用于滑动窗口衰减（流中断时频率会逐渐降到0）
+    Snapshot snapshot(qint64 nowUs) const;
+
+    quint64 count() const { return m_count; }
+
+private:
+    void rotate(qint64 timestampUs);
+    void clearSegment(int segment);
+
+    qint64 m_windowUs;
+    double m_alpha;
+    double m_gapFactor;
+
+    qint64 m_startUs = 0;
+    qint64 m_lastUs = -1;
+    quint64 m_count = 0;
+    quint64 m_gapCount = 0;
+    double m_ewmaIntervalUs = 0.0;
+
+    // 两个窗口段：m_current 为当前段，另一个为上一段
+    int m_current = 0;
+    qint64 m_segmentStartUs = 0;
+    quint32 m_segmentCount[2] = {};
+    LatencyHistogram m_intervals[2];
+};
+
+#endif // STREAMSTATS_H
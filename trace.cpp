@@ -0,0 +1,250 @@
+#include "trace.h"
+#include "acqclock.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+
+static_assert((BUFFER_RECORDS & (BUFFER_RECORDS - 1)) == 0, "BUFFER_RECORDS 必须是 2 的幂");
+
+const char *const EVENT_NAMES[EventCount] = {
+    "SerialRead",
+    "FrameExtract",
+    "ArmDecode",
+    "ArmProcess",
+    "CanRead",
+    "CanReassembly",
+    "ArmFilter",
+    "ArmFusion",
+    "ForwardKinematics",
+    "DisplayFrame",
+    "TableRender",
+    "ChartRender",
+    "RecorderWrite",
+    "ArchiveEncode",
+    "StreamSend",
+    "TrajectoryTick",
+};
+
+struct Record {
+    qint64 startUs;
+    qint64 durationUs;   // < 0 为瞬时事件
+    qint64 arg;
+    quint16 event;
+    quint16 reserved[3];
+};
+static_assert(sizeof(Record) == 32, "Record 应为 32 字节");
+
+struct ThreadBuffer {
+    std::unique_ptr<Record[]> records{new Record[BUFFER_RECORDS]};
+    std::atomic<quint64> head{0};        // 只由所属线程写
+    std::atomic<quint64> clearedAt{0};   // clear() 时的 head，导出时忽略之前的记录
+    std::atomic<bool> retired{false};    // 所属线程已退出
+    quint32 tid = 0;
+    char name[32] = {};
+};
+
+// 注册表：只在线程首次写入、命名、导出和清除时加锁
+std::mutex s_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+quint32 s_nextTid = 1;
+
+struct ThreadHandle {
+    ThreadBuffer *buffer = nullptr;
+    bool exhausted = false;              // 缓冲区已用完，本线程不再尝试注册
+    char name[32] = {};                  // 线程名（注册缓冲区时写入）
+    ~ThreadHandle()
+    {
+        if (buffer) buffer->retired.store(true, std::memory_order_release);
+    }
+};
+thread_local ThreadHandle t_handle;
+
+ThreadBuffer *currentBuffer()
+{
+    if (t_handle.buffer || t_handle.exhausted) return t_handle.buffer;
+
+    std::lock_guard<std::mutex> locker(s_registryMutex);
+    ThreadBuffer *buffer = nullptr;
+    if (static_cast<int>(s_buffers.size()) < MAX_THREADS) {
+        s_buffers.emplace_back(new ThreadBuffer);
+        buffer = s_buffers.back().get();
+    } else {
+        // 复用已退出线程的缓冲区（其记录随之丢弃）
+        for (const std::unique_ptr<ThreadBuffer> &candidate : s_buffers) {
+            if (candidate->retired.load(std::memory_order_acquire)) {
+                buffer = candidate.get();
+                buffer->head.store(0, std::memory_order_relaxed);
+                buffer->clearedAt.store(0, std::memory_order_relaxed);
+                buffer->retired.store(false, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+    if (!buffer) {
+        t_handle.exhausted = true;
+        return nullptr;
+    }
+    buffer->tid = s_nextTid++;
+    std::memcpy(buffer->name, t_handle.name, sizeof(buffer->name));
+    t_handle.buffer = buffer;
+    return buffer;
+}
+
+void appendJsonString(QByteArray &out, const char *text)
+{
+    out.append('"');
+    for (const char *p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') out.append('\\');
+        if (static_cast<unsigned char>(*p) >= 0x20) out.append(*p);
+    }
+    out.append('"');
+}
+
+} // namespace
+
+const char *eventName(Event event)
+{
+    return event < EventCount ? EVENT_NAMES[event] : "Unknown";
+}
+
+void setEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void setThreadName(const char *name)
+{
+    // 只记下名字，缓冲区在第一次写入时才分配
+    std::strncpy(t_handle.name, name, sizeof(t_handle.name) - 1);
+    if (t_handle.buffer) {
+        std::lock_guard<std::mutex> locker(s_registryMutex);
+        std::memcpy(t_handle.buffer->name, t_handle.name, sizeof(t_handle.name));
+    }
+}
+
+void record(Event event, qint64 startUs, qint64 durationUs, qint64 arg)
+{
+    ThreadBuffer *buffer = currentBuffer();
+    if (!buffer) return;
+
+    const quint64 head = buffer->head.load(std::memory_order_relaxed);
+    Record &r = buffer->records[head & (BUFFER_RECORDS - 1)];
+    r.startUs = startUs;
+    r.durationUs = durationUs;
+    r.arg = arg;
+    r.event = event;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void instant(Event event, qint64 arg)
+{
+    record(event, AcqClock::nowUs(), -1, arg);
+}
+
+qint64 Scope::nowUs()
+{
+    return AcqClock::nowUs();
+}
+
+void clear()
+{
+    std::lock_guard<std::mutex> locker(s_registryMutex);
+    for (auto it = s_buffers.begin(); it != s_buffers.end();) {
+        ThreadBuffer *buffer = it->get();
+        if (buffer->retired.load(std::memory_order_acquire)) {
+            it = s_buffers.erase(it);
+        } else {
+            buffer->clearedAt.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+            ++it;
+        }
+    }
+}
+
+bool writeChromeTrace(const QString &fileName, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = QString("无法写入追踪文件: %1").arg(file.errorString());
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(1 << 20);
+    out.append("{\"traceEvents\":[");
+    bool first = true;
+    const auto beginEvent = [&out, &first]() {
+        if (!first) out.append(",\n");
+        first = false;
+    };
+
+    std::vector<Record> snapshot;
+    std::lock_guard<std::mutex> locker(s_registryMutex);
+    for (const std::unique_ptr<ThreadBuffer> &buffer : s_buffers) {
+        const QByteArray tid = QByteArray::number(buffer->tid);
+
+        // 线程名
+        beginEvent();
+        out.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":").append(pid)
+           .append(",\"tid\":").append(tid).append(",\"args\":{\"name\":");
+        if (buffer->name[0]) {
+            appendJsonString(out, buffer->name);
+        } else {
+            out.append("\"thread ").append(tid).append('"');
+        }
+        out.append("}}");
+
+        // 先拷贝再校验：拷贝期间被覆盖的记录丢弃
+        const quint64 head = buffer->head.load(std::memory_order_acquire);
+        const quint64 cleared = buffer->clearedAt.load(std::memory_order_relaxed);
+        quint64 begin = head > static_cast<quint64>(BUFFER_RECORDS) ? head - BUFFER_RECORDS : 0;
+        begin = qMax(begin, cleared);
+        snapshot.clear();
+        for (quint64 i = begin; i < head; ++i) {
+            snapshot.push_back(buffer->records[i & (BUFFER_RECORDS - 1)]);
+        }
+        const quint64 headAfter = buffer->head.load(std::memory_order_acquire);
+        // 写入端先写槽位 headAfter 再发布 head + 1：该槽位（与记录 headAfter - BUFFER_RECORDS 同一个）可能正在被写
+        const quint64 overwritten = headAfter >= static_cast<quint64>(BUFFER_RECORDS) ? headAfter + 1 - BUFFER_RECORDS : 0;
+        const size_t skip = overwritten > begin ? static_cast<size_t>(qMin<quint64>(overwritten - begin, snapshot.size())) : 0;
+
+        for (size_t i = skip; i < snapshot.size(); ++i) {
+            const Record &r = snapshot[i];
+            beginEvent();
+            out.append("{\"name\":");
+            appendJsonString(out, eventName(static_cast<Event>(r.event)));
+            out.append(",\"cat\":\"linker\",\"pid\":").append(pid).append(",\"tid\":").append(tid)
+               .append(",\"ts\":").append(QByteArray::number(r.startUs));
+            if (r.durationUs >= 0) {
+                out.append(",\"ph\":\"X\",\"dur\":").append(QByteArray::number(r.durationUs));
+            } else {
+                out.append(",\"ph\":\"i\",\"s\":\"t\"");
+            }
+            out.append(",\"args\":{\"arg\":").append(QByteArray::number(r.arg)).append("}}");
+
+            if (out.size() >= (1 << 20)) {
+                file.write(out);
+                out.clear();
+            }
+        }
+    }
+    out.append("]}\n");
+    file.write(out);
+
+    if (!file.flush() || file.error() != QFileDevice::NoError) {
+        if (error) *error = QString("写入追踪文件失败: %1").arg(file.errorString());
+        return false;
+    }
+    return true;
+}
+
+} // namespace Trace
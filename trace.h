@@ -0,0 +1,113 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <atomic>
+
+// ===== 追踪开关 =====
+// 编译期开关：为 0 时所有追踪宏展开为空
+#ifndef TRACE_COMPILED
+#define TRACE_COMPILED 1
+#endif
+
+// 性能追踪：记录各环节（拆帧、解码、重组、显示……）的开始时间、耗时和一个整数参数。
+// 每个线程写自己的环形缓冲区（单写者，无锁），满了覆盖最旧的记录；只有线程第一次写入时注册缓冲区需要加锁。
+// 运行时开关关闭时每个追踪点只有一次原子读。
+// 导出为 Chrome / Perfetto 可读的 JSON（chrome://tracing 或 ui.perfetto.dev 打开）。
+namespace Trace {
+
+// 追踪点；新增时同步修改 trace.cpp 中的名称表
+enum Event : quint16 {
+    SerialRead = 0,     // 串口读到一批数据（参数：字节数）
+    FrameExtract,       // 拆帧（参数：拆出的帧数）
+    ArmDecode,          // 臂数据解码（参数：字节数）
+    ArmProcess,         // 一帧臂数据从解码到各消费者（参数：臂 ID）
+    CanRead,            // CAN 工作线程读到一帧（参数：CAN ID）
+    CanReassembly,      // CAN 分片重组（参数：CAN ID）
+    ArmFilter,          // 关节角滤波
+    ArmFusion,          // 双臂配对（参数：臂 ID）
+    ForwardKinematics,  // 正运动学（参数：臂 ID）
+    DisplayFrame,       // 一个显示帧（参数：脏标记）
+    TableRender,        // 表格刷新
+    ChartRender,        // 曲线刷新
+    RecorderWrite,      // 录制线程写盘（参数：字节数）
+    ArchiveEncode,      // 归档编码一块（参数：样本数）
+    StreamSend,         // 数据推送发送（参数：数据报数）
+    TrajectoryTick,     // 轨迹下发的一个周期（参数：迟到微秒数）
+    EventCount
+};
+
+const char *eventName(Event event);
+
+// 每个线程的缓冲区记录数（每条 32 字节）
+constexpr int BUFFER_RECORDS = 32768;
+// 最多同时保留的线程缓冲区
+constexpr int MAX_THREADS = 64;
+
+// 运行时开关
+extern std::atomic<bool> g_enabled;
+inline bool isEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool enabled);
+
+// 给当前线程命名（导出时显示，不分配缓冲区）；未命名的线程显示为 "thread N"
+void setThreadName(const char *name);
+
+// 写一条记录；durationUs < 0 表示瞬时事件
+void record(Event event, qint64 startUs, qint64 durationUs, qint64 arg);
+void instant(Event event, qint64 arg = 0);
+
+// 丢弃所有已记录的数据（已退出线程的缓冲区一并释放）
+void clear();
+
+// 导出为 Chrome trace JSON；失败时返回 false，原因写入 error
+bool writeChromeTrace(const QString &fileName, QString *error = nullptr);
+
+// 作用域追踪：构造时记下开始时间，析构时写一条带耗时的记录
+class Scope
+{
+public:
+    explicit Scope(Event event, qint64 arg = 0)
+        : m_event(event), m_arg(arg), m_startUs(isEnabled() ? nowUs() : -1) {}
+    ~Scope()
+    {
+        if (m_startUs >= 0) record(m_event, m_startUs, nowUs() - m_startUs, m_arg);
+    }
+    // 参数在作用域结束时才知道（如拆出的帧数）
+    void setArg(qint64 arg) { m_arg = arg; }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    static qint64 nowUs();
+
+    Event m_event;
+    qint64 m_arg;
+    qint64 m_startUs;
+};
+
+} // namespace Trace
+
+// ===== 追踪宏 =====
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_COMPILED
+#define TRACE_SCOPE(event) Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(Trace::event)
+#define TRACE_SCOPE_ARG(event, arg) Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(Trace::event, (arg))
+// 命名的作用域，可用 name.setArg() 在结束前补充参数
+#define TRACE_SCOPE_NAMED(name, event) Trace::Scope name(Trace::event)
+#define TRACE_SET_ARG(name, arg) name.setArg(arg)
+#define TRACE_INSTANT(event, arg) do { if (Trace::isEnabled()) Trace::instant(Trace::event, (arg)); } while (0)
+#define TRACE_THREAD_NAME(name) Trace::setThreadName(name)
+#else
+#define TRACE_SCOPE(event)
+#define TRACE_SCOPE_ARG(event, arg)
+#define TRACE_SCOPE_NAMED(name, event)
+#define TRACE_SET_ARG(name, arg)
+#define TRACE_INSTANT(event, arg) do { } while (0)
+#define TRACE_THREAD_NAME(name)
+#endif
+
+#endif // TRACE_H
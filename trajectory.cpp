@@ -0,0 +1,204 @@
+#include "trajectory.h"
+#include "sessionformat.h"
+#include <QFile>
+#include <cmath>
+#include <cstring>
+
+Trajectory::Trajectory(const QVector<quint8> &jointIds)
+    : m_jointIds(jointIds)
+{
+}
+
+bool Trajectory::addWaypoint(qint64 timeUs, const float *positions)
+{
+    if (!m_times.isEmpty() && timeUs <= m_times.last()) {
+        return false;
+    }
+
+    const int joints = jointCount();
+    m_times.append(timeUs);
+    for (int j = 0; j < joints; ++j) {
+        m_positions.append(positions[j]);
+        m_tangents.append(0.0f);
+    }
+
+    // 新路点只影响自身和前一个路点的切线
+    const int last = m_times.size() - 1;
+    if (last > 0) {
+        updateTangent(last - 1);
+    }
+    updateTangent(last);
+    return true;
+}
+
+void Trajectory::updateTangent(int index)
+{
+    const int joints = jointCount();
+    const int count = m_times.size();
+    if (count < 2) return;
+
+    // 端点用单侧差分，中间点用中心差分
+    const int prev = qMax(0, index - 1);
+    const int next = qMin(count - 1, index + 1);
+    const double dt = static_cast<double>(m_times[next] - m_times[prev]);
+    for (int j = 0; j < joints; ++j) {
+        const float dp = m_positions[next * joints + j] - m_positions[prev * joints + j];
+        m_tangents[index * joints + j] = static_cast<float>(dp / dt);
+    }
+}
+
+void Trajectory::sample(qint64 tUs, float *out, int &cursor) const
+{
+    const int joints = jointCount();
+    const int count = m_times.size();
+    if (count == 0) return;
+
+    if (tUs <= m_times.first() || count == 1) {
+        std::memcpy(out, m_positions.constData(), joints * sizeof(float));
+        cursor = 0;
+        return;
+    }
+    if (tUs >= m_times.last()) {
+        std::memcpy(out, m_positions.constData() + (count - 1) * joints, joints * sizeof(float));
+        cursor = count - 2;
+        return;
+    }
+
+    // 从上次的路段向后查找；时间回退（循环播放）时从头开始
+    if (cursor < 0 || cursor >= count - 1 || tUs < m_times[cursor]) {
+        cursor = 0;
+    }
+    while (tUs >= m_times[cursor + 1]) {
+        ++cursor;
+    }
+
+    const qint64 t0 = m_times[cursor];
+    const double h = static_cast<double>(m_times[cursor + 1] - t0);
+    const double s = (tUs - t0) / h;
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+    const float h00 = static_cast<float>(2 * s3 - 3 * s2 + 1);
+    const float h10 = static_cast<float>((s3 - 2 * s2 + s) * h);
+    const float h01 = static_cast<float>(-2 * s3 + 3 * s2);
+    const float h11 = static_cast<float>((s3 - s2) * h);
+
+    const float *p0 = m_positions.constData() + cursor * joints;
+    const float *p1 = p0 + joints;
+    const float *m0 = m_tangents.constData() + cursor * joints;
+    const float *m1 = m0 + joints;
+    for (int j = 0; j < joints; ++j) {
+        out[j] = h00 * p0[j] + h10 * m0[j] + h01 * p1[j] + h11 * m1[j];
+    }
+}
+
+Trajectory Trajectory::ramp(const QVector<quint8> &jointIds, const QVector<float> &from,
+                            const QVector<float> &to, qint64 durationUs)
+{
+    Trajectory trajectory(jointIds);
+    trajectory.addWaypoint(0, from.constData());
+    trajectory.addWaypoint(qMax<qint64>(1, durationUs), to.constData());
+    return trajectory;
+}
+
+Trajectory Trajectory::sinusoid(const QVector<quint8> &jointIds, const QVector<float> &center,
+                                const QVector<float> &amplitude, double frequencyHz, qint64 durationUs)
+{
+    constexpr int POINTS_PER_PERIOD = 64;
+    constexpr double PI = 3.14159265358979323846;
+
+    Trajectory trajectory(jointIds);
+    if (frequencyHz <= 0.0 || durationUs <= 0) return trajectory;
+
+    const int joints = jointIds.size();
+    const double periodUs = 1e6 / frequencyHz;
+    const int points = qMax(2, static_cast<int>(std::ceil(durationUs / periodUs * POINTS_PER_PERIOD)) + 1);
+    QVector<float> positions(joints);
+    for (int i = 0; i < points; ++i) {
+        const qint64 t = durationUs * i / (points - 1);
+        const double phase = 2.0 * PI * frequencyHz * t / 1e6;
+        for (int j = 0; j < joints; ++j) {
+            positions[j] = center[j] + amplitude[j] * static_cast<float>(std::sin(phase));
+        }
+        trajectory.addWaypoint(t, positions.constData());
+    }
+    return trajectory;
+}
+
+bool Trajectory::fromSession(const QString &fileName, Trajectory &out, QString *error, qint64 minIntervalUs)
+{
+    const auto fail = [error](const QString &message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QString("无法打开录制文件: %1").arg(file.errorString()));
+    }
+    const qint64 size = file.size();
+    const uchar *data = file.map(0, size);
+    if (!data || size < static_cast<qint64>(sizeof(SessionFormat::FileHeader))) {
+        return fail("录制文件格式错误: 文件过短或无法映射");
+    }
+
+    SessionFormat::FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, SessionFormat::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version < SessionFormat::MIN_READ_VERSION || header.version > SessionFormat::VERSION ||
+        static_cast<qint64>(header.headerSize) > size) {
+        return fail("录制文件格式错误: 文件头无效或版本不支持");
+    }
+
+    QVector<quint8> ids(14);
+    for (int i = 0; i < 14; ++i) ids[i] = static_cast<quint8>(i);
+    Trajectory trajectory(ids);
+
+    float joints[14] = {};
+    quint32 seen = 0; // bit0 左臂, bit1 右臂
+    qint64 firstUs = -1;
+    qint64 lastAddedUs = 0;
+    qint64 offset = header.headerSize;
+    while (offset + static_cast<qint64>(sizeof(SessionFormat::RecordHeader)) <= size) {
+        SessionFormat::RecordHeader record;
+        std::memcpy(&record, data + offset, sizeof(record));
+        // size 来自文件：先确认 payload 在文件内，再计算补齐后的长度（截断或损坏的文件在此结束）
+        if (record.size > size - offset - static_cast<qint64>(sizeof(record))) break;
+        const qint64 recordBytes = static_cast<qint64>(SessionFormat::recordSize(record.size));
+        if (offset + recordBytes > size) break;
+        const uchar *payload = data + offset + sizeof(record);
+        offset += recordBytes;
+
+        if (record.type != SessionFormat::ArmSample) continue;
+        const int count = static_cast<int>(record.size / sizeof(float));
+        if (record.id == SessionFormat::BothArms && count >= 14) {
+            std::memcpy(joints, payload, 14 * sizeof(float));
+            seen = 0x03;
+        } else if (record.id == SessionFormat::LeftArm && count >= 7) {
+            std::memcpy(joints, payload, 7 * sizeof(float));
+            seen |= 0x01;
+        } else if (record.id == SessionFormat::RightArm && count >= 7) {
+            std::memcpy(joints + 7, payload, 7 * sizeof(float));
+            seen |= 0x02;
+        } else {
+            continue;
+        }
+        // 左右臂都出现过之后才开始生成路点，避免另一半从 0 开始
+        if (seen != 0x03) continue;
+
+        if (firstUs < 0) {
+            firstUs = record.timestampUs;
+            trajectory.addWaypoint(0, joints);
+            continue;
+        }
+        const qint64 t = record.timestampUs - firstUs;
+        if (t - lastAddedUs >= minIntervalUs && trajectory.addWaypoint(t, joints)) {
+            lastAddedUs = t;
+        }
+    }
+
+    if (trajectory.waypointCount() < 2) {
+        return fail("录制文件中没有足够的臂数据");
+    }
+    out = trajectory;
+    return true;
+}
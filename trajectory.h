@@ -0,0 +1,50 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <QVector>
+#include <QString>
+#include <QtGlobal>
+
+// 多关节位置轨迹：一组按时间排序的路点，每个路点给出所有关节的位置。
+// 路点之间用三次 Hermite 插值（切线取相邻路点的差分），速度在路点处连续；只有两个路点时退化为线性。
+// 时间为相对轨迹起点的微秒。
+class Trajectory
+{
+public:
+    Trajectory() = default;
+    explicit Trajectory(const QVector<quint8> &jointIds);
+
+    // 追加路点；timeUs 必须大于上一个路点，positions 按 jointIds 顺序
+    bool addWaypoint(qint64 timeUs, const float *positions);
+
+    const QVector<quint8> &jointIds() const { return m_jointIds; }
+    int jointCount() const { return m_jointIds.size(); }
+    int waypointCount() const { return m_times.size(); }
+    bool isEmpty() const { return m_times.isEmpty(); }
+    qint64 durationUs() const { return m_times.isEmpty() ? 0 : m_times.last(); }
+
+    // 计算 tUs 时刻所有关节的位置（超出范围时取端点）
+    // cursor 为上次所在的路段，按时间顺序调用时查找为 O(1)；首次调用传 0
+    void sample(qint64 tUs, float *out, int &cursor) const;
+
+    // 从 from 线性过渡到 to
+    static Trajectory ramp(const QVector<quint8> &jointIds, const QVector<float> &from,
+                           const QVector<float> &to, qint64 durationUs);
+    // center + amplitude * sin(2π f t)，每周期 64 个路点
+    static Trajectory sinusoid(const QVector<quint8> &jointIds, const QVector<float> &center,
+                               const QVector<float> &amplitude, double frequencyHz, qint64 durationUs);
+    // 从录制文件（sessionformat.h）中的臂数据记录生成 14 关节轨迹；单臂记录只更新对应的 7 个关节
+    // minIntervalUs 用于抽稀路点（默认 1ms）
+    static bool fromSession(const QString &fileName, Trajectory &out, QString *error = nullptr,
+                            qint64 minIntervalUs = 1000);
+
+private:
+    QVector<quint8> m_jointIds;
+    QVector<qint64> m_times;
+    QVector<float> m_positions;  // 路点 x 关节，按行存放
+    QVector<float> m_tangents;   // 每个路点处的切线（单位/微秒），添加路点时更新
+
+    void updateTangent(int index);
+};
+
+#endif // TRAJECTORY_H
@@ -0,0 +1,190 @@
+#include "trajectorystreamer.h"
+#include "acqclock.h"
+#include "trace.h"
+#include <QMutexLocker>
+#include <chrono>
+#include <thread>
+
+TrajectoryStreamer::TrajectoryStreamer(QObject *parent)
+    : QThread(parent)
+{
+}
+
+TrajectoryStreamer::~TrajectoryStreamer()
+{
+    stop();
+}
+
+bool TrajectoryStreamer::startTrajectory(const Trajectory &trajectory, const Options &options)
+{
+    if (isRunning()) {
+        stop();
+    }
+    if (trajectory.isEmpty() || trajectory.jointCount() == 0) {
+        emit errorOccurred("轨迹为空");
+        return false;
+    }
+    if (options.rateHz <= 0.0) {
+        emit errorOccurred("轨迹下发频率无效");
+        return false;
+    }
+
+    m_trajectory = trajectory;
+    m_options = options;
+    m_multiJointFrames.store(options.multiJointFrames, std::memory_order_relaxed);
+
+    // 按一帧的字节数计算链路容量，超出时降低频率
+    QVector<float> positions(trajectory.jointCount());
+    int cursor = 0;
+    trajectory.sample(0, positions.data(), cursor);
+    const int frameBytes = buildFrame(positions.constData()).size();
+    double capacityHz = 0.0;
+    if (options.linkBaudRate > 0) {
+        capacityHz = static_cast<double>(options.linkBaudRate) / BITS_PER_BYTE / frameBytes;
+        if (m_options.rateHz > capacityHz) {
+            emit errorOccurred(QString("轨迹下发频率 %1Hz 超过链路容量 %2Hz，已降低")
+                                   .arg(m_options.rateHz, 0, 'f', 1).arg(capacityHz, 0, 'f', 1));
+            m_options.rateHz = capacityHz;
+        }
+    }
+    m_periodUs = qMax<qint64>(1, qRound64(1e6 / m_options.rateHz));
+
+    {
+        QMutexLocker locker(&m_statsMutex);
+        m_stats = Stats();
+        m_stats.targetRateHz = 1e6 / m_periodUs;
+        m_stats.frameBytes = frameBytes;
+        m_stats.linkCapacityHz = capacityHz;
+        m_stats.linkUtilization = capacityHz > 0.0 ? m_stats.targetRateHz / capacityHz : 0.0;
+        m_intervalStats.reset(AcqClock::nowUs());
+        m_lateness.reset();
+        m_writeLateness.reset();
+    }
+
+    m_outstanding.store(0, std::memory_order_relaxed);
+    m_stopping.store(false);
+    start(QThread::TimeCriticalPriority);
+    return true;
+}
+
+void TrajectoryStreamer::stop()
+{
+    if (!isRunning()) return;
+    m_stopping.store(true);
+    wait();
+}
+
+TrajectoryStreamer::Stats TrajectoryStreamer::stats() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    Stats stats = m_stats;
+    stats.actualRateHz = m_intervalStats.snapshot(AcqClock::nowUs()).windowRateHz;
+
+    stats.p50LatenessUs = m_lateness.percentileUs(0.5);
+    stats.p99LatenessUs = m_lateness.percentileUs(0.99);
+    stats.maxLatenessUs = m_lateness.maxUs();
+    stats.p50WriteLatenessUs = m_writeLateness.percentileUs(0.5);
+    stats.p99WriteLatenessUs = m_writeLateness.percentileUs(0.99);
+    stats.maxWriteLatenessUs = m_writeLateness.maxUs();
+    return stats;
+}
+
+void TrajectoryStreamer::frameWritten(qint64 deadlineUs, qint64 nowUs)
+{
+    QMutexLocker locker(&m_statsMutex);
+    m_writeLateness.add(nowUs - deadlineUs);
+}
+
+bool TrajectoryStreamer::recordAck(bool ok)
+{
+    QMutexLocker locker(&m_statsMutex);
+    if (ok) {
+        ++m_stats.acksOk;
+        return false;
+    }
+    return ++m_stats.acksFailed == 1;
+}
+
+QByteArray TrajectoryStreamer::buildFrame(const float *positions) const
+{
+    const QVector<quint8> &ids = m_trajectory.jointIds();
+    QVector<SerialProtocol::JointSetpoint> setpoints(ids.size());
+    for (int i = 0; i < ids.size(); ++i) {
+        setpoints[i].id = ids[i];
+        setpoints[i].position = positions[i];
+        setpoints[i].speed = m_options.speed;
+        setpoints[i].acceleration = m_options.acceleration;
+        setpoints[i].torque = m_options.torque;
+    }
+    return m_multiJointFrames.load(std::memory_order_relaxed) ? SerialProtocol::buildMultiTorqueControlCommand(setpoints)
+                                                              : SerialProtocol::buildTorqueControlCommands(setpoints);
+}
+
+void TrajectoryStreamer::waitUntil(qint64 deadlineUs) const
+{
+    // 睡眠到截止前 SPIN_US（分段，以便及时响应停止），最后忙等
+    while (!m_stopping.load(std::memory_order_relaxed)) {
+        const qint64 remainingUs = deadlineUs - SPIN_US - AcqClock::nowUs();
+        if (remainingUs <= 0) break;
+        std::this_thread::sleep_for(std::chrono::microseconds(qMin(remainingUs, MAX_SLEEP_US)));
+    }
+    while (AcqClock::nowUs() < deadlineUs && !m_stopping.load(std::memory_order_relaxed)) {
+    }
+}
+
+void TrajectoryStreamer::recordTick(qint64 deadlineUs, qint64 nowUs, quint64 missed, bool skipped)
+{
+    const qint64 latenessUs = qMax<qint64>(0, nowUs - deadlineUs);
+
+    QMutexLocker locker(&m_statsMutex);
+    m_stats.missedDeadlines += missed;
+    if (skipped) {
+        ++m_stats.skippedFrames;
+    } else {
+        ++m_stats.frames;
+        m_intervalStats.addSample(nowUs);
+    }
+    m_lateness.add(latenessUs);
+}
+
+void TrajectoryStreamer::run()
+{
+    TRACE_THREAD_NAME("trajectory");
+    const qint64 durationUs = m_trajectory.durationUs();
+    QVector<float> positions(m_trajectory.jointCount());
+    int cursor = 0;
+
+    const qint64 startUs = AcqClock::nowUs() + m_periodUs;
+    quint64 tick = 0;
+    while (!m_stopping.load(std::memory_order_relaxed)) {
+        qint64 deadlineUs = startUs + static_cast<qint64>(tick) * m_periodUs;
+        waitUntil(deadlineUs);
+        if (m_stopping.load(std::memory_order_relaxed)) break;
+
+        // 唤醒晚于一个周期：跳到当前所在的周期，不补发错过的帧
+        const qint64 nowUs = AcqClock::nowUs();
+        TRACE_SCOPE_ARG(TrajectoryTick, nowUs - deadlineUs);
+        quint64 missed = 0;
+        if (nowUs - deadlineUs >= m_periodUs) {
+            missed = static_cast<quint64>((nowUs - deadlineUs) / m_periodUs);
+            tick += missed;
+            deadlineUs += static_cast<qint64>(missed) * m_periodUs;
+        }
+
+        qint64 t = static_cast<qint64>(tick) * m_periodUs;
+        if (t > durationUs) {
+            if (!m_options.loop || durationUs <= 0) break;
+            t %= durationUs;
+        }
+        m_trajectory.sample(t, positions.data(), cursor);
+
+        // 写出端积压时跳过本帧，避免帧在事件队列中堆积、整体延后
+        const bool skipped = m_outstanding.load(std::memory_order_relaxed) >= MAX_OUTSTANDING;
+        if (!skipped) {
+            m_outstanding.fetch_add(1, std::memory_order_relaxed);
+            emit frameReady(buildFrame(positions.constData()), deadlineUs);
+        }
+        recordTick(deadlineUs, nowUs, missed, skipped);
+        ++tick;
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef TRAJECTORYSTREAMER_H
+#define TRAJECTORYSTREAMER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QByteArray>
+#include <atomic>
+#include "trajectory.h"
+#include "serialprotocol.h"
+#include "streamstats.h"
+#include "latencyhistogram.h"
+
+// 轨迹下发：独立的定时线程按固定频率对轨迹插值，生成扭矩控制帧。
+// 第 n 帧的截止时间为 起点 + n * 周期（绝对时间，误差不累积）；线程先睡眠到截止前 SPIN_US，再忙等到截止时刻。
+// 唤醒晚于一个周期时跳过错过的帧并计数，不补发。
+// 帧通过 frameReady（排队连接）交给串口所在的界面线程写出，绝对截止时间只保证到入队为止：
+// 界面线程的停顿会变成输出抖动，写出端调用 frameWritten() 记录实际写出时刻相对截止时间的延迟。
+// 未写出的帧超过 MAX_OUTSTANDING 时跳过本帧（链路或界面线程跟不上）。
+class TrajectoryStreamer : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        double rateHz = 200.0;
+        float speed = 0.0f;           // 每个设定值使用相同的速度/加速度/扭矩
+        float acceleration = 0.0f;
+        float torque = 0.0f;
+        bool multiJointFrames = true; // 多关节帧（0x31），否则逐关节单帧（0x30）
+        bool loop = false;            // 播放结束后从头循环
+        qint32 linkBaudRate = 0;      // 串口波特率，用于计算链路容量；0 表示不限制
+    };
+
+    struct Stats {
+        quint64 frames = 0;           // 已交出的帧
+        quint64 missedDeadlines = 0;  // 唤醒太晚而跳过的周期
+        quint64 skippedFrames = 0;    // 写出端积压而跳过的帧
+        double targetRateHz = 0.0;
+        double actualRateHz = 0.0;
+        qint64 p50LatenessUs = 0;     // 唤醒时刻相对截止时间
+        qint64 p99LatenessUs = 0;
+        qint64 maxLatenessUs = 0;
+        qint64 p50WriteLatenessUs = 0; // 实际写出时刻相对截止时间
+        qint64 p99WriteLatenessUs = 0;
+        qint64 maxWriteLatenessUs = 0;
+        quint64 acksOk = 0;           // 下位机对下发帧的应答
+        quint64 acksFailed = 0;
+        int frameBytes = 0;
+        double linkCapacityHz = 0.0;  // 按 8N1 计算的最大帧率
+        double linkUtilization = 0.0; // 目标帧率占链路容量的比例
+    };
+
+    explicit TrajectoryStreamer(QObject *parent = nullptr);
+    ~TrajectoryStreamer();
+
+    // 开始下发；频率超过链路容量时降到容量以内。失败时发出 errorOccurred 并返回 false
+    bool startTrajectory(const Trajectory &trajectory, const Options &options);
+    void stop();
+    bool isStreaming() const { return isRunning(); }
+
+    // 写出端每写完（或丢弃）一帧调用一次
+    void frameConsumed() { m_outstanding.fetch_sub(1, std::memory_order_relaxed); }
+    // 写出端在 write() 时调用，deadlineUs 为 frameReady 带出的截止时间
+    void frameWritten(qint64 deadlineUs, qint64 nowUs);
+    // 记录一条下位机应答；返回 true 表示这是本次下发的第一条失败应答
+    bool recordAck(bool ok);
+    // 下发中途切换帧格式（下位机不支持多关节命令时改为逐关节单帧），从下一帧起生效
+    void setMultiJointFrames(bool enabled) { m_multiJointFrames.store(enabled, std::memory_order_relaxed); }
+
+    Stats stats() const;
+
+signals:
+    // deadlineUs 为该帧的计划发送时刻（AcqClock 微秒）
+    void frameReady(const QByteArray &frame, qint64 deadlineUs);
+    void errorOccurred(const QString &error);
+
+protected:
+    void run() override;
+
+private:
+    static constexpr qint64 SPIN_US = 200;
+    static constexpr qint64 MAX_SLEEP_US = 50000; // 分段睡眠，停止请求最多等待 50ms
+    static constexpr int MAX_OUTSTANDING = 4;
+    static constexpr int BITS_PER_BYTE = 10;      // 起始位 + 8 数据位 + 停止位
+
+    Trajectory m_trajectory;
+    Options m_options;
+    qint64 m_periodUs = 0;
+    std::atomic<bool> m_stopping{false};
+    std::atomic<int> m_outstanding{0};
+    std::atomic<bool> m_multiJointFrames{true};
+
+    mutable QMutex m_statsMutex;
+    Stats m_stats;
+    StreamStats m_intervalStats;
+    LatencyHistogram m_lateness;
+    LatencyHistogram m_writeLateness;
+
+    QByteArray buildFrame(const float *positions) const;
+    void waitUntil(qint64 deadlineUs) const;
+    void recordTick(qint64 deadlineUs, qint64 nowUs, quint64 missed, bool skipped);
+};
+
+#endif // TRAJECTORYSTREAMER_H